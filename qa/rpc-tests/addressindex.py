@@ -169,6 +169,9 @@ class AddressIndexTest(BitcoinTestFramework):
 
         balance2 = self.nodes[1].getaddressbalance(address2)
         assert_equal(balance2["balance"], change_amount)
+        assert_equal(balance2["received"], amount + change_amount)
+        assert_equal(balance2["txcount"], balance1["txcount"] + 1)
+        assert_equal(balance2["lastheight"], self.nodes[1].getblockcount())
 
         # Check that deltas are returned correctly
         deltas = self.nodes[1].getaddressdeltas({"addresses": [address2], "start": 0, "end": 200})
@@ -183,6 +186,18 @@ class AddressIndexTest(BitcoinTestFramework):
         deltasAll = self.nodes[1].getaddressdeltas({"addresses": [address2]})
         assert_equal(len(deltasAll), len(deltas))
 
+        # Check that paging through the deltas returns all of them
+        paged = []
+        page = self.nodes[1].getaddressdeltas({"addresses": [address2], "limit": 1})
+        paged += page["deltas"]
+        while page["cursor"] is not None:
+            page = self.nodes[1].getaddressdeltas({"addresses": [address2], "limit": 1, "cursor": page["cursor"]})
+            paged += page["deltas"]
+        assert_equal(paged, deltasAll)
+        page = self.nodes[1].getaddresstxids({"addresses": [address2], "limit": 100})
+        assert_equal(page["txids"], self.nodes[1].getaddresstxids({"addresses": [address2]}))
+        assert_equal(page["cursor"], None)
+
         # Check that deltas can be returned from range of block heights
         deltas = self.nodes[1].getaddressdeltas({"addresses": [address2], "start": 113, "end": 113})
         assert_equal(len(deltas), 1)
@@ -82,5 +82,13 @@ class NodeHandlingTest (BitcoinTestFramework):
                 found = True
         assert(found)
 
+        ###################################
+        # RPC getmessagehandlerinfo test  #
+        ###################################
+        info = self.nodes[0].getmessagehandlerinfo()
+        assert_equal(len(info['workers']), 2) # default -msgworkers
+        assert(info['handlers']['version']['processed'] > 0)
+        assert_equal(info['handlers']['version']['queued'], 0)
+
 if __name__ == '__main__':
     NodeHandlingTest ().main ()
@@ -300,6 +300,10 @@ class WalletTest (BitcoinTestFramework):
                            {"address": address_to_import},
                            {"spendable": True})
 
+        # 7. The rescan has finished, so there is nothing to abort
+        assert_equal(self.nodes[1].getwalletinfo()["scanning"], False)
+        assert_equal(self.nodes[1].abortrescan(), False)
+
         #check if wallet or blochchain maintenance changes the balance
         self.sync_all()
         blocks = self.nodes[0].generate(2)
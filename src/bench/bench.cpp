@@ -4,9 +4,17 @@
 
 #include "bench.h"
 
+#include "clientversion.h"
+#include "utiltime.h"
+
+#include <algorithm>
 #include <iostream>
+#include <math.h>
+#include <regex>
 #include <sys/time.h>
 
+#include <univalue.h>
+
 using namespace benchmark;
 
 std::map<std::string, BenchFunction> BenchRunner::benchmarks;
@@ -23,16 +31,36 @@ BenchRunner::BenchRunner(std::string name, BenchFunction func)
 }
 
 void
-BenchRunner::RunAll(double elapsedTimeForOne)
+BenchRunner::RunAll(Printer& printer, double elapsedTimeForOne, const std::string& filter)
 {
-    std::cout << "Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << "\n";
+    std::regex reFilter(filter);
+
+    printer.Header();
 
     for (std::map<std::string,BenchFunction>::iterator it = benchmarks.begin();
          it != benchmarks.end(); ++it) {
 
+        if (!std::regex_match(it->first, reFilter))
+            continue;
+
         State state(it->first, elapsedTimeForOne);
         BenchFunction& func = it->second;
         func(state);
+        printer.Print(state.GetResult());
+    }
+
+    printer.Footer();
+}
+
+void
+BenchRunner::List(const std::string& filter)
+{
+    std::regex reFilter(filter);
+
+    for (std::map<std::string,BenchFunction>::iterator it = benchmarks.begin();
+         it != benchmarks.end(); ++it) {
+        if (std::regex_match(it->first, reFilter))
+            std::cout << it->first << "\n";
     }
 }
 
@@ -53,6 +81,7 @@ bool State::KeepRunning()
         double elapsedOne = (now - lastTime)/timeCheckCount;
         if (elapsedOne < minTime) minTime = elapsedOne;
         if (elapsedOne > maxTime) maxTime = elapsedOne;
+        samples.push_back(elapsedOne);
         if (elapsedOne*timeCheckCount < maxElapsed/16) timeCheckCount *= 2;
     }
     lastTime = now;
@@ -62,9 +91,77 @@ bool State::KeepRunning()
 
     --count;
 
-    // Output results
-    double average = (now-beginTime)/count;
-    std::cout << name << "," << count << "," << minTime << "," << maxTime << "," << average << "\n";
-
     return false;
 }
+
+Result State::GetResult() const
+{
+    Result result;
+    result.name = name;
+    result.count = count;
+    result.total = count > 0 ? lastTime - beginTime : 0;
+    result.average = count > 0 ? result.total / count : 0;
+    result.min = samples.empty() ? result.average : minTime;
+    result.max = samples.empty() ? result.average : maxTime;
+
+    if (samples.empty()) {
+        result.median = result.average;
+        result.stddev = 0;
+        return result;
+    }
+
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    size_t mid = sorted.size() / 2;
+    result.median = sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+
+    double mean = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+        mean += samples[i];
+    mean /= samples.size();
+    double variance = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+        variance += (samples[i] - mean) * (samples[i] - mean);
+    result.stddev = sqrt(variance / samples.size());
+
+    return result;
+}
+
+void ConsolePrinter::Header()
+{
+    std::cout << "Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << "," << "median" << "," << "stddev" << "\n";
+}
+
+void ConsolePrinter::Print(const Result& result)
+{
+    std::cout << result.name << "," << result.count << "," << result.min << "," << result.max << "," << result.average << "," << result.median << "," << result.stddev << "\n";
+}
+
+void JSONPrinter::Print(const Result& result)
+{
+    results.push_back(result);
+}
+
+void JSONPrinter::Footer()
+{
+    UniValue benchmarks(UniValue::VARR);
+    for (size_t i = 0; i < results.size(); i++) {
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("name", results[i].name));
+        obj.push_back(Pair("count", results[i].count));
+        obj.push_back(Pair("total", results[i].total));
+        obj.push_back(Pair("min", results[i].min));
+        obj.push_back(Pair("max", results[i].max));
+        obj.push_back(Pair("average", results[i].average));
+        obj.push_back(Pair("median", results[i].median));
+        obj.push_back(Pair("stddev", results[i].stddev));
+        benchmarks.push_back(obj);
+    }
+
+    UniValue doc(UniValue::VOBJ);
+    doc.push_back(Pair("version", FormatFullVersion()));
+    doc.push_back(Pair("time", GetTime()));
+    doc.push_back(Pair("elapsed_per_benchmark", elapsedTimeForOne));
+    doc.push_back(Pair("benchmarks", benchmarks));
+    std::cout << doc.write(4) << "\n";
+}
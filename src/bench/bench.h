@@ -5,8 +5,10 @@
 #ifndef BITCOIN_BENCH_BENCH_H
 #define BITCOIN_BENCH_BENCH_H
 
+#include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/preprocessor/cat.hpp>
@@ -33,9 +35,21 @@ static void CODE_TO_TIME(benchmark::State& state)
 BENCHMARK(CODE_TO_TIME);
 
  */
- 
+
 namespace benchmark {
 
+    /**
+     * Statistics of one benchmark, in seconds per iteration. The clock is
+     * only read every so often for fast benchmarks, so min, max, median and
+     * stddev are taken over samples that each average a run of iterations.
+     */
+    struct Result {
+        std::string name;
+        int64_t count;
+        double total;
+        double min, max, average, median, stddev;
+    };
+
     class State {
         std::string name;
         double maxElapsed;
@@ -43,6 +57,7 @@ namespace benchmark {
         double lastTime, minTime, maxTime;
         int64_t count;
         int64_t timeCheckCount;
+        std::vector<double> samples;
     public:
         State(std::string _name, double _maxElapsed) : name(_name), maxElapsed(_maxElapsed), count(0) {
             minTime = std::numeric_limits<double>::max();
@@ -50,10 +65,43 @@ namespace benchmark {
             timeCheckCount = 1;
         }
         bool KeepRunning();
+        /** Statistics of the finished run, count is 0 if KeepRunning() was never called */
+        Result GetResult() const;
     };
 
     typedef boost::function<void(State&)> BenchFunction;
 
+    /** Output format of BenchRunner::RunAll */
+    class Printer
+    {
+    public:
+        virtual ~Printer() {}
+        virtual void Header() = 0;
+        virtual void Print(const Result& result) = 0;
+        virtual void Footer() = 0;
+    };
+
+    /** One comma separated line per benchmark */
+    class ConsolePrinter : public Printer
+    {
+    public:
+        void Header();
+        void Print(const Result& result);
+        void Footer() {}
+    };
+
+    /** A JSON document with the client version, so results can be compared across releases */
+    class JSONPrinter : public Printer
+    {
+        std::vector<Result> results;
+        double elapsedTimeForOne;
+    public:
+        JSONPrinter(double _elapsedTimeForOne) : elapsedTimeForOne(_elapsedTimeForOne) {}
+        void Header() {}
+        void Print(const Result& result);
+        void Footer();
+    };
+
     class BenchRunner
     {
         static std::map<std::string, BenchFunction> benchmarks;
@@ -61,7 +109,10 @@ namespace benchmark {
     public:
         BenchRunner(std::string name, BenchFunction func);
 
-        static void RunAll(double elapsedTimeForOne=1.0);
+        /** Run the benchmarks whose name matches the regular expression filter */
+        static void RunAll(Printer& printer, double elapsedTimeForOne=1.0, const std::string& filter=".*");
+        /** Print the names of the benchmarks matching filter */
+        static void List(const std::string& filter=".*");
     };
 }
 
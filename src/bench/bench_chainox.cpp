@@ -4,18 +4,76 @@
 
 #include "bench.h"
 
+#include "crypto/phichox.h"
 #include "key.h"
+#include "pubkey.h"
 #include "validation.h"
 #include "util.h"
+#include "utilstrencodings.h"
+
+#include <iostream>
+#include <regex>
+
+static const char* DEFAULT_BENCH_FILTER = ".*";
+static const char* DEFAULT_BENCH_PRINTER = "console";
+static const char* DEFAULT_BENCH_TIME = "1";
+
+static std::string HelpMessage()
+{
+    std::string strUsage = HelpMessageGroup("Options:");
+    strUsage += HelpMessageOpt("-?", "Print this help message and exit");
+    strUsage += HelpMessageOpt("-list", "List the benchmarks matching -filter without running them");
+    strUsage += HelpMessageOpt("-filter=<regex>", strprintf("Regular expression the benchmark names to run must match (default: %s)", DEFAULT_BENCH_FILTER));
+    strUsage += HelpMessageOpt("-printer=<console|json>", strprintf("Print results as comma separated lines or as a JSON document (default: %s)", DEFAULT_BENCH_PRINTER));
+    strUsage += HelpMessageOpt("-time=<n>", strprintf("Seconds to run every benchmark for (default: %s)", DEFAULT_BENCH_TIME));
+    return strUsage;
+}
 
 int
 main(int argc, char** argv)
 {
+    ParseParameters(argc, argv);
+
+    if (mapArgs.count("-?") || mapArgs.count("-h") || mapArgs.count("-help")) {
+        std::cout << "Usage: bench_chainox [options]\n\n" << HelpMessage();
+        return 0;
+    }
+
+    std::string filter = GetArg("-filter", DEFAULT_BENCH_FILTER);
+    std::string printerName = GetArg("-printer", DEFAULT_BENCH_PRINTER);
+    double elapsedTimeForOne = atof(GetArg("-time", DEFAULT_BENCH_TIME).c_str());
+    if (printerName != "console" && printerName != "json") {
+        std::cerr << "Error: unknown printer '" << printerName << "'\n";
+        return 1;
+    }
+    try {
+        std::regex reFilter(filter);
+    } catch (const std::regex_error& e) {
+        std::cerr << "Error: invalid -filter '" << filter << "': " << e.what() << "\n";
+        return 1;
+    }
+    if (elapsedTimeForOne <= 0) {
+        std::cerr << "Error: -time must be positive\n";
+        return 1;
+    }
+
+    if (mapArgs.count("-list")) {
+        benchmark::BenchRunner::List(filter);
+        return 0;
+    }
+
+    PhiCHOXAutoDetect();
     ECC_Start();
+    ECCVerifyHandle globalVerifyHandle;
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
 
-    benchmark::BenchRunner::RunAll();
+    benchmark::ConsolePrinter consolePrinter;
+    benchmark::JSONPrinter jsonPrinter(elapsedTimeForOne);
+    if (printerName == "json")
+        benchmark::BenchRunner::RunAll(jsonPrinter, elapsedTimeForOne, filter);
+    else
+        benchmark::BenchRunner::RunAll(consolePrinter, elapsedTimeForOne, filter);
 
     ECC_Stop();
 }
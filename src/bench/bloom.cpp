@@ -0,0 +1,87 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "bloom.h"
+#include "hash.h"
+#include "utilstrencodings.h"
+#include "primitives/transaction.h"
+
+// Addresses watched by the light client loading the filter
+static const int BENCH_BLOOM_ELEMENTS = 100;
+// Transactions in the filtered block
+static const int BENCH_BLOOM_TXS = 200;
+
+static std::vector<unsigned char> BenchKeyHash(uint32_t n)
+{
+    uint256 hash = Hash(BEGIN(n), END(n));
+    return std::vector<unsigned char>(hash.begin(), hash.begin() + 20);
+}
+
+static CBloomFilter BenchBloomFilter()
+{
+    CBloomFilter filter(BENCH_BLOOM_ELEMENTS, 0.0001, 0, BLOOM_UPDATE_P2PUBKEY_ONLY);
+    for (uint32_t i = 0; i < BENCH_BLOOM_ELEMENTS; i++)
+        filter.insert(BenchKeyHash(i));
+    return filter;
+}
+
+// P2PKH transactions, one in ten of them paying to a watched address
+static std::vector<CTransaction> BenchBloomTransactions()
+{
+    std::vector<CTransaction> vtx;
+    for (uint32_t i = 0; i < BENCH_BLOOM_TXS; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(Hash(BEGIN(i), END(i)), 0);
+        tx.vin[0].scriptSig = CScript() << std::vector<unsigned char>(72, 0x30) << std::vector<unsigned char>(33, 0x02);
+        tx.vout.resize(2);
+        for (uint32_t j = 0; j < tx.vout.size(); j++) {
+            uint32_t n = i % 10 == 0 && j == 0 ? i % BENCH_BLOOM_ELEMENTS : BENCH_BLOOM_ELEMENTS + i * 2 + j;
+            tx.vout[j].nValue = 1000;
+            tx.vout[j].scriptPubKey = CScript() << OP_DUP << OP_HASH160 << BenchKeyHash(n) << OP_EQUALVERIFY << OP_CHECKSIG;
+        }
+        vtx.push_back(tx);
+    }
+    return vtx;
+}
+
+static void BloomFilterInsert(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        BenchBloomFilter();
+    }
+}
+
+static void BloomFilterContains(benchmark::State& state)
+{
+    CBloomFilter filter = BenchBloomFilter();
+    // half of the keys are in the filter
+    std::vector<std::vector<unsigned char> > vKeys;
+    for (uint32_t i = 0; i < 2 * BENCH_BLOOM_ELEMENTS; i++)
+        vKeys.push_back(BenchKeyHash(i));
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        filter.contains(vKeys[i]);
+        i = (i + 1) % vKeys.size();
+    }
+}
+
+// Matching a block against the filter of one peer, as done for every
+// filtered block or transaction it is sent
+static void BloomFilterMatchBlock(benchmark::State& state)
+{
+    std::vector<CTransaction> vtx = BenchBloomTransactions();
+    CBloomFilter filterBase = BenchBloomFilter();
+    while (state.KeepRunning()) {
+        CBloomFilter filter(filterBase);
+        for (const CTransaction& tx : vtx)
+            filter.IsRelevantAndUpdate(tx);
+    }
+}
+
+BENCHMARK(BloomFilterInsert);
+BENCHMARK(BloomFilterContains);
+BENCHMARK(BloomFilterMatchBlock);
@@ -0,0 +1,136 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chain_setup.h"
+
+#include "chainparams.h"
+#include "consensus/consensus.h"
+#include "keystore.h"
+#include "miner.h"
+#include "pow.h"
+#include "random.h"
+#include "script/sign.h"
+#include "script/standard.h"
+#include "txdb.h"
+#include "txmempool.h"
+#include "util.h"
+#include "validation.h"
+
+/**
+ * Regtest retargets with DarkGravityWave from the first block, so a chain
+ * mined on the real clock quickly gets too hard to extend here. Blocks are
+ * dated this many seconds apart starting at the genesis block instead, which
+ * keeps the difficulty close to the minimum and, being that far back, before
+ * PHICHOX_START_TIME, so the nonce search only needs SHA256d.
+ */
+static const int64_t BENCH_BLOCK_SPACING = 138;
+
+BenchChainSetup::BenchChainSetup(int nBlocks)
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    const CChainParams& chainparams = Params();
+
+    ClearDatadirCache();
+    pathTemp = GetTempPath() / strprintf("bench_chainox_%lu_%i", (unsigned long)GetTime(), (int)(GetRand(100000)));
+    boost::filesystem::create_directories(pathTemp);
+    mapArgs["-datadir"] = pathTemp.string();
+    pblocktree = new CBlockTreeDB(1 << 20, true);
+    pcoinsdbview = new CCoinsViewDB(1 << 23, true);
+    pcoinsTip = new CCoinsViewCache(pcoinsdbview);
+    InitBlockIndex(chainparams);
+
+    nScriptCheckThreads = 3;
+    for (int i = 0; i < nScriptCheckThreads - 1; i++)
+        threadGroup.create_thread(&ThreadScriptCheck);
+
+    coinbaseKey.MakeNewKey(true);
+    scriptPubKey = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+    for (int i = 0; i < nBlocks; i++) {
+        CBlock block = CreateAndProcessBlock(std::vector<CMutableTransaction>());
+        coinbaseTxns.push_back(*block.vtx[0]);
+    }
+}
+
+BenchChainSetup::~BenchChainSetup()
+{
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+    nScriptCheckThreads = 0;
+    mempool.clear();
+    UnloadBlockIndex();
+    delete pcoinsTip;
+    delete pcoinsdbview;
+    delete pblocktree;
+    pcoinsTip = NULL;
+    pblocktree = NULL;
+    boost::filesystem::remove_all(pathTemp);
+    mapArgs.erase("-datadir");
+    ClearDatadirCache();
+    SetMockTime(0);
+}
+
+CBlock BenchChainSetup::CreateBlock(const std::vector<CMutableTransaction>& txns)
+{
+    const CChainParams& chainparams = Params();
+    SetMockTime(chainActive.Tip()->GetBlockTime() + BENCH_BLOCK_SPACING);
+    std::unique_ptr<CBlockTemplate> pblocktemplate(CreateNewBlock(chainparams, scriptPubKey));
+    CBlock& block = pblocktemplate->block;
+
+    // Replace mempool-selected txns with just coinbase plus passed-in txns:
+    block.vtx.resize(1);
+    for (const CMutableTransaction& tx : txns)
+        block.vtx.push_back(MakeTransactionRef(tx));
+    // IncrementExtraNonce creates a valid coinbase and merkleRoot
+    unsigned int extraNonce = 0;
+    IncrementExtraNonce(&block, chainActive.Tip(), extraNonce);
+
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, chainparams.GetConsensus())) ++block.nNonce;
+
+    return block;
+}
+
+CBlock BenchChainSetup::CreateAndProcessBlock(const std::vector<CMutableTransaction>& txns)
+{
+    CBlock block = CreateBlock(txns);
+    ProcessNewBlock(Params(), &block, true, NULL, NULL);
+    return block;
+}
+
+CTransaction BenchChainSetup::CreateFanOut(size_t nCoinbase, int nOutputs)
+{
+    CBasicKeyStore keystore;
+    keystore.AddKey(coinbaseKey);
+
+    const CTransaction& txFrom = coinbaseTxns[nCoinbase];
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(txFrom.GetHash(), 0);
+    tx.vout.resize(nOutputs);
+    for (int i = 0; i < nOutputs; i++) {
+        tx.vout[i].nValue = txFrom.vout[0].nValue / nOutputs;
+        tx.vout[i].scriptPubKey = scriptPubKey;
+    }
+    SignSignature(keystore, txFrom, tx, 0);
+
+    CreateAndProcessBlock(std::vector<CMutableTransaction>(1, tx));
+    return tx;
+}
+
+std::vector<CMutableTransaction> BenchChainSetup::CreateSpends(const CTransaction& txFrom)
+{
+    CBasicKeyStore keystore;
+    keystore.AddKey(coinbaseKey);
+
+    std::vector<CMutableTransaction> vtx(txFrom.vout.size());
+    for (size_t i = 0; i < txFrom.vout.size(); i++) {
+        CMutableTransaction& tx = vtx[i];
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(txFrom.GetHash(), i);
+        tx.vout.resize(1);
+        tx.vout[0].nValue = txFrom.vout[i].nValue - 1000;
+        tx.vout[0].scriptPubKey = scriptPubKey;
+        SignSignature(keystore, txFrom, tx, 0);
+    }
+    return vtx;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BENCH_CHAIN_SETUP_H
+#define BITCOIN_BENCH_CHAIN_SETUP_H
+
+#include "key.h"
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "script/script.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+
+class CCoinsViewDB;
+
+/**
+ * A REGTEST chain in a temporary data directory for the benchmarks that need
+ * validation state, in the spirit of TestChain100Setup. Only one may exist at
+ * a time since it installs pblocktree, pcoinsTip and chainActive, and the
+ * clock stays mocked to the time of the last block until it is destroyed.
+ */
+struct BenchChainSetup {
+    CCoinsViewDB* pcoinsdbview;
+    boost::filesystem::path pathTemp;
+    boost::thread_group threadGroup;
+
+    CKey coinbaseKey;
+    CScript scriptPubKey; // P2PKH to coinbaseKey, paid by coinbases and fan-outs
+    std::vector<CTransaction> coinbaseTxns;
+
+    /** Mine nBlocks blocks, so nBlocks - COINBASE_MATURITY coinbases can be spent */
+    BenchChainSetup(int nBlocks);
+    ~BenchChainSetup();
+
+    /** Create a block on the tip with the given transactions after the coinbase */
+    CBlock CreateBlock(const std::vector<CMutableTransaction>& txns);
+
+    /** Create a block with the given transactions after the coinbase and connect it */
+    CBlock CreateAndProcessBlock(const std::vector<CMutableTransaction>& txns);
+
+    /** Mine a transaction splitting the nCoinbase-th coinbase into nOutputs outputs */
+    CTransaction CreateFanOut(size_t nCoinbase, int nOutputs);
+
+    /** Signed one-in one-out transactions spending every output of txFrom */
+    std::vector<CMutableTransaction> CreateSpends(const CTransaction& txFrom);
+};
+
+#endif // BITCOIN_BENCH_CHAIN_SETUP_H
@@ -0,0 +1,50 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chain_setup.h"
+
+#include "chainparams.h"
+#include "consensus/consensus.h"
+#include "consensus/validation.h"
+#include "validation.h"
+
+// Number of signed P2PKH spends in the synthetic block
+static const int BENCH_BLOCK_TXS = 200;
+
+// Context-free checks of a block of BENCH_BLOCK_TXS transactions: proof of
+// work, merkle root, per-transaction CheckTransaction and sigop counting.
+static void CheckBlockSynthetic(benchmark::State& state)
+{
+    BenchChainSetup setup(COINBASE_MATURITY + 1);
+    CTransaction txFanOut = setup.CreateFanOut(0, BENCH_BLOCK_TXS);
+    CBlock block = setup.CreateBlock(setup.CreateSpends(txFanOut));
+
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        block.fChecked = false;
+        assert(CheckBlock(block, validationState));
+    }
+}
+
+// Everything TestBlockValidity does on top of the tip: contextual checks and
+// ConnectBlock against a fresh view, including script verification on the
+// script check threads. The signature cache is warm after the first round,
+// as it is for a block whose transactions were already seen in the mempool.
+static void ConnectBlockSynthetic(benchmark::State& state)
+{
+    BenchChainSetup setup(COINBASE_MATURITY + 1);
+    CTransaction txFanOut = setup.CreateFanOut(0, BENCH_BLOCK_TXS);
+    CBlock block = setup.CreateBlock(setup.CreateSpends(txFanOut));
+
+    LOCK(cs_main);
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        block.fChecked = false;
+        assert(TestBlockValidity(validationState, Params(), block, chainActive.Tip()));
+    }
+}
+
+BENCHMARK(CheckBlockSynthetic);
+BENCHMARK(ConnectBlockSynthetic);
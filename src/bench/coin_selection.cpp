@@ -0,0 +1,106 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "wallet/wallet.h"
+
+#include <set>
+
+// Spendable outputs in the benchmarked wallet
+static const int BENCH_WALLET_COINS = 100000;
+
+static CWallet wallet;
+
+// Mature outputs of distinct values, all multiples of 10000 duffs, so that
+// a target that isn't such a multiple has no selection without change
+static std::vector<COutput> BenchWalletCoins()
+{
+    std::vector<COutput> vCoins;
+    vCoins.reserve(BENCH_WALLET_COINS);
+    for (int i = 0; i < BENCH_WALLET_COINS; i++) {
+        CMutableTransaction tx;
+        tx.nLockTime = i; // so all transactions get different hashes
+        tx.vout.resize(1);
+        tx.vout[0].nValue = (i + 1) * 10000;
+        vCoins.push_back(COutput(new CWalletTx(&wallet, tx), 0, 6 * 24, true, true));
+    }
+    return vCoins;
+}
+
+static void FreeBenchWalletCoins(std::vector<COutput>& vCoins)
+{
+    for (const COutput& output : vCoins)
+        delete output.tx;
+    vCoins.clear();
+}
+
+// Building the value-sorted candidate index that SelectCoins reuses across
+// confirmation levels
+static void CoinSelectionCandidates(benchmark::State& state)
+{
+    std::vector<COutput> vCoins = BenchWalletCoins();
+    std::vector<CInputCoin> vCandidates;
+
+    while (state.KeepRunning()) {
+        CWallet::BuildCoinCandidates(vCoins, vCandidates);
+        assert(vCandidates.size() == vCoins.size());
+    }
+    FreeBenchWalletCoins(vCoins);
+}
+
+// A target above the largest coin that two coins add up to exactly, found by
+// the branch and bound search
+static void CoinSelectionExact(benchmark::State& state)
+{
+    std::vector<COutput> vCoins = BenchWalletCoins();
+    std::vector<CInputCoin> vCandidates;
+    CWallet::BuildCoinCandidates(vCoins, vCandidates);
+    std::set<std::pair<const CWalletTx*, unsigned int> > setCoinsRet;
+    CAmount nValueRet;
+
+    while (state.KeepRunning()) {
+        bool fSelected = wallet.SelectCoinsMinConf(17 * COIN, 1, 6, vCandidates, setCoinsRet, nValueRet);
+        assert(fSelected);
+        assert(nValueRet == 17 * COIN);
+    }
+    FreeBenchWalletCoins(vCoins);
+}
+
+// A target without a changeless selection, which exhausts the branch and
+// bound budget and falls back to the stochastic approximation
+static void CoinSelectionApproximate(benchmark::State& state)
+{
+    std::vector<COutput> vCoins = BenchWalletCoins();
+    std::vector<CInputCoin> vCandidates;
+    CWallet::BuildCoinCandidates(vCoins, vCandidates);
+    std::set<std::pair<const CWalletTx*, unsigned int> > setCoinsRet;
+    CAmount nValueRet;
+
+    while (state.KeepRunning()) {
+        bool fSelected = wallet.SelectCoinsMinConf(17 * COIN + 5000, 1, 6, vCandidates, setCoinsRet, nValueRet);
+        assert(fSelected);
+    }
+    FreeBenchWalletCoins(vCoins);
+}
+
+// The approximate selection through the COutput overload, which builds the
+// candidates again on every call instead of reusing them
+static void CoinSelectionPerCallCandidates(benchmark::State& state)
+{
+    std::vector<COutput> vCoins = BenchWalletCoins();
+    std::set<std::pair<const CWalletTx*, unsigned int> > setCoinsRet;
+    CAmount nValueRet;
+
+    while (state.KeepRunning()) {
+        bool fSelected = wallet.SelectCoinsMinConf(17 * COIN + 5000, 1, 6, vCoins, setCoinsRet, nValueRet);
+        assert(fSelected);
+    }
+    FreeBenchWalletCoins(vCoins);
+}
+
+BENCHMARK(CoinSelectionCandidates);
+BENCHMARK(CoinSelectionExact);
+BENCHMARK(CoinSelectionApproximate);
+BENCHMARK(CoinSelectionPerCallCandidates);
@@ -0,0 +1,77 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "coins.h"
+#include "hash.h"
+#include "utilstrencodings.h"
+#include "script/standard.h"
+
+#include <vector>
+
+// Coins held by the base cache, roughly what a few hundred blocks touch
+static const int BENCH_CACHED_COINS = 20000;
+// Coins fetched or written by one iteration, about one block worth of inputs
+static const int BENCH_COINS_PER_ROUND = 200;
+
+static COutPoint BenchOutPoint(uint32_t n)
+{
+    return COutPoint(Hash(BEGIN(n), END(n)), n % 4);
+}
+
+static void FillBaseCache(CCoinsViewCache& cache)
+{
+    CScript scriptPubKey = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x42) << OP_EQUALVERIFY << OP_CHECKSIG;
+    for (uint32_t i = 0; i < BENCH_CACHED_COINS; i++)
+        cache.AddCoin(BenchOutPoint(i), Coin(CTxOut(i + 1, scriptPubKey), 1, false), false);
+}
+
+// Inputs of a block looked up through a per-block cache on top of the
+// chainstate cache, as ConnectBlock does
+static void CoinsCacheFetch(benchmark::State& state)
+{
+    CCoinsView viewDummy;
+    CCoinsViewCache base(&viewDummy);
+    FillBaseCache(base);
+
+    uint32_t n = 0;
+    while (state.KeepRunning()) {
+        CCoinsViewCache view(&base);
+        for (int i = 0; i < BENCH_COINS_PER_ROUND; i++) {
+            assert(!view.AccessCoin(BenchOutPoint(n)).IsSpent());
+            n = (n + 7919) % BENCH_CACHED_COINS;
+        }
+    }
+}
+
+// Creating a block worth of coins and spending them again, each through a
+// child cache flushed into the base cache
+static void CoinsCacheFlush(benchmark::State& state)
+{
+    CCoinsView viewDummy;
+    CCoinsViewCache base(&viewDummy);
+    FillBaseCache(base);
+
+    CScript scriptPubKey = CScript() << OP_TRUE;
+    uint32_t n = BENCH_CACHED_COINS;
+    while (state.KeepRunning()) {
+        {
+            CCoinsViewCache view(&base);
+            for (int i = 0; i < BENCH_COINS_PER_ROUND; i++)
+                view.AddCoin(BenchOutPoint(n + i), Coin(CTxOut(1, scriptPubKey), 2, false), false);
+            view.Flush();
+        }
+        {
+            CCoinsViewCache view(&base);
+            for (int i = 0; i < BENCH_COINS_PER_ROUND; i++)
+                view.SpendCoin(BenchOutPoint(n + i));
+            view.Flush();
+        }
+        n += BENCH_COINS_PER_ROUND;
+    }
+}
+
+BENCHMARK(CoinsCacheFetch);
+BENCHMARK(CoinsCacheFlush);
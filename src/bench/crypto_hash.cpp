@@ -0,0 +1,138 @@
+// Copyright (c) 2016 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "crypto/phichox.h"
+#include "miner.h"
+#include "primitives/block.h"
+#include "uint256.h"
+
+static CBlockHeader BenchHeader()
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = uint256S("00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+    header.hashMerkleRoot = uint256S("e0028eb9648db56b1ac77cf090b99048a8007e2bb64b68f092c03c7f56a662c7");
+    header.nTime = 1646118000;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = 0;
+    return header;
+}
+
+// Full phiCHOX computation, as done by the miner for every nonce
+static void BlockHeaderComputeHash(benchmark::State& state)
+{
+    CBlockHeader header = BenchHeader();
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        header.ComputeHash();
+    }
+}
+
+// Repeated GetHash() on an unchanged header, as done by the validation path
+// (ReadBlockFromDisk, CheckBlock, AcceptBlockHeader, ...)
+static void BlockHeaderGetHashCached(benchmark::State& state)
+{
+    CBlockHeader header = BenchHeader();
+    header.GetHash();
+    while (state.KeepRunning()) {
+        header.GetHash();
+    }
+}
+
+// Same work through the miner's nonce scanner, which reuses the blake512 midstate
+static void NonceScannerPhiCHOX(benchmark::State& state)
+{
+    CBlockHeader header = BenchHeader();
+    CNonceScanner scanner(header);
+    uint32_t nNonce = 0;
+    uint256 hash;
+    while (state.KeepRunning()) {
+        scanner.Scan(nNonce, 1, arith_uint256(), hash);
+    }
+}
+
+static std::vector<CBlockHeader> BenchHeaders()
+{
+    std::vector<CBlockHeader> headers(64, BenchHeader());
+    for (size_t i = 0; i < headers.size(); i++)
+        headers[i].nNonce = i;
+    return headers;
+}
+
+// A HEADERS message worth of phiCHOX headers, one at a time...
+static void PhiCHOXHeadersScalar(benchmark::State& state)
+{
+    std::vector<CBlockHeader> headers = BenchHeaders();
+    while (state.KeepRunning()) {
+        for (const CBlockHeader& header : headers)
+            header.ComputeHash();
+    }
+}
+
+// ...and through the multi-lane kernels picked by PhiCHOXAutoDetect()
+static void PhiCHOXHeadersBatch(benchmark::State& state)
+{
+    std::vector<CBlockHeader> headers = BenchHeaders();
+    while (state.KeepRunning()) {
+        // Touch every header so none of them still has a valid cached hash
+        for (CBlockHeader& header : headers)
+            header.nNonce += headers.size();
+        CBlockHeader::PrecomputeHashes(headers);
+    }
+}
+
+// One 80-byte header through each branch of the phiCHOX chain, picked by
+// nTime and the hashPrevBlock nibble exactly as CPhiCHOX does on validation
+static void PhiCHOXBranch(benchmark::State& state, uint32_t nTime, bool fCycleNibbles)
+{
+    CBlockHeader header = BenchHeader();
+    header.nTime = nTime;
+    unsigned char hash[CPhiCHOX::OUTPUT_SIZE];
+    unsigned char nNibble = 0;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        if (fCycleNibbles)
+            nNibble = (nNibble + 1) & 0x0f;
+        CPhiCHOX(header.nTime, nNibble).Write((const unsigned char*)&header.nVersion, 80).Finalize(hash);
+    }
+}
+
+static void PhiCHOXPhase1(benchmark::State& state)
+{
+    PhiCHOXBranch(state, 1644451200 - 1, false);
+}
+
+// All sixteen phase 2 chains in turn
+static void PhiCHOXPhase2(benchmark::State& state)
+{
+    PhiCHOXBranch(state, 1644451200, true);
+}
+
+static void PhiCHOXPhase3(benchmark::State& state)
+{
+    PhiCHOXBranch(state, 1646118000, false);
+}
+
+// Headers older than PHICHOX_START_TIME are hashed with double SHA256
+static void BlockHeaderComputeHashSHA256d(benchmark::State& state)
+{
+    CBlockHeader header = BenchHeader();
+    header.nTime = PHICHOX_START_TIME - 1;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        header.ComputeHash();
+    }
+}
+
+BENCHMARK(BlockHeaderComputeHash);
+BENCHMARK(BlockHeaderComputeHashSHA256d);
+BENCHMARK(PhiCHOXPhase1);
+BENCHMARK(PhiCHOXPhase2);
+BENCHMARK(PhiCHOXPhase3);
+BENCHMARK(NonceScannerPhiCHOX);
+BENCHMARK(BlockHeaderGetHashCached);
+BENCHMARK(PhiCHOXHeadersScalar);
+BENCHMARK(PhiCHOXHeadersBatch);
@@ -0,0 +1,110 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chainparams.h"
+#include "governance.h"
+#include "governance-object.h"
+#include "governance-vote.h"
+#include "masternodeman.h"
+#include "net.h"
+#include "util.h"
+#include "utilstrencodings.h"
+
+// Votes, each by a different masternode, processed by one iteration
+static const int BENCH_GOVERNANCE_VOTES = 200;
+
+/**
+ * A watchdog object known to the governance manager and signed votes on it.
+ * Watchdogs are used because they only need a masternode signature, while
+ * proposals need a confirmed collateral transaction.
+ */
+struct GovernanceBenchSetup {
+    CConnman connman;
+    uint256 nHashWatchdog;
+    std::vector<CGovernanceVote> vecVotes;
+    int64_t nMockTime;
+
+    GovernanceBenchSetup() : nMockTime(GetTime())
+    {
+        SelectParams(CBaseChainParams::REGTEST);
+        SetMockTime(nMockTime);
+
+        std::vector<CKey> vKeys(BENCH_GOVERNANCE_VOTES);
+        std::vector<COutPoint> vOutpoints;
+        for (uint32_t i = 0; i < vKeys.size(); i++) {
+            vKeys[i].MakeNewKey(true);
+            CPubKey pubKey = vKeys[i].GetPubKey();
+            COutPoint outpoint(Hash(BEGIN(i), END(i)), 0);
+            CMasternode mn(CService(), outpoint, pubKey, pubKey, PROTOCOL_VERSION);
+            mnodeman.Add(mn);
+            vOutpoints.push_back(outpoint);
+        }
+
+        std::string strData = "[[\"watchdog\",{\"type\":3}]]";
+        CGovernanceObject govobj(uint256(), 1, GetAdjustedTime(), uint256(), HexStr(strData.begin(), strData.end()));
+        CPubKey pubKey = vKeys[0].GetPubKey();
+        govobj.SetMasternodeVin(vOutpoints[0]);
+        assert(govobj.Sign(vKeys[0], pubKey));
+        nHashWatchdog = govobj.GetHash();
+        governance.AddGovernanceObject(govobj, connman);
+        assert(governance.HaveObjectForHash(nHashWatchdog));
+
+        for (size_t i = 0; i < vKeys.size(); i++) {
+            CGovernanceVote vote(vOutpoints[i], nHashWatchdog, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES);
+            pubKey = vKeys[i].GetPubKey();
+            assert(vote.Sign(vKeys[i], pubKey));
+            vecVotes.push_back(vote);
+        }
+    }
+
+    ~GovernanceBenchSetup()
+    {
+        governance.Clear();
+        mnodeman.Clear();
+        SetMockTime(0);
+    }
+
+    /** Process every vote again, each masternode may vote once per GOVERNANCE_UPDATE_MIN */
+    void ProcessVotes()
+    {
+        nMockTime += GOVERNANCE_UPDATE_MIN;
+        SetMockTime(nMockTime);
+        for (const CGovernanceVote& vote : vecVotes) {
+            CGovernanceException exception;
+            assert(governance.ProcessVoteAndRelay(vote, exception, connman));
+        }
+    }
+};
+
+// Votes whose signatures are not in the message signature cache: every one
+// needs a public key recovery
+static void GovernanceVoteProcess(benchmark::State& state)
+{
+    // signing verifies the new signature too, which would fill the cache
+    mapArgs["-maxmsgsigcachesize"] = "0";
+    {
+        GovernanceBenchSetup setup;
+        while (state.KeepRunning()) {
+            setup.ProcessVotes();
+        }
+    }
+    mapArgs.erase("-maxmsgsigcachesize");
+}
+
+// The same votes again, e.g. relayed by another peer or retried as orphans,
+// answered by the message signature cache
+static void GovernanceVoteProcessCached(benchmark::State& state)
+{
+    GovernanceBenchSetup setup;
+
+    setup.ProcessVotes();
+    while (state.KeepRunning()) {
+        setup.ProcessVotes();
+    }
+}
+
+BENCHMARK(GovernanceVoteProcess);
+BENCHMARK(GovernanceVoteProcessCached);
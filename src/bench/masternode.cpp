@@ -0,0 +1,85 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chain_setup.h"
+
+#include "masternode-sync.h"
+#include "masternodeman.h"
+#include "net.h"
+
+// Size of the masternode list, a bit above the mainnet list at its peak
+static const int BENCH_MASTERNODES = 5000;
+// More blocks than the ranking cache holds, so cycling through them always misses
+static const int BENCH_MASTERNODE_BLOCKS = 64;
+
+static std::vector<COutPoint> AddBenchMasternodes()
+{
+    CKey key;
+    key.MakeNewKey(true);
+    std::vector<COutPoint> vOutpoints;
+    for (uint32_t i = 0; i < BENCH_MASTERNODES; i++) {
+        COutPoint outpoint(Hash(BEGIN(i), END(i)), i % 4);
+        struct in_addr ipv4;
+        ipv4.s_addr = htonl(0x0a000000 | i);
+        CService addr(ipv4, 9999);
+        CMasternode mn(addr, outpoint, key.GetPubKey(), key.GetPubKey(), PROTOCOL_VERSION);
+        mnodeman.Add(mn);
+        vOutpoints.push_back(outpoint);
+    }
+    return vOutpoints;
+}
+
+// Ranking queries need the masternode list to be synced
+static void SetMasternodeListSynced(CConnman& connman)
+{
+    while (!masternodeSync.IsMasternodeListSynced())
+        masternodeSync.SwitchToNextAsset(connman);
+}
+
+static void ResetMasternodes()
+{
+    masternodeSync.Reset();
+    mnodeman.Clear();
+}
+
+// A new block hash every time: score and sort the whole list
+static void MasternodeRankUncached(benchmark::State& state)
+{
+    BenchChainSetup setup(BENCH_MASTERNODE_BLOCKS);
+    CConnman connman;
+    SetMasternodeListSynced(connman);
+    std::vector<COutPoint> vOutpoints = AddBenchMasternodes();
+
+    int nHeight = 0;
+    int nRank;
+    while (state.KeepRunning()) {
+        nHeight = nHeight % BENCH_MASTERNODE_BLOCKS + 1;
+        assert(mnodeman.GetMasternodeRank(vOutpoints[nHeight], nRank, nHeight));
+    }
+
+    ResetMasternodes();
+}
+
+// Repeated queries for the same block, as done while processing the votes,
+// pings and verifications that refer to it
+static void MasternodeRankCached(benchmark::State& state)
+{
+    BenchChainSetup setup(BENCH_MASTERNODE_BLOCKS);
+    CConnman connman;
+    SetMasternodeListSynced(connman);
+    std::vector<COutPoint> vOutpoints = AddBenchMasternodes();
+
+    size_t i = 0;
+    int nRank;
+    while (state.KeepRunning()) {
+        i = (i + 1) % vOutpoints.size();
+        assert(mnodeman.GetMasternodeRank(vOutpoints[i], nRank, BENCH_MASTERNODE_BLOCKS));
+    }
+
+    ResetMasternodes();
+}
+
+BENCHMARK(MasternodeRankUncached);
+BENCHMARK(MasternodeRankCached);
@@ -0,0 +1,89 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chain_setup.h"
+
+#include "arith_uint256.h"
+#include "consensus/consensus.h"
+#include "consensus/validation.h"
+#include "policy/policy.h"
+#include "txmempool.h"
+#include "validation.h"
+
+#include <list>
+
+// Transactions added and removed by one iteration
+static const int BENCH_MEMPOOL_TXS = 200;
+// Length of the unconfirmed chains they form
+static const int BENCH_MEMPOOL_CHAIN = 10;
+
+// Chains of BENCH_MEMPOOL_CHAIN transactions, each spending its parent, so
+// that ancestor and descendant state has to be maintained
+static std::vector<CTransactionRef> MempoolChains()
+{
+    std::vector<CTransactionRef> vtx;
+    uint256 hashParent;
+    for (int i = 0; i < BENCH_MEMPOOL_TXS; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        if (i % BENCH_MEMPOOL_CHAIN == 0)
+            tx.vin[0].prevout = COutPoint(ArithToUint256(arith_uint256(i + 1)), 0);
+        else
+            tx.vin[0].prevout = COutPoint(hashParent, 0);
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+        tx.vout[0].nValue = (BENCH_MEMPOOL_TXS - i) * COIN;
+        vtx.push_back(MakeTransactionRef(std::move(tx)));
+        hashParent = vtx.back()->GetHash();
+    }
+    return vtx;
+}
+
+// Entry bookkeeping of the mempool without script or input checks: adding
+// the transactions with their ancestors, then removing them for a block
+static void MempoolAddRemove(benchmark::State& state)
+{
+    std::vector<CTransactionRef> vtx = MempoolChains();
+    CTxMemPool pool(CFeeRate(1000));
+    LockPoints lp;
+
+    while (state.KeepRunning()) {
+        LOCK(pool.cs);
+        for (size_t i = 0; i < vtx.size(); i++) {
+            bool fNoParent = i % BENCH_MEMPOOL_CHAIN == 0;
+            CTxMemPoolEntry entry(vtx[i], 1000, 0, 0.0, 1, fNoParent, fNoParent ? vtx[i]->GetValueOut() : 0, false, 1, lp);
+            pool.addUnchecked(vtx[i]->GetHash(), entry);
+        }
+        std::list<CTransaction> conflicts;
+        pool.removeForBlock(vtx, 2, conflicts, false);
+    }
+}
+
+// The full AcceptToMemoryPool path for signed P2PKH spends of confirmed
+// coins, followed by their removal when they are mined. Signatures come
+// from the signature cache after the first round.
+static void MempoolAcceptSigned(benchmark::State& state)
+{
+    BenchChainSetup setup(COINBASE_MATURITY + 1);
+    CTransaction txFanOut = setup.CreateFanOut(0, BENCH_MEMPOOL_TXS);
+    std::vector<CMutableTransaction> vtxSpends = setup.CreateSpends(txFanOut);
+    std::vector<CTransactionRef> vtx;
+    for (const CMutableTransaction& tx : vtxSpends)
+        vtx.push_back(MakeTransactionRef(tx));
+
+    LOCK(cs_main);
+    while (state.KeepRunning()) {
+        for (const CTransactionRef& tx : vtx) {
+            CValidationState validationState;
+            assert(AcceptToMemoryPool(mempool, validationState, tx, false, NULL));
+        }
+        std::list<CTransaction> conflicts;
+        mempool.removeForBlock(vtx, chainActive.Height() + 1, conflicts, false);
+    }
+}
+
+BENCHMARK(MempoolAddRemove);
+BENCHMARK(MempoolAcceptSigned);
@@ -0,0 +1,86 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "hash.h"
+#include "utilstrencodings.h"
+#include "primitives/block.h"
+#include "streams.h"
+#include "version.h"
+
+// A block of 200 two-in two-out P2PKH transactions, about 75 kB
+static CBlock SerializationBlock()
+{
+    CBlock block;
+    block.nVersion = 0x20000000;
+    block.nTime = 1646118000;
+    block.nBits = 0x1e0ffff0;
+    for (uint32_t i = 0; i < 200; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(2);
+        for (uint32_t j = 0; j < tx.vin.size(); j++) {
+            uint32_t n = i * 2 + j;
+            tx.vin[j].prevout = COutPoint(Hash(BEGIN(n), END(n)), j);
+            tx.vin[j].scriptSig = CScript() << std::vector<unsigned char>(72, 0x30) << std::vector<unsigned char>(33, 0x02);
+        }
+        tx.vout.resize(2);
+        for (uint32_t j = 0; j < tx.vout.size(); j++) {
+            tx.vout[j].nValue = (i + 1) * 1000 + j;
+            tx.vout[j].scriptPubKey = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, i) << OP_EQUALVERIFY << OP_CHECKSIG;
+        }
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    return block;
+}
+
+static void SerializeBlock(benchmark::State& state)
+{
+    CBlock block = SerializationBlock();
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream.reserve(::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION));
+    while (state.KeepRunning()) {
+        stream.clear();
+        stream << block;
+    }
+}
+
+// Deserialization includes hashing every transaction, which CTransaction
+// caches on construction
+static void DeserializeBlock(benchmark::State& state)
+{
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << SerializationBlock();
+    while (state.KeepRunning()) {
+        CBlock block;
+        CDataStream streamCopy(stream);
+        streamCopy >> block;
+    }
+}
+
+static void SerializeTransaction(benchmark::State& state)
+{
+    CTransaction tx = *SerializationBlock().vtx[0];
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    while (state.KeepRunning()) {
+        stream.clear();
+        stream << tx;
+    }
+}
+
+static void DeserializeTransaction(benchmark::State& state)
+{
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << *SerializationBlock().vtx[0];
+    while (state.KeepRunning()) {
+        CTransaction tx;
+        CDataStream streamCopy(stream);
+        streamCopy >> tx;
+    }
+}
+
+BENCHMARK(SerializeBlock);
+BENCHMARK(DeserializeBlock);
+BENCHMARK(SerializeTransaction);
+BENCHMARK(DeserializeTransaction);
@@ -0,0 +1,123 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "compat.h"
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+// Cost of one wakeup of the socket handler with many connected peers of which
+// only one has sent data, as with a node serving mostly idle connections.
+// Each loop mirrors what ThreadSocketHandler does per round with that backend.
+
+#ifndef WIN32
+class BenchSocketPairs
+{
+public:
+    std::vector<int> vLocal, vRemote;
+
+    BenchSocketPairs(int nPairs)
+    {
+        for (int i = 0; i < nPairs; i++) {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0)
+                break;
+            vLocal.push_back(fds[0]);
+            vRemote.push_back(fds[1]);
+        }
+    }
+
+    ~BenchSocketPairs()
+    {
+        for (size_t i = 0; i < vLocal.size(); i++) {
+            close(vLocal[i]);
+            close(vRemote[i]);
+        }
+    }
+
+    // The peer that talks this round
+    int Remote(uint64_t n) const { return vRemote[n % vRemote.size()]; }
+};
+
+static void SocketEventsSelect(benchmark::State& state, int nPairs)
+{
+    BenchSocketPairs pairs(nPairs);
+    char pchBuf[64];
+    uint64_t n = 0;
+    while (state.KeepRunning()) {
+        if (send(pairs.Remote(n++), "x", 1, 0) != 1)
+            break;
+
+        fd_set fdsetRecv, fdsetError;
+        FD_ZERO(&fdsetRecv);
+        FD_ZERO(&fdsetError);
+        int hSocketMax = 0;
+        for (size_t i = 0; i < pairs.vLocal.size(); i++) {
+            FD_SET(pairs.vLocal[i], &fdsetRecv);
+            FD_SET(pairs.vLocal[i], &fdsetError);
+            hSocketMax = std::max(hSocketMax, pairs.vLocal[i]);
+        }
+        struct timeval timeout = {0, 40000};
+        select(hSocketMax + 1, &fdsetRecv, NULL, &fdsetError, &timeout);
+        for (size_t i = 0; i < pairs.vLocal.size(); i++) {
+            if (FD_ISSET(pairs.vLocal[i], &fdsetRecv) || FD_ISSET(pairs.vLocal[i], &fdsetError))
+                recv(pairs.vLocal[i], pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+        }
+    }
+}
+#endif
+
+#ifdef USE_EPOLL
+static void SocketEventsEpoll(benchmark::State& state, int nPairs)
+{
+    BenchSocketPairs pairs(nPairs);
+    int epollfd = epoll_create1(EPOLL_CLOEXEC);
+    for (size_t i = 0; i < pairs.vLocal.size(); i++) {
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.u64 = i;
+        epoll_ctl(epollfd, EPOLL_CTL_ADD, pairs.vLocal[i], &event);
+    }
+    // consume the initial writability edges
+    struct epoll_event events[256];
+    while (epoll_wait(epollfd, events, 256, 0) > 0) {}
+
+    char pchBuf[64];
+    uint64_t n = 0;
+    while (state.KeepRunning()) {
+        if (send(pairs.Remote(n++), "x", 1, 0) != 1)
+            break;
+
+        int nEvents = epoll_wait(epollfd, events, 256, 50);
+        for (int i = 0; i < nEvents; i++) {
+            int hSocket = pairs.vLocal[events[i].data.u64];
+            while (recv(hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT) > 0) {}
+        }
+    }
+    close(epollfd);
+}
+#endif
+
+#ifndef WIN32
+static void SocketEventsSelect10(benchmark::State& state) { SocketEventsSelect(state, 10); }
+static void SocketEventsSelect400(benchmark::State& state) { SocketEventsSelect(state, 400); }
+
+BENCHMARK(SocketEventsSelect10);
+BENCHMARK(SocketEventsSelect400);
+#endif
+
+#ifdef USE_EPOLL
+static void SocketEventsEpoll10(benchmark::State& state) { SocketEventsEpoll(state, 10); }
+static void SocketEventsEpoll400(benchmark::State& state) { SocketEventsEpoll(state, 400); }
+
+BENCHMARK(SocketEventsEpoll10);
+BENCHMARK(SocketEventsEpoll400);
+#endif
@@ -0,0 +1,132 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilereader.h"
+
+#include "util.h"
+#include "validation.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#include <vector>
+
+CBlockFileReader blockFileReader(MAX_BLOCK_READER_OPEN_FILES, MAX_BLOCK_READER_CACHED_BLOCKS);
+
+CBlockFileHandle::CBlockFileHandle(const CDiskBlockPos& pos, bool& fOpenedRet)
+{
+    boost::filesystem::path path = GetBlockPosFilename(pos, "blk");
+#ifdef WIN32
+    file = fopen(path.string().c_str(), "rb");
+    fOpenedRet = file != NULL;
+#else
+    fd = open(path.string().c_str(), O_RDONLY);
+    fOpenedRet = fd != -1;
+#endif
+    if (!fOpenedRet)
+        LogPrintf("Unable to open file %s\n", path.string());
+}
+
+CBlockFileHandle::~CBlockFileHandle()
+{
+#ifdef WIN32
+    if (file)
+        fclose(file);
+#else
+    if (fd != -1)
+        close(fd);
+#endif
+}
+
+bool CBlockFileHandle::Read(char* pch, size_t nSize, uint64_t nPos) const
+{
+#ifdef WIN32
+    LOCK(cs);
+    if (!file || _fseeki64(file, nPos, SEEK_SET) != 0)
+        return false;
+    return fread(pch, 1, nSize, file) == nSize;
+#else
+    if (fd == -1)
+        return false;
+    while (nSize > 0) {
+        ssize_t nRead = pread(fd, pch, nSize, nPos);
+        if (nRead < 0 && errno == EINTR)
+            continue;
+        if (nRead <= 0)
+            return false;
+        pch += nRead;
+        nSize -= nRead;
+        nPos += nRead;
+    }
+    return true;
+#endif
+}
+
+std::shared_ptr<const CBlockFileHandle> CBlockFileReader::GetFile(const CDiskBlockPos& pos)
+{
+    std::shared_ptr<const CBlockFileHandle> file;
+    if (pos.IsNull())
+        return file;
+
+    LOCK(cs);
+    if (mapFiles.Get(pos.nFile, file)) {
+        // reinsert to make it the most recently used one, CacheMap evicts the oldest entry first
+        mapFiles.Erase(pos.nFile);
+        mapFiles.Insert(pos.nFile, file);
+        return file;
+    }
+
+    // an evicted handle stays open until its last reader is done with it
+    bool fOpened;
+    std::shared_ptr<const CBlockFileHandle> fileNew = std::make_shared<const CBlockFileHandle>(pos, fOpened);
+    if (!fOpened)
+        return file;
+    mapFiles.Insert(pos.nFile, fileNew);
+    return fileNew;
+}
+
+std::shared_ptr<const CBlock> CBlockFileReader::GetBlock(const CDiskBlockPos& pos)
+{
+    BlockKey key(pos.nFile, pos.nPos);
+    std::shared_ptr<const CBlock> pblock;
+
+    LOCK(cs);
+    if (mapBlocks.Get(key, pblock)) {
+        mapBlocks.Erase(key);
+        mapBlocks.Insert(key, pblock);
+    }
+    return pblock;
+}
+
+void CBlockFileReader::AddBlock(const CDiskBlockPos& pos, const std::shared_ptr<const CBlock>& pblock)
+{
+    BlockKey key(pos.nFile, pos.nPos);
+
+    LOCK(cs);
+    mapBlocks.Erase(key);
+    mapBlocks.Insert(key, pblock);
+}
+
+void CBlockFileReader::Forget(int nFile)
+{
+    LOCK(cs);
+    mapFiles.Erase(nFile);
+
+    std::vector<BlockKey> vKeys;
+    for (const auto& item : mapBlocks.GetItemList())
+        if (item.key.first == nFile)
+            vKeys.push_back(item.key);
+    for (const BlockKey& key : vKeys)
+        mapBlocks.Erase(key);
+}
+
+void CBlockFileReader::Clear()
+{
+    LOCK(cs);
+    mapFiles.Clear();
+    mapBlocks.Clear();
+}
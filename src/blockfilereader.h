@@ -0,0 +1,83 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKFILEREADER_H
+#define BITCOIN_BLOCKFILEREADER_H
+
+#include "cachemap.h"
+#include "chain.h"
+#include "primitives/block.h"
+#include "sync.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <utility>
+
+/** Block files CBlockFileReader keeps open */
+static const unsigned int MAX_BLOCK_READER_OPEN_FILES = 64;
+/** Decoded blocks CBlockFileReader keeps */
+static const unsigned int MAX_BLOCK_READER_CACHED_BLOCKS = 32;
+
+/** Read-only handle of one block file, closed once the last reader lets go of it */
+class CBlockFileHandle
+{
+private:
+#ifdef WIN32
+    FILE* file;
+    // there is no positional read, seeking and reading must not interleave
+    mutable CCriticalSection cs;
+#else
+    int fd;
+#endif
+
+    CBlockFileHandle(const CBlockFileHandle&);
+    CBlockFileHandle& operator=(const CBlockFileHandle&);
+
+public:
+    CBlockFileHandle(const CDiskBlockPos& pos, bool& fOpenedRet);
+    ~CBlockFileHandle();
+
+    /** Read nSize bytes at position nPos of the file, false on error or short read */
+    bool Read(char* pch, size_t nSize, uint64_t nPos) const;
+};
+
+/**
+ * Read access to the block files (blk?????.dat) for any thread, without
+ * cs_main. Files stay open in a small pool and are read with positional
+ * reads, so readers neither reopen them on every block nor share a file
+ * position. The most recently decoded blocks are kept as well; they are
+ * cheap to copy, transactions are shared between the copies.
+ */
+class CBlockFileReader
+{
+private:
+    typedef std::pair<int, unsigned int> BlockKey;
+
+    CCriticalSection cs;
+    CacheMap<int, std::shared_ptr<const CBlockFileHandle> > mapFiles;
+    CacheMap<BlockKey, std::shared_ptr<const CBlock> > mapBlocks;
+
+public:
+    CBlockFileReader(unsigned int nMaxFiles, unsigned int nMaxBlocks) :
+        mapFiles(nMaxFiles), mapBlocks(nMaxBlocks) {}
+
+    /** The block file pos is in, opened if needed; null if it can't be opened */
+    std::shared_ptr<const CBlockFileHandle> GetFile(const CDiskBlockPos& pos);
+
+    /** The block decoded from pos earlier, or null */
+    std::shared_ptr<const CBlock> GetBlock(const CDiskBlockPos& pos);
+    /** Remember a block decoded from pos, which must have passed its checks */
+    void AddBlock(const CDiskBlockPos& pos, const std::shared_ptr<const CBlock>& pblock);
+
+    /** Close block file nFile and forget its blocks, before it is deleted */
+    void Forget(int nFile);
+    void Clear();
+};
+
+/** Shared by everything reading blocks from disk */
+extern CBlockFileReader blockFileReader;
+
+#endif // BITCOIN_BLOCKFILEREADER_H
@@ -0,0 +1,226 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockimport.h"
+
+#include "clientversion.h"
+#include "consensus/consensus.h"
+#include "streams.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <string.h>
+
+/**
+ * A block is followed by the next block's message start, the zeroes of
+ * preallocated file space or the end of the file. Anything else means the
+ * size in front of the block was bogus.
+ */
+static bool IsAtBlockBoundary(CBufferedFile& blkdat, const CMessageHeader::MessageStartChars& messageStart)
+{
+    unsigned char buf[MESSAGE_START_SIZE];
+    try {
+        blkdat >> FLATDATA(buf);
+    } catch (const std::exception&) {
+        return true;
+    }
+    static const unsigned char zeroes[MESSAGE_START_SIZE] = {};
+    return memcmp(buf, messageStart, MESSAGE_START_SIZE) == 0 || memcmp(buf, zeroes, MESSAGE_START_SIZE) == 0;
+}
+
+CBlockImportPipeline::CBlockImportPipeline(FILE* fileIn, const CMessageHeader::MessageStartChars& messageStart, int nParseThreads) :
+    nBytesInFlight(0), nFrames(0), nNextSeq(0), fScanDone(false), fStop(false)
+{
+    stats.nParseThreads = std::max(1, nParseThreads);
+    threads.create_thread(boost::bind(&CBlockImportPipeline::ThreadScan, this, fileIn, boost::cref(messageStart)));
+    for (int i = 0; i < stats.nParseThreads; i++)
+        threads.create_thread(boost::bind(&CBlockImportPipeline::ThreadParse, this));
+}
+
+CBlockImportPipeline::~CBlockImportPipeline()
+{
+    // also runs when the consumer was interrupted, joining must not throw then
+    boost::this_thread::disable_interruption di;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStop = true;
+    }
+    condScan.notify_all();
+    condParse.notify_all();
+    condNext.notify_all();
+    threads.join_all();
+}
+
+bool CBlockImportPipeline::PushFrame(Frame& frame)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    int64_t nWaitStart = GetTimeMicros();
+    // a block larger than the whole budget still goes through on its own
+    while (!fStop && nBytesInFlight > 0 && nBytesInFlight + frame.vch.size() > MAX_IMPORT_BYTES_IN_FLIGHT)
+        condScan.wait(lock);
+    // waiting for room is not scanning
+    stats.nScanMicros -= GetTimeMicros() - nWaitStart;
+    if (fStop)
+        return false;
+
+    frame.nSeq = nFrames++;
+    nBytesInFlight += frame.vch.size();
+    stats.nScanBytes += frame.vch.size();
+    queueFrames.push_back(Frame());
+    queueFrames.back().nSeq = frame.nSeq;
+    queueFrames.back().nPos = frame.nPos;
+    queueFrames.back().vch.swap(frame.vch);
+    condParse.notify_one();
+    return true;
+}
+
+void CBlockImportPipeline::ThreadScan(FILE* fileIn, const CMessageHeader::MessageStartChars& messageStart)
+{
+    RenameThread("chainox-impscan");
+    int64_t nStart = GetTimeMicros();
+
+    try {
+        unsigned int nMaxBlockSize = MaxBlockSize(true);
+        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor.
+        // Rewinding to a bogus block's message start goes back over the
+        // block and the bytes peeked behind it.
+        CBufferedFile blkdat(fileIn, 2*nMaxBlockSize, nMaxBlockSize+8+MESSAGE_START_SIZE, SER_DISK, CLIENT_VERSION);
+        uint64_t nRewind = blkdat.GetPos();
+        while (!blkdat.eof()) {
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                if (fStop)
+                    break;
+            }
+
+            blkdat.SetPos(nRewind);
+            nRewind++; // start one byte further next time, in case of failure
+            blkdat.SetLimit(); // remove former limit
+            unsigned int nSize = 0;
+            try {
+                // locate a header
+                unsigned char buf[MESSAGE_START_SIZE];
+                blkdat.FindByte(messageStart[0]);
+                nRewind = blkdat.GetPos()+1;
+                blkdat >> FLATDATA(buf);
+                if (memcmp(buf, messageStart, MESSAGE_START_SIZE))
+                    continue;
+                // read size
+                blkdat >> nSize;
+                if (nSize < 80 || nSize > nMaxBlockSize)
+                    continue;
+            } catch (const std::exception&) {
+                // no valid block header found; don't complain
+                break;
+            }
+            try {
+                // frame the block, the parse stage deserializes it
+                Frame frame;
+                uint64_t nBlockPos = blkdat.GetPos();
+                frame.nPos = nBlockPos;
+                frame.vch.resize(nSize);
+                blkdat.SetLimit(nBlockPos + nSize);
+                blkdat.read(frame.vch.data(), nSize);
+                blkdat.SetLimit();
+                if (IsAtBlockBoundary(blkdat, messageStart)) {
+                    blkdat.SetPos(nBlockPos + nSize);
+                    nRewind = nBlockPos + nSize;
+                } else {
+                    // The block may still deserialize from the start of the
+                    // frame, but the next one is to be looked for from here on
+                    LogPrint("reindex", "%s: Size %u of block at %u is off, looking for the next block inside it\n", __func__, nSize, nBlockPos);
+                }
+
+                if (!PushFrame(frame))
+                    break;
+            } catch (const std::exception& e) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        LogPrintf("%s: System error - %s\n", __func__, e.what());
+    }
+
+    boost::unique_lock<boost::mutex> lock(mutex);
+    stats.nScanMicros += GetTimeMicros() - nStart;
+    fScanDone = true;
+    condParse.notify_all();
+    condNext.notify_all();
+}
+
+void CBlockImportPipeline::ThreadParse()
+{
+    RenameThread("chainox-impparse");
+
+    while (true) {
+        Frame frame;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && !fScanDone && queueFrames.empty())
+                condParse.wait(lock);
+            if (fStop || queueFrames.empty())
+                return;
+            frame.nSeq = queueFrames.front().nSeq;
+            frame.nPos = queueFrames.front().nPos;
+            frame.vch.swap(queueFrames.front().vch);
+            queueFrames.pop_front();
+        }
+
+        int64_t nStart = GetTimeMicros();
+        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        try {
+            CDataStream ss(frame.vch, SER_DISK, CLIENT_VERSION);
+            ss >> *pblock;
+            // phiCHOX, cached in the header for the connect stage
+            pblock->GetHash();
+        } catch (const std::exception& e) {
+            LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+            pblock.reset();
+        }
+        int64_t nTime = GetTimeMicros() - nStart;
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        ParsedBlock& parsed = mapParsed[frame.nSeq];
+        parsed.block.pblock = pblock;
+        parsed.block.nPos = frame.nPos;
+        parsed.nSize = frame.vch.size();
+        stats.nParseMicros += nTime;
+        if (pblock)
+            stats.nParsed++;
+        else
+            stats.nParseFailures++;
+        if (frame.nSeq == nNextSeq)
+            condNext.notify_one();
+    }
+}
+
+bool CBlockImportPipeline::Next(CImportedBlock& blockRet)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    int64_t nWaitStart = GetTimeMicros();
+    while (true) {
+        std::map<uint64_t, ParsedBlock>::iterator it = mapParsed.find(nNextSeq);
+        if (it != mapParsed.end()) {
+            blockRet = it->second.block;
+            nBytesInFlight -= it->second.nSize;
+            mapParsed.erase(it);
+            nNextSeq++;
+            stats.nWaitMicros += GetTimeMicros() - nWaitStart;
+            condScan.notify_one();
+            return true;
+        }
+        if (fScanDone && nNextSeq == nFrames) {
+            stats.nWaitMicros += GetTimeMicros() - nWaitStart;
+            return false;
+        }
+        // an interruption point, for shutdown during a reindex
+        condNext.wait(lock);
+    }
+}
+
+CBlockImportStats CBlockImportPipeline::GetStats()
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return stats;
+}
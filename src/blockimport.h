@@ -0,0 +1,109 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKIMPORT_H
+#define BITCOIN_BLOCKIMPORT_H
+
+#include "primitives/block.h"
+#include "protocol.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+/** Serialized size of the blocks the import pipeline holds ahead of the connect stage */
+static const uint64_t MAX_IMPORT_BYTES_IN_FLIGHT = 64 * 1024 * 1024;
+
+/** A block read by CBlockImportPipeline */
+struct CImportedBlock
+{
+    //! The block with its header hash computed, null if its data didn't deserialize
+    std::shared_ptr<const CBlock> pblock;
+    //! Position of the block in the file, past the message start and size
+    unsigned int nPos;
+};
+
+/** Work done by the stages of a CBlockImportPipeline so far */
+struct CBlockImportStats
+{
+    uint64_t nScanBytes;
+    int64_t nScanMicros;
+    unsigned int nParsed;
+    unsigned int nParseFailures;
+    //! Summed over the parse threads
+    int64_t nParseMicros;
+    int nParseThreads;
+    //! Spent by the consumer waiting for the next block
+    int64_t nWaitMicros;
+
+    CBlockImportStats() : nScanBytes(0), nScanMicros(0), nParsed(0), nParseFailures(0),
+        nParseMicros(0), nParseThreads(0), nWaitMicros(0) {}
+};
+
+/**
+ * Reads the blocks of a block file (blk?????.dat or bootstrap.dat) in
+ * stages that overlap: one thread scans the file for message starts and
+ * frames the blocks' raw data, a pool of threads deserializes the frames
+ * and computes the header hashes, and the consumer takes the blocks in
+ * file order from Next().
+ */
+class CBlockImportPipeline
+{
+private:
+    struct Frame {
+        uint64_t nSeq;
+        unsigned int nPos;
+        std::vector<char> vch;
+    };
+
+    struct ParsedBlock {
+        CImportedBlock block;
+        size_t nSize;
+    };
+
+    boost::mutex mutex;
+    //! Signalled when the connect stage has taken a block, making room for more frames
+    boost::condition_variable condScan;
+    //! Signalled when a frame is queued or scanning is done
+    boost::condition_variable condParse;
+    //! Signalled when a block is parsed or scanning is done
+    boost::condition_variable condNext;
+
+    std::deque<Frame> queueFrames;
+    std::map<uint64_t, ParsedBlock> mapParsed;
+    uint64_t nBytesInFlight;
+    uint64_t nFrames;
+    uint64_t nNextSeq;
+    bool fScanDone;
+    bool fStop;
+    CBlockImportStats stats;
+
+    boost::thread_group threads;
+
+    CBlockImportPipeline(const CBlockImportPipeline&);
+    CBlockImportPipeline& operator=(const CBlockImportPipeline&);
+
+    void ThreadScan(FILE* fileIn, const CMessageHeader::MessageStartChars& messageStart);
+    void ThreadParse();
+    /** Queue a frame, waiting for room; false if the pipeline is stopping */
+    bool PushFrame(Frame& frame);
+
+public:
+    /** Takes over fileIn and closes it once scanned */
+    CBlockImportPipeline(FILE* fileIn, const CMessageHeader::MessageStartChars& messageStart, int nParseThreads);
+    ~CBlockImportPipeline();
+
+    /** The next block in file order, false once the whole file was read */
+    bool Next(CImportedBlock& blockRet);
+
+    CBlockImportStats GetStats();
+};
+
+#endif // BITCOIN_BLOCKIMPORT_H
@@ -405,6 +405,10 @@ public:
     }
 };
 
+/** Find the last common ancestor two blocks have.
+ *  Both pa and pb must be non-NULL. */
+CBlockIndex* LastCommonAncestor(CBlockIndex* pa, CBlockIndex* pb);
+
 /** An in-memory indexed chain of blocks. */
 class CChain {
 private:
@@ -12,7 +12,9 @@
 
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const { return false; }
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
+std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
 bool CCoinsView::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) { return false; }
+bool CCoinsView::BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock) { return false; }
 CCoinsViewCursor *CCoinsView::Cursor() const { return 0; }
 
 bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
@@ -25,14 +27,16 @@ CCoinsViewBacked::CCoinsViewBacked(CCoinsView *viewIn) : base(viewIn) { }
 bool CCoinsViewBacked::GetCoin(const COutPoint &outpoint, Coin &coin) const { return base->GetCoin(outpoint, coin); }
 bool CCoinsViewBacked::HaveCoin(const COutPoint &outpoint) const { return base->HaveCoin(outpoint); }
 uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
+std::vector<uint256> CCoinsViewBacked::GetHeadBlocks() const { return base->GetHeadBlocks(); }
 void CCoinsViewBacked::SetBackend(CCoinsView &viewIn) { base = &viewIn; }
 bool CCoinsViewBacked::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) { return base->BatchWrite(mapCoins, hashBlock); }
+bool CCoinsViewBacked::BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock) { return base->BatchWritePartial(mapCoins, hashBlock); }
 CCoinsViewCursor *CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
 SaltedOutpointHasher::SaltedOutpointHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0) {}
+CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0), nCacheHits(0), nCacheMisses(0) {}
 
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
     return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
@@ -40,12 +44,17 @@ size_t CCoinsViewCache::DynamicMemoryUsage() const {
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
     CCoinsMap::iterator it = cacheCoins.find(outpoint);
-    if (it != cacheCoins.end())
+    if (it != cacheCoins.end()) {
+        nCacheHits++;
+        it->second.recent = true;
         return it;
+    }
+    nCacheMisses++;
     Coin tmp;
     if (!base->GetCoin(outpoint, tmp))
         return cacheCoins.end();
     CCoinsMap::iterator ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(tmp))).first;
+    ret->second.recent = true;
     if (ret->second.coin.IsSpent()) {
         // The parent only has an empty entry for this outpoint; we can consider our
         // version as fresh.
@@ -81,7 +90,8 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
         fresh = !(it->second.flags & CCoinsCacheEntry::DIRTY);
     }
     it->second.coin = std::move(coin);
-    it->second.flags |= CCoinsCacheEntry::DIRTY | (fresh ? CCoinsCacheEntry::FRESH : 0);
+    MarkDirty(it);
+    it->second.flags |= (fresh ? CCoinsCacheEntry::FRESH : 0);
     cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
 }
 
@@ -105,7 +115,7 @@ bool CCoinsViewCache::SpendCoin(const COutPoint &outpoint, Coin* moveout) {
     if (it->second.flags & CCoinsCacheEntry::FRESH) {
         cacheCoins.erase(it);
     } else {
-        it->second.flags |= CCoinsCacheEntry::DIRTY;
+        MarkDirty(it);
         it->second.coin.Clear();
     }
     return true;
@@ -152,10 +162,11 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                 if (!(it->second.flags & CCoinsCacheEntry::FRESH && it->second.coin.IsSpent())) {
                     // Otherwise we will need to create it in the parent
                     // and move the data up and mark it as dirty
-                    CCoinsCacheEntry& entry = cacheCoins[it->first];
+                    CCoinsMap::iterator itNew = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(it->first), std::tuple<>()).first;
+                    CCoinsCacheEntry& entry = itNew->second;
                     entry.coin = std::move(it->second.coin);
                     cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
-                    entry.flags = CCoinsCacheEntry::DIRTY;
+                    MarkDirty(itNew);
                     // We can mark it FRESH in the parent if it was FRESH in the child
                     // Otherwise it might have just been flushed from the parent's cache
                     // and already exist in the grandparent
@@ -182,7 +193,7 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                     cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
                     itUs->second.coin = std::move(it->second.coin);
                     cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
-                    itUs->second.flags |= CCoinsCacheEntry::DIRTY;
+                    MarkDirty(itUs);
                     // NOTE: It is possible the child has a FRESH flag here in
                     // the event the entry we found in the parent is pruned. But
                     // we must not copy that FRESH flag to the parent as that
@@ -198,13 +209,83 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
     return true;
 }
 
+bool CCoinsViewCache::BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlockIn) {
+    // The changes are merged all the same, they just don't move the best block
+    return BatchWrite(mapCoins, GetBestBlock());
+}
+
 bool CCoinsViewCache::Flush() {
     bool fOk = base->BatchWrite(cacheCoins, hashBlock);
     cacheCoins.clear();
     cachedCoinsUsage = 0;
+    vSyncQueue.clear();
     return fOk;
 }
 
+void CCoinsViewCache::MarkDirty(CCoinsMap::iterator it) {
+    if (!(it->second.flags & CCoinsCacheEntry::DIRTY)) {
+        it->second.flags |= CCoinsCacheEntry::DIRTY;
+        vSyncQueue.push_back(it->first);
+    }
+}
+
+bool CCoinsViewCache::SyncChunk(size_t nMaxCoins) {
+    CCoinsMap mapChunk;
+    while (!vSyncQueue.empty() && mapChunk.size() < nMaxCoins) {
+        CCoinsMap::iterator it = cacheCoins.find(vSyncQueue.front());
+        vSyncQueue.pop_front();
+        // Spent and erased, or written already, since it was queued
+        if (it == cacheCoins.end() || !(it->second.flags & CCoinsCacheEntry::DIRTY))
+            continue;
+        CCoinsCacheEntry& entry = mapChunk[it->first];
+        entry.coin = it->second.coin;
+        entry.flags = CCoinsCacheEntry::DIRTY;
+        if (it->second.coin.IsSpent()) {
+            // The base view won't have it anymore either. SpendCoin took
+            // it off cachedCoinsUsage already.
+            cacheCoins.erase(it);
+        } else {
+            // The base view has it now, so it isn't FRESH anymore
+            it->second.flags = 0;
+        }
+    }
+
+    // Every modified coin is queued, so with the queue empty the base view
+    // holds all of them
+    if (vSyncQueue.empty())
+        return base->BatchWrite(mapChunk, GetBestBlock());
+    return base->BatchWritePartial(mapChunk, GetBestBlock());
+}
+
+bool CCoinsViewCache::Sync(size_t nChunkCoins) {
+    do {
+        if (!SyncChunk(nChunkCoins))
+            return false;
+    } while (!vSyncQueue.empty());
+    return true;
+}
+
+size_t CCoinsViewCache::Evict(size_t nMaxUsage) {
+    size_t nEvicted = 0;
+    // The first pass gives coins looked up since the previous call a second
+    // chance, the second one drops any unmodified coin
+    for (int nPass = 0; nPass < 2 && DynamicMemoryUsage() > nMaxUsage; nPass++) {
+        for (CCoinsMap::iterator it = cacheCoins.begin(); it != cacheCoins.end() && DynamicMemoryUsage() > nMaxUsage;) {
+            if (it->second.flags != 0) {
+                ++it;
+            } else if (nPass == 0 && it->second.recent) {
+                it->second.recent = false;
+                ++it;
+            } else {
+                cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
+                it = cacheCoins.erase(it);
+                nEvicted++;
+            }
+        }
+    }
+    return nEvicted;
+}
+
 void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
     CCoinsMap::iterator it = cacheCoins.find(hash);
@@ -218,6 +299,11 @@ unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
 
+void CCoinsViewCache::GetLookupStats(uint64_t& nHits, uint64_t& nMisses) const {
+    nHits = nCacheHits;
+    nMisses = nCacheMisses;
+}
+
 CAmount CCoinsViewCache::GetValueIn(const CTransaction& tx) const
 {
     if (tx.IsCoinBase())
@@ -16,6 +16,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <deque>
+
 #include <boost/foreach.hpp>
 #include <unordered_map>
 
@@ -104,6 +106,7 @@ struct CCoinsCacheEntry
 {
     Coin coin; // The actual cached data.
     unsigned char flags;
+    bool recent; // Looked up since an eviction pass last went by (see CCoinsViewCache::Evict).
 
     enum Flags {
         DIRTY = (1 << 0), // This cache entry is potentially different from the version in the parent view.
@@ -115,8 +118,8 @@ struct CCoinsCacheEntry
          */
     };
 
-    CCoinsCacheEntry() : flags(0) {}
-    explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
+    CCoinsCacheEntry() : flags(0), recent(false) {}
+    explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0), recent(false) {}
 };
 
 typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
@@ -158,10 +161,20 @@ public:
     //! Retrieve the block hash whose state this CCoinsView currently represents
     virtual uint256 GetBestBlock() const;
 
+    //! Retrieve the range of blocks that may have been only partially written.
+    //! If the view is in a consistent state, the result is the empty vector.
+    //! Otherwise, a two-element vector is returned consisting of the new and
+    //! the old block hash, in that order.
+    virtual std::vector<uint256> GetHeadBlocks() const;
+
     //! Do a bulk modification (multiple Coin changes + BestBlock change).
     //! The passed mapCoins can be modified.
     virtual bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock);
 
+    //! Write some of the changes towards the state at hashBlock, leaving the
+    //! view in transition to it until a BatchWrite completes it.
+    virtual bool BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock);
+
     //! Get a cursor to iterate over the whole state
     virtual CCoinsViewCursor *Cursor() const;
 
@@ -184,8 +197,10 @@ public:
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
+    std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
     size_t EstimateSize() const override;
 };
@@ -205,6 +220,17 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Lookups served from the cache, and those that went to the base view. */
+    mutable uint64_t nCacheHits;
+    mutable uint64_t nCacheMisses;
+
+    /* Coins in the order they were modified since they were last written,
+     * for SyncChunk. Some may have been erased or written since. */
+    std::deque<COutPoint> vSyncQueue;
+
+    /* Queue an entry for SyncChunk as it becomes modified */
+    void MarkDirty(CCoinsMap::iterator it);
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -214,6 +240,7 @@ public:
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256 &hashBlock);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor* Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
@@ -257,6 +284,28 @@ public:
      */
     bool Flush();
 
+    /**
+     * Write up to nMaxCoins modified coins to the base view, those modified
+     * first first, and keep them cached as unmodified ones, dropping those
+     * that are spent. The base view is left in transition to this view's best
+     * block, unless no modified coins are left, which makes it consistent.
+     */
+    bool SyncChunk(size_t nMaxCoins);
+
+    /**
+     * Write all modified coins to the base view in chunks of nChunkCoins and
+     * mark it consistent with this view's best block. Unlike Flush(), this
+     * keeps the coins cached.
+     */
+    bool Sync(size_t nChunkCoins);
+
+    /**
+     * Drop unmodified coins until the cache uses at most nMaxUsage bytes,
+     * those that were not looked up since the previous call first.
+     * Returns the number of coins dropped.
+     */
+    size_t Evict(size_t nMaxUsage);
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
@@ -269,6 +318,12 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    //! Number of coins queued for SyncChunk, an upper bound of the modified ones
+    size_t GetSyncQueueSize() const { return vSyncQueue.size(); }
+
+    //! Lookups served from the cache and those that went to the base view
+    void GetLookupStats(uint64_t& nHits, uint64_t& nMisses) const;
+
     /** 
      * Amount of chainox coming in to a transaction
      * Note that lightweight clients may not know anything besides the hash of previous transactions,
@@ -0,0 +1,184 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinsprefetch.h"
+
+#include "util.h"
+#include "utiltime.h"
+
+#include <boost/foreach.hpp>
+
+CCoinsViewPrefetch::CCoinsViewPrefetch(CCoinsView* viewIn, int nThreads) :
+    CCoinsViewBacked(viewIn), nGeneration(0), fStop(false)
+{
+    for (int i = 0; i < std::max(1, nThreads); i++)
+        threads.create_thread(boost::bind(&CCoinsViewPrefetch::ThreadPrefetch, this));
+}
+
+CCoinsViewPrefetch::~CCoinsViewPrefetch()
+{
+    boost::this_thread::disable_interruption di;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStop = true;
+    }
+    condWork.notify_all();
+    threads.join_all();
+}
+
+void CCoinsViewPrefetch::ThreadPrefetch()
+{
+    RenameThread("chainox-prefetch");
+
+    while (true) {
+        COutPoint outpoint;
+        uint64_t nGenerationStart;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && queueOutpoints.empty())
+                condWork.wait(lock);
+            if (fStop)
+                return;
+            outpoint = queueOutpoints.front();
+            queueOutpoints.pop_front();
+            // a lookup or Discard took it meanwhile
+            if (!setQueued.erase(outpoint))
+                continue;
+            setFetching.insert(outpoint);
+            nGenerationStart = nGeneration;
+        }
+
+        int64_t nStart = GetTimeMicros();
+        Coin coin;
+        bool fRead = true;
+        try {
+            // a coin that isn't there is kept as a spent one
+            base->GetCoin(outpoint, coin);
+        } catch (const std::exception& e) {
+            // the lookup reads it again and handles the error
+            LogPrintf("%s: Error reading from database: %s\n", __func__, e.what());
+            fRead = false;
+        }
+        int64_t nTime = GetTimeMicros() - nStart;
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        setFetching.erase(outpoint);
+        stats.nFetchMicros += nTime;
+        if (fRead && nGenerationStart == nGeneration && mapPrefetched.size() < MAX_PREFETCHED_COINS) {
+            mapPrefetched.emplace(outpoint, std::move(coin));
+            stats.nFetched++;
+        } else {
+            stats.nDiscarded++;
+        }
+        condFetched.notify_all();
+    }
+}
+
+bool CCoinsViewPrefetch::GetCoin(const COutPoint &outpoint, Coin &coin) const
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        // reading it here is faster than waiting for its turn in the queue
+        if (!setQueued.erase(outpoint)) {
+            bool fWaited = false;
+            while (setFetching.count(outpoint)) {
+                fWaited = true;
+                condFetched.wait(lock);
+            }
+            std::unordered_map<COutPoint, Coin, SaltedOutpointHasher>::iterator it = mapPrefetched.find(outpoint);
+            if (it != mapPrefetched.end()) {
+                coin = std::move(it->second);
+                mapPrefetched.erase(it);
+                stats.nHits++;
+                if (fWaited)
+                    stats.nWaits++;
+                return !coin.IsSpent();
+            }
+        }
+        stats.nMisses++;
+    }
+    return base->GetCoin(outpoint, coin);
+}
+
+bool CCoinsViewPrefetch::HaveCoin(const COutPoint &outpoint) const
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        std::unordered_map<COutPoint, Coin, SaltedOutpointHasher>::const_iterator it = mapPrefetched.find(outpoint);
+        if (it != mapPrefetched.end())
+            return !it->second.IsSpent();
+    }
+    return base->HaveCoin(outpoint);
+}
+
+void CCoinsViewPrefetch::DiscardPrefetched()
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    nGeneration++;
+    stats.nDiscarded += mapPrefetched.size();
+    mapPrefetched.clear();
+}
+
+void CCoinsViewPrefetch::DiscardPrefetched(const std::vector<COutPoint>& vOutpoints)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    // reads in progress may be of any of them
+    nGeneration++;
+    BOOST_FOREACH(const COutPoint& outpoint, vOutpoints)
+        stats.nDiscarded += mapPrefetched.erase(outpoint);
+}
+
+bool CCoinsViewPrefetch::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock)
+{
+    // Coins read before or during the write may be outdated by it
+    DiscardPrefetched();
+    bool ret = base->BatchWrite(mapCoins, hashBlock);
+    DiscardPrefetched();
+    return ret;
+}
+
+bool CCoinsViewPrefetch::BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock)
+{
+    // Only the coins written may be outdated, the others are kept
+    std::vector<COutPoint> vWritten;
+    vWritten.reserve(mapCoins.size());
+    for (CCoinsMap::const_iterator it = mapCoins.begin(); it != mapCoins.end(); ++it)
+        vWritten.push_back(it->first);
+    DiscardPrefetched(vWritten);
+    bool ret = base->BatchWritePartial(mapCoins, hashBlock);
+    DiscardPrefetched(vWritten);
+    return ret;
+}
+
+void CCoinsViewPrefetch::Prefetch(const std::vector<COutPoint>& vOutpoints)
+{
+    if (vOutpoints.empty())
+        return;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        BOOST_FOREACH(const COutPoint& outpoint, vOutpoints) {
+            if (setQueued.count(outpoint) || setFetching.count(outpoint) || mapPrefetched.count(outpoint))
+                continue;
+            setQueued.insert(outpoint);
+            queueOutpoints.push_back(outpoint);
+            stats.nQueued++;
+        }
+    }
+    condWork.notify_all();
+}
+
+void CCoinsViewPrefetch::Discard(const std::vector<COutPoint>& vOutpoints)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    BOOST_FOREACH(const COutPoint& outpoint, vOutpoints) {
+        setQueued.erase(outpoint);
+        stats.nDiscarded += mapPrefetched.erase(outpoint);
+    }
+}
+
+CCoinsPrefetchStats CCoinsViewPrefetch::GetStats() const
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return stats;
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COINSPREFETCH_H
+#define BITCOIN_COINSPREFETCH_H
+
+#include "coins.h"
+
+#include <stdint.h>
+
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+/** -utxoprefetch default, the number of threads reading coins ahead of ConnectBlock */
+static const int DEFAULT_UTXO_PREFETCH_THREADS = 4;
+/** Maximum number of prefetch threads */
+static const int MAX_UTXO_PREFETCH_THREADS = 16;
+/** Coins held for lookups that are yet to come, further reads are dropped */
+static const unsigned int MAX_PREFETCHED_COINS = 200000;
+
+/** Lookups served by a CCoinsViewPrefetch so far */
+struct CCoinsPrefetchStats
+{
+    //! Outpoints queued for reading
+    uint64_t nQueued;
+    //! Coins read by the prefetch threads
+    uint64_t nFetched;
+    //! Lookups served by a prefetched coin
+    uint64_t nHits;
+    //! Of the hits, those that waited for the read to finish
+    uint64_t nWaits;
+    //! Lookups that read from the backing view themselves
+    uint64_t nMisses;
+    //! Prefetched coins dropped without being looked up
+    uint64_t nDiscarded;
+    //! Summed over the prefetch threads
+    int64_t nFetchMicros;
+
+    CCoinsPrefetchStats() : nQueued(0), nFetched(0), nHits(0), nWaits(0), nMisses(0),
+        nDiscarded(0), nFetchMicros(0) {}
+};
+
+/**
+ * CCoinsView that reads the coins of queued outpoints from its backing view
+ * with a pool of threads, so that a cache on top of it finds them in memory
+ * once it looks them up. Each prefetched coin serves a single lookup.
+ *
+ * The backing view has to allow concurrent reads, as CCoinsViewDB does, and
+ * must only be written through this view.
+ */
+class CCoinsViewPrefetch : public CCoinsViewBacked
+{
+private:
+    mutable boost::mutex mutex;
+    //! Signalled when outpoints are queued
+    mutable boost::condition_variable condWork;
+    //! Signalled when a read finished
+    mutable boost::condition_variable condFetched;
+
+    mutable std::deque<COutPoint> queueOutpoints;
+    //! Queued outpoints nobody started reading yet
+    mutable std::unordered_set<COutPoint, SaltedOutpointHasher> setQueued;
+    //! Outpoints being read by a prefetch thread
+    mutable std::unordered_set<COutPoint, SaltedOutpointHasher> setFetching;
+    mutable std::unordered_map<COutPoint, Coin, SaltedOutpointHasher> mapPrefetched;
+    //! Changes on every write, reads that started before are dropped
+    uint64_t nGeneration;
+    bool fStop;
+    mutable CCoinsPrefetchStats stats;
+
+    boost::thread_group threads;
+
+    CCoinsViewPrefetch(const CCoinsViewPrefetch&);
+    CCoinsViewPrefetch& operator=(const CCoinsViewPrefetch&);
+
+    void ThreadPrefetch();
+    void DiscardPrefetched();
+    void DiscardPrefetched(const std::vector<COutPoint>& vOutpoints);
+
+public:
+    CCoinsViewPrefetch(CCoinsView* viewIn, int nThreads);
+    ~CCoinsViewPrefetch();
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+
+    /** Queue outpoints to be read, unless they are already */
+    void Prefetch(const std::vector<COutPoint>& vOutpoints);
+    /** Drop what is prefetched or queued for outpoints nobody is going to look up */
+    void Discard(const std::vector<COutPoint>& vOutpoints);
+
+    CCoinsPrefetchStats GetStats() const;
+};
+
+#endif // BITCOIN_COINSPREFETCH_H
@@ -93,8 +93,14 @@ typedef u_int SOCKET;
 size_t strnlen( const char *start, size_t max_len);
 #endif // HAVE_DECL_STRNLEN
 
+// Wait for socket readiness with epoll and poll where available, they are not
+// limited to descriptors below FD_SETSIZE like select
+#ifdef HAVE_SYS_EPOLL_H
+#define USE_EPOLL
+#endif
+
 bool static inline IsSelectableSocket(SOCKET s) {
-#ifdef WIN32
+#if defined(WIN32) || defined(USE_EPOLL)
     return true;
 #else
     return (s < FD_SETSIZE);
@@ -0,0 +1,2764 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "crypto/phichox.h"
+
+#include "crypto/common.h"
+#include "crypto/sph_bmw.h"
+#include "crypto/sph_groestl.h"
+#include "crypto/sph_jh.h"
+#include "crypto/sph_keccak.h"
+#include "crypto/sph_skein.h"
+#include "crypto/sph_luffa.h"
+#include "crypto/sph_cubehash.h"
+#include "crypto/sph_shavite.h"
+#include "crypto/sph_simd.h"
+#include "crypto/sph_echo.h"
+#include "crypto/sph_hamsi.h"
+#include "crypto/sph_fugue.h"
+#include "crypto/sph_shabal.h"
+#include "crypto/sph_whirlpool.h"
+#include "crypto/sph_sha2.h"
+#include "crypto/sph_haval.h"
+
+#include <string.h>
+
+#if defined(ENABLE_AVX2)
+#include <cpuid.h>
+
+namespace phichox_avx2
+{
+void Blake512_80(unsigned char* out, const unsigned char* in);
+void Skein512_64(unsigned char* out, const unsigned char* in);
+void Keccak512_64(unsigned char* out, const unsigned char* in);
+}
+#endif
+
+// Internal implementation code.
+namespace
+{
+/// The chains following the initial blake512 round, one per branch, each
+/// taking the 64-byte blake512 output as input.
+/// Intermediate buffers start zeroed: haval256 only fills the first half of
+/// its 64-byte slot, and the next round hashes the full 64 bytes.
+namespace phichox
+{
+
+static const uint32_t PHASE2_TIME = 1644451200;
+static const uint32_t PHASE3_TIME = 1646118000;
+
+/** nTime < PHASE2_TIME */
+void Phase1(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[33][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    memcpy(output, hash[32], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '0' */
+void Phase2Digit0(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[34][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[32]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[33]));
+    memcpy(output, hash[33], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '1' */
+void Phase2Digit1(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[35][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[32]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[33]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[33]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[34]));
+    memcpy(output, hash[34], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '2' */
+void Phase2Digit2(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[36][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[32]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[33]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[33]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[34]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[34]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[35]));
+    memcpy(output, hash[35], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '3' */
+void Phase2Digit3(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[37][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[32]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[33]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[33]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[34]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[34]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[35]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[35]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[36]));
+    memcpy(output, hash[36], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '4' */
+void Phase2Digit4(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[38][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[32]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[33]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[33]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[34]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[34]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[35]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[35]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[36]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[36]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[37]));
+    memcpy(output, hash[37], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '5' */
+void Phase2Digit5(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[39][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[32]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[33]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[33]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[34]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[34]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[35]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[35]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[36]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[36]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[37]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[37]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[38]));
+    memcpy(output, hash[38], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '6' */
+void Phase2Digit6(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[40][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[32]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[33]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[33]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[34]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[34]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[35]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[35]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[36]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[36]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[37]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[37]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[38]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[38]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[39]));
+    memcpy(output, hash[39], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '7' */
+void Phase2Digit7(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[41][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[32]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[33]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[33]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[34]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[34]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[35]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[35]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[36]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[36]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[37]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[37]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[38]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[38]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[39]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[39]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[40]));
+    memcpy(output, hash[40], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '8' */
+void Phase2Digit8(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[42][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[32]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[33]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[33]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[34]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[34]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[35]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[35]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[36]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[36]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[37]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[37]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[38]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[38]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[39]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[39]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[40]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[40]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[41]));
+    memcpy(output, hash[41], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in '9' */
+void Phase2Digit9(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[43][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[32]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[33]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[33]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[34]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[34]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[35]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[35]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[36]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[36]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[37]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[37]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[38]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[38]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[39]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[39]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[40]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[40]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[41]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[41]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[42]));
+    memcpy(output, hash[42], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in 'a' */
+void Phase2DigitA(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[44][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[32]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[33]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[33]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[34]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[34]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[35]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[35]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[36]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[36]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[37]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[37]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[38]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[38]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[39]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[39]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[40]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[40]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[41]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[41]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[42]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[42]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[43]));
+    memcpy(output, hash[43], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in 'b' */
+void Phase2DigitB(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[45][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[32]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[33]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[33]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[34]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[34]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[35]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[35]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[36]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[36]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[37]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[37]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[38]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[38]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[39]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[39]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[40]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[40]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[41]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[41]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[42]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[42]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[43]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[43]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[44]));
+    memcpy(output, hash[44], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in 'c' */
+void Phase2DigitC(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[46][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[32]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[33]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[33]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[34]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[34]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[35]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[35]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[36]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[36]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[37]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[37]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[38]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[38]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[39]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[39]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[40]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[40]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[41]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[41]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[42]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[42]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[43]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[43]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[44]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[44]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[45]));
+    memcpy(output, hash[45], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in 'd' */
+void Phase2DigitD(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[47][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[32]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[33]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[33]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[34]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[34]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[35]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[35]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[36]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[36]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[37]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[37]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[38]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[38]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[39]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[39]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[40]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[40]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[41]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[41]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[42]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[42]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[43]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[43]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[44]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[44]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[45]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[45]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[46]));
+    memcpy(output, hash[46], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in 'e' */
+void Phase2DigitE(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[48][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[32]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[33]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[33]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[34]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[34]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[35]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[35]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[36]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[36]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[37]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[37]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[38]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[38]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[39]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[39]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[40]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[40]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[41]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[41]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[42]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[42]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[43]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[43]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[44]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[44]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[45]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[45]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[46]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[46]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[47]));
+    memcpy(output, hash[47], 32);
+}
+
+/** PHASE2_TIME <= nTime < PHASE3_TIME, hashPrevBlock ending in 'f' */
+void Phase2DigitF(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+    sph_hamsi512_context     ctx_hamsi;
+    sph_fugue512_context     ctx_fugue;
+    sph_shabal512_context    ctx_shabal;
+    sph_whirlpool_context    ctx_whirlpool;
+    sph_sha512_context       ctx_sha2;
+    sph_haval256_5_context   ctx_haval;
+
+    unsigned char hash[49][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[0]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[1]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[1]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[2]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[2]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[4]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[5]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[5]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[7]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[8]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[8]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[10]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[11]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[11]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[12]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[12]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[13]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[13]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[14]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[14]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[15]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[15]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[16]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[16]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[17]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[17]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[18]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[18]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[19]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[19]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[20]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[20]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[21]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[21]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[22]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[22]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[23]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[23]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[24]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[24]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[25]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[25]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[26]));
+    sph_hamsi512_init(&ctx_hamsi);
+    sph_hamsi512 (&ctx_hamsi, static_cast<const void*>(&hash[26]), 64);
+    sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[27]));
+    sph_fugue512_init(&ctx_fugue);
+    sph_fugue512 (&ctx_fugue, static_cast<const void*>(&hash[27]), 64);
+    sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[28]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[28]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[29]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[29]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[30]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[30]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[31]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[31]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[32]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[32]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[33]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[33]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[34]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[34]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[35]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[35]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[36]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[36]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[37]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[37]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[38]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[38]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[39]));
+    sph_shabal512_init(&ctx_shabal);
+    sph_shabal512 (&ctx_shabal, static_cast<const void*>(&hash[39]), 64);
+    sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[40]));
+    sph_whirlpool_init(&ctx_whirlpool);
+    sph_whirlpool (&ctx_whirlpool, static_cast<const void*>(&hash[40]), 64);
+    sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[41]));
+    sph_sha512_init(&ctx_sha2);
+    sph_sha512 (&ctx_sha2, static_cast<const void*>(&hash[41]), 64);
+    sph_sha512_close(&ctx_sha2, static_cast<void*>(&hash[42]));
+    sph_haval256_5_init(&ctx_haval);
+    sph_haval256_5 (&ctx_haval, static_cast<const void*>(&hash[42]), 64);
+    sph_haval256_5_close(&ctx_haval, static_cast<void*>(&hash[43]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[43]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[44]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[44]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[45]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[45]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[46]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[46]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[47]));
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[47]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[48]));
+    memcpy(output, hash[48], 32);
+}
+
+/** nTime >= PHASE3_TIME */
+void Phase3(const unsigned char* input, unsigned char output[32])
+{
+    sph_bmw512_context       ctx_bmw;
+    sph_groestl512_context   ctx_groestl;
+    sph_jh512_context        ctx_jh;
+    sph_keccak512_context    ctx_keccak;
+    sph_skein512_context     ctx_skein;
+    sph_luffa512_context     ctx_luffa;
+    sph_cubehash512_context  ctx_cubehash;
+    sph_shavite512_context   ctx_shavite;
+    sph_simd512_context      ctx_simd;
+    sph_echo512_context      ctx_echo;
+
+    unsigned char hash[11][64] = {};
+    memcpy(hash[0], input, 64);
+    sph_skein512_init(&ctx_skein);
+    sph_skein512 (&ctx_skein, static_cast<const void*>(&hash[0]), 64);
+    sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[1]));
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512 (&ctx_bmw, static_cast<const void*>(&hash[1]), 64);
+    sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[2]));
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512 (&ctx_groestl, static_cast<const void*>(&hash[2]), 64);
+    sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[3]));
+    sph_jh512_init(&ctx_jh);
+    sph_jh512 (&ctx_jh, static_cast<const void*>(&hash[3]), 64);
+    sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[4]));
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512 (&ctx_luffa, static_cast<void*>(&hash[4]), 64);
+    sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[5]));
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512 (&ctx_keccak, static_cast<const void*>(&hash[5]), 64);
+    sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[6]));
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512 (&ctx_cubehash, static_cast<const void*>(&hash[6]), 64);
+    sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[7]));
+    sph_simd512_init(&ctx_simd);
+    sph_simd512 (&ctx_simd, static_cast<const void*>(&hash[7]), 64);
+    sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[8]));
+    sph_shavite512_init(&ctx_shavite);
+    sph_shavite512(&ctx_shavite, static_cast<const void*>(&hash[8]), 64);
+    sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[9]));
+    sph_echo512_init(&ctx_echo);
+    sph_echo512 (&ctx_echo, static_cast<const void*>(&hash[9]), 64);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[10]));
+    memcpy(output, hash[10], 32);
+}
+
+typedef void (*ChainFunc)(const unsigned char* input, unsigned char output[32]);
+
+const ChainFunc phase2[16] = {
+    Phase2Digit0, Phase2Digit1, Phase2Digit2, Phase2Digit3,
+    Phase2Digit4, Phase2Digit5, Phase2Digit6, Phase2Digit7,
+    Phase2Digit8, Phase2Digit9, Phase2DigitA, Phase2DigitB,
+    Phase2DigitC, Phase2DigitD, Phase2DigitE, Phase2DigitF,
+};
+
+ChainFunc SelectChain(uint32_t nTime, unsigned char nPrevBlockNibble)
+{
+    if (nTime >= PHASE3_TIME)
+        return Phase3;
+    if (nTime >= PHASE2_TIME)
+        return phase2[nPrevBlockNibble & 0x0f];
+    return Phase1;
+}
+
+/** 4-way kernels, set by PhiCHOXAutoDetect() when the CPU supports them */
+typedef void (*Batch4Func)(unsigned char* out, const unsigned char* in);
+Batch4Func Blake512_80x4 = nullptr;
+Batch4Func Skein512_64x4 = nullptr;
+Batch4Func Keccak512_64x4 = nullptr;
+
+void Bmw512(const unsigned char* in, unsigned char* out)
+{
+    sph_bmw512_context ctx;
+    sph_bmw512_init(&ctx);
+    sph_bmw512(&ctx, in, 64);
+    sph_bmw512_close(&ctx, out);
+}
+
+void Groestl512(const unsigned char* in, unsigned char* out)
+{
+    sph_groestl512_context ctx;
+    sph_groestl512_init(&ctx);
+    sph_groestl512(&ctx, in, 64);
+    sph_groestl512_close(&ctx, out);
+}
+
+void Jh512(const unsigned char* in, unsigned char* out)
+{
+    sph_jh512_context ctx;
+    sph_jh512_init(&ctx);
+    sph_jh512(&ctx, in, 64);
+    sph_jh512_close(&ctx, out);
+}
+
+void Luffa512(const unsigned char* in, unsigned char* out)
+{
+    sph_luffa512_context ctx;
+    sph_luffa512_init(&ctx);
+    sph_luffa512(&ctx, in, 64);
+    sph_luffa512_close(&ctx, out);
+}
+
+void Cubehash512(const unsigned char* in, unsigned char* out)
+{
+    sph_cubehash512_context ctx;
+    sph_cubehash512_init(&ctx);
+    sph_cubehash512(&ctx, in, 64);
+    sph_cubehash512_close(&ctx, out);
+}
+
+void Simd512(const unsigned char* in, unsigned char* out)
+{
+    sph_simd512_context ctx;
+    sph_simd512_init(&ctx);
+    sph_simd512(&ctx, in, 64);
+    sph_simd512_close(&ctx, out);
+}
+
+void Shavite512(const unsigned char* in, unsigned char* out)
+{
+    sph_shavite512_context ctx;
+    sph_shavite512_init(&ctx);
+    sph_shavite512(&ctx, in, 64);
+    sph_shavite512_close(&ctx, out);
+}
+
+void Echo512(const unsigned char* in, unsigned char* out)
+{
+    sph_echo512_context ctx;
+    sph_echo512_init(&ctx);
+    sph_echo512(&ctx, in, 64);
+    sph_echo512_close(&ctx, out);
+}
+
+/** Phase3 over four 80-byte headers, with the vectorised rounds running all four lanes at once */
+void Phase3x4(const unsigned char* headers, unsigned char* output)
+{
+    unsigned char a[4 * 64], b[4 * 64], c[64];
+
+    Blake512_80x4(a, headers);
+    Skein512_64x4(b, a);
+    for (int i = 0; i < 4; i++) {
+        Bmw512(b + 64 * i, a + 64 * i);
+        Groestl512(a + 64 * i, b + 64 * i);
+        Jh512(b + 64 * i, a + 64 * i);
+        Luffa512(a + 64 * i, b + 64 * i);
+    }
+    Keccak512_64x4(a, b);
+    for (int i = 0; i < 4; i++) {
+        Cubehash512(a + 64 * i, b + 64 * i);
+        Simd512(b + 64 * i, a + 64 * i);
+        Shavite512(a + 64 * i, b + 64 * i);
+        Echo512(b + 64 * i, c);
+        memcpy(output + 32 * i, c, 32);
+    }
+}
+
+#if defined(ENABLE_AVX2)
+bool AVX2Enabled()
+{
+    uint32_t eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    // OSXSAVE and AVX, then check that the OS saves the YMM registers
+    if ((ecx & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28)))
+        return false;
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 6) != 6)
+        return false;
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 5)) != 0;
+}
+#endif
+
+} // namespace phichox
+
+} // namespace
+
+CPhiCHOX::CPhiCHOX(uint32_t nTime, unsigned char nPrevBlockNibble) : chain(phichox::SelectChain(nTime, nPrevBlockNibble))
+{
+    Reset();
+}
+
+CPhiCHOX& CPhiCHOX::Write(const unsigned char* data, size_t len)
+{
+    sph_blake512(&ctx_blake, data, len);
+    return *this;
+}
+
+void CPhiCHOX::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    unsigned char buf[64];
+    sph_blake512_close(&ctx_blake, buf);
+    chain(buf, hash);
+}
+
+CPhiCHOX& CPhiCHOX::Reset()
+{
+    sph_blake512_init(&ctx_blake);
+    return *this;
+}
+
+std::string PhiCHOXAutoDetect()
+{
+#if defined(ENABLE_AVX2)
+    if (phichox::AVX2Enabled()) {
+        phichox::Blake512_80x4 = phichox_avx2::Blake512_80;
+        phichox::Skein512_64x4 = phichox_avx2::Skein512_64;
+        phichox::Keccak512_64x4 = phichox_avx2::Keccak512_64;
+        return "avx2(4way)";
+    }
+#endif
+    return "standard";
+}
+
+void PhiCHOXHeaders(unsigned char* output, const unsigned char* headers, size_t nHeaders)
+{
+    size_t i = 0;
+    if (phichox::Blake512_80x4) {
+        for (; i + 4 <= nHeaders; i += 4) {
+            const unsigned char* in = headers + 80 * i;
+            phichox::ChainFunc chains[4];
+            bool fAllPhase3 = true;
+            for (int j = 0; j < 4; j++) {
+                chains[j] = phichox::SelectChain(ReadLE32(in + 80 * j + 68), in[80 * j + 4]);
+                fAllPhase3 &= (chains[j] == phichox::Phase3);
+            }
+            if (fAllPhase3) {
+                phichox::Phase3x4(in, output + 32 * i);
+                continue;
+            }
+            // Mixed branches still share the initial blake512 round
+            unsigned char hash0[4 * 64];
+            phichox::Blake512_80x4(hash0, in);
+            for (int j = 0; j < 4; j++)
+                chains[j](hash0 + 64 * j, output + 32 * (i + j));
+        }
+    }
+    for (; i < nHeaders; i++) {
+        const unsigned char* in = headers + 80 * i;
+        CPhiCHOX(ReadLE32(in + 68), in[4]).Write(in, 80).Finalize(output + 32 * i);
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_PHICHOX_H
+#define BITCOIN_CRYPTO_PHICHOX_H
+
+#include "crypto/sph_blake.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+/** A hasher class for the phiCHOX proof-of-work chain.
+ *
+ * Every branch of the chain starts with blake512 over the input, and which
+ * branch follows is fixed by the block time and the low nibble of the first
+ * byte of hashPrevBlock (the last character of its hex string). The branch is
+ * resolved once on construction, so a copy taken after writing a common prefix
+ * can be reused as a midstate for inputs that only differ in their tail.
+ */
+class CPhiCHOX
+{
+private:
+    typedef void (*ChainFunc)(const unsigned char* input, unsigned char output[32]);
+
+    sph_blake512_context ctx_blake;
+    ChainFunc chain;
+
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    CPhiCHOX(uint32_t nTime, unsigned char nPrevBlockNibble);
+    CPhiCHOX& Write(const unsigned char* data, size_t len);
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+    CPhiCHOX& Reset();
+};
+
+/** Autodetect the best available multi-lane phiCHOX kernels, returns the name of the implementation */
+std::string PhiCHOXAutoDetect();
+
+/**
+ * Compute the phiCHOX hash of nHeaders serialized 80-byte block headers,
+ * writing 32 bytes per header to output. The branch of each header is taken
+ * from its own nTime and hashPrevBlock fields. Groups of four headers go
+ * through the vectorised kernels selected by PhiCHOXAutoDetect(), if any.
+ */
+void PhiCHOXHeaders(unsigned char* output, const unsigned char* headers, size_t nHeaders);
+
+#endif // BITCOIN_CRYPTO_PHICHOX_H
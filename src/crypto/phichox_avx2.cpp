@@ -0,0 +1,330 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 4-way AVX2 kernels for the phiCHOX chain. Each 256-bit register holds the
+// same 64-bit state word for four independent messages, so one pass through
+// the round function advances all four hashes. Only built with -mavx2 and
+// only called after PhiCHOXAutoDetect() found AVX2 support at runtime.
+
+#include "crypto/common.h"
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace phichox_avx2 {
+
+namespace {
+
+inline __m256i RotR(__m256i x, int n) { return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n)); }
+inline __m256i RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+inline __m256i RotR32(__m256i x) { return _mm256_shuffle_epi32(x, 0xB1); }
+inline __m256i Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+inline __m256i Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+inline __m256i Set(uint64_t x) { return _mm256_set1_epi64x(x); }
+
+/** Gather the 64-bit word at byte offset pos of each of four messages of stride len */
+inline __m256i LoadBE(const unsigned char* in, size_t len, size_t pos)
+{
+    return _mm256_set_epi64x(ReadBE64(in + 3 * len + pos), ReadBE64(in + 2 * len + pos), ReadBE64(in + len + pos), ReadBE64(in + pos));
+}
+
+inline __m256i LoadLE(const unsigned char* in, size_t len, size_t pos)
+{
+    return _mm256_set_epi64x(ReadLE64(in + 3 * len + pos), ReadLE64(in + 2 * len + pos), ReadLE64(in + len + pos), ReadLE64(in + pos));
+}
+
+inline void StoreBE(unsigned char* out, size_t len, size_t pos, __m256i x)
+{
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, x);
+    for (int i = 0; i < 4; i++)
+        WriteBE64(out + i * len + pos, lanes[i]);
+}
+
+inline void StoreLE(unsigned char* out, size_t len, size_t pos, __m256i x)
+{
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, x);
+    for (int i = 0; i < 4; i++)
+        WriteLE64(out + i * len + pos, lanes[i]);
+}
+
+namespace blake512 {
+
+const uint64_t IV[8] = {
+    0x6A09E667F3BCC908ull, 0xBB67AE8584CAA73Bull, 0x3C6EF372FE94F82Bull, 0xA54FF53A5F1D36F1ull,
+    0x510E527FADE682D1ull, 0x9B05688C2B3E6C1Full, 0x1F83D9ABFB41BD6Bull, 0x5BE0CD19137E2179ull,
+};
+
+const uint64_t C[16] = {
+    0x243F6A8885A308D3ull, 0x13198A2E03707344ull, 0xA4093822299F31D0ull, 0x082EFA98EC4E6C89ull,
+    0x452821E638D01377ull, 0xBE5466CF34E90C6Cull, 0xC0AC29B7C97C50DDull, 0x3F84D5B5B5470917ull,
+    0x9216D5D98979FB1Bull, 0xD1310BA698DFB5ACull, 0x2FFD72DBD01ADFB7ull, 0xB8E1AFED6A267E96ull,
+    0xBA7C9045F12C7F99ull, 0x24A19947B3916CF7ull, 0x0801F2E2858EFC16ull, 0x636920D871574E69ull,
+};
+
+const unsigned char SIGMA[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0},
+};
+
+inline void G(__m256i* v, const __m256i* m, int r, int i, int a, int b, int c, int d)
+{
+    const unsigned char* s = SIGMA[r % 10];
+    v[a] = Add(Add(v[a], v[b]), Xor(m[s[2 * i]], Set(C[s[2 * i + 1]])));
+    v[d] = RotR32(Xor(v[d], v[a]));
+    v[c] = Add(v[c], v[d]);
+    v[b] = RotR(Xor(v[b], v[c]), 25);
+    v[a] = Add(Add(v[a], v[b]), Xor(m[s[2 * i + 1]], Set(C[s[2 * i]])));
+    v[d] = RotR(Xor(v[d], v[a]), 16);
+    v[c] = Add(v[c], v[d]);
+    v[b] = RotR(Xor(v[b], v[c]), 11);
+}
+
+} // namespace blake512
+
+namespace keccak512 {
+
+const uint64_t RC[24] = {
+    0x0000000000000001ull, 0x0000000000008082ull, 0x800000000000808Aull, 0x8000000080008000ull,
+    0x000000000000808Bull, 0x0000000080000001ull, 0x8000000080008081ull, 0x8000000000008009ull,
+    0x000000000000008Aull, 0x0000000000000088ull, 0x0000000080008009ull, 0x000000008000000Aull,
+    0x000000008000808Bull, 0x800000000000008Bull, 0x8000000000008089ull, 0x8000000000008003ull,
+    0x8000000000008002ull, 0x8000000000000080ull, 0x000000000000800Aull, 0x800000008000000Aull,
+    0x8000000080008081ull, 0x8000000000008080ull, 0x0000000080000001ull, 0x8000000080008008ull,
+};
+
+void Permute(__m256i* a)
+{
+    __m256i b[25], c[5], d[5];
+    for (int round = 0; round < 24; round++) {
+        // theta
+        c[0] = Xor(Xor(Xor(a[0], a[5]), Xor(a[10], a[15])), a[20]);
+        c[1] = Xor(Xor(Xor(a[1], a[6]), Xor(a[11], a[16])), a[21]);
+        c[2] = Xor(Xor(Xor(a[2], a[7]), Xor(a[12], a[17])), a[22]);
+        c[3] = Xor(Xor(Xor(a[3], a[8]), Xor(a[13], a[18])), a[23]);
+        c[4] = Xor(Xor(Xor(a[4], a[9]), Xor(a[14], a[19])), a[24]);
+        d[0] = Xor(c[4], RotL(c[1], 1));
+        d[1] = Xor(c[0], RotL(c[2], 1));
+        d[2] = Xor(c[1], RotL(c[3], 1));
+        d[3] = Xor(c[2], RotL(c[4], 1));
+        d[4] = Xor(c[3], RotL(c[0], 1));
+        // rho and pi
+        b[0] = Xor(a[0], d[0]);
+        b[16] = RotL(Xor(a[5], d[0]), 36);
+        b[7] = RotL(Xor(a[10], d[0]), 3);
+        b[23] = RotL(Xor(a[15], d[0]), 41);
+        b[14] = RotL(Xor(a[20], d[0]), 18);
+        b[10] = RotL(Xor(a[1], d[1]), 1);
+        b[1] = RotL(Xor(a[6], d[1]), 44);
+        b[17] = RotL(Xor(a[11], d[1]), 10);
+        b[8] = RotL(Xor(a[16], d[1]), 45);
+        b[24] = RotL(Xor(a[21], d[1]), 2);
+        b[20] = RotL(Xor(a[2], d[2]), 62);
+        b[11] = RotL(Xor(a[7], d[2]), 6);
+        b[2] = RotL(Xor(a[12], d[2]), 43);
+        b[18] = RotL(Xor(a[17], d[2]), 15);
+        b[9] = RotL(Xor(a[22], d[2]), 61);
+        b[5] = RotL(Xor(a[3], d[3]), 28);
+        b[21] = RotL(Xor(a[8], d[3]), 55);
+        b[12] = RotL(Xor(a[13], d[3]), 25);
+        b[3] = RotL(Xor(a[18], d[3]), 21);
+        b[19] = RotL(Xor(a[23], d[3]), 56);
+        b[15] = RotL(Xor(a[4], d[4]), 27);
+        b[6] = RotL(Xor(a[9], d[4]), 20);
+        b[22] = RotL(Xor(a[14], d[4]), 39);
+        b[13] = RotL(Xor(a[19], d[4]), 8);
+        b[4] = RotL(Xor(a[24], d[4]), 14);
+        // chi
+        a[0] = Xor(b[0], _mm256_andnot_si256(b[1], b[2]));
+        a[1] = Xor(b[1], _mm256_andnot_si256(b[2], b[3]));
+        a[2] = Xor(b[2], _mm256_andnot_si256(b[3], b[4]));
+        a[3] = Xor(b[3], _mm256_andnot_si256(b[4], b[0]));
+        a[4] = Xor(b[4], _mm256_andnot_si256(b[0], b[1]));
+        a[5] = Xor(b[5], _mm256_andnot_si256(b[6], b[7]));
+        a[6] = Xor(b[6], _mm256_andnot_si256(b[7], b[8]));
+        a[7] = Xor(b[7], _mm256_andnot_si256(b[8], b[9]));
+        a[8] = Xor(b[8], _mm256_andnot_si256(b[9], b[5]));
+        a[9] = Xor(b[9], _mm256_andnot_si256(b[5], b[6]));
+        a[10] = Xor(b[10], _mm256_andnot_si256(b[11], b[12]));
+        a[11] = Xor(b[11], _mm256_andnot_si256(b[12], b[13]));
+        a[12] = Xor(b[12], _mm256_andnot_si256(b[13], b[14]));
+        a[13] = Xor(b[13], _mm256_andnot_si256(b[14], b[10]));
+        a[14] = Xor(b[14], _mm256_andnot_si256(b[10], b[11]));
+        a[15] = Xor(b[15], _mm256_andnot_si256(b[16], b[17]));
+        a[16] = Xor(b[16], _mm256_andnot_si256(b[17], b[18]));
+        a[17] = Xor(b[17], _mm256_andnot_si256(b[18], b[19]));
+        a[18] = Xor(b[18], _mm256_andnot_si256(b[19], b[15]));
+        a[19] = Xor(b[19], _mm256_andnot_si256(b[15], b[16]));
+        a[20] = Xor(b[20], _mm256_andnot_si256(b[21], b[22]));
+        a[21] = Xor(b[21], _mm256_andnot_si256(b[22], b[23]));
+        a[22] = Xor(b[22], _mm256_andnot_si256(b[23], b[24]));
+        a[23] = Xor(b[23], _mm256_andnot_si256(b[24], b[20]));
+        a[24] = Xor(b[24], _mm256_andnot_si256(b[20], b[21]));
+        // iota
+        a[0] = Xor(a[0], Set(RC[round]));
+    }
+}
+
+} // namespace keccak512
+
+namespace skein512 {
+
+/** Chaining value after the configuration block of Skein-512-512 */
+const uint64_t IV[8] = {
+    0x4903ADFF749C51CEull, 0x0D95DE399746DF03ull, 0x8FD1934127C79BCEull, 0x9A255629FF352CB1ull,
+    0x5DB62599DF6CA7B0ull, 0xEABE394CA9D5C3F4ull, 0x991112C71A75B523ull, 0xAE18A40B660FCC33ull,
+};
+
+const uint64_t T_FIRST = 1ull << 62;
+const uint64_t T_FINAL = 1ull << 63;
+const uint64_t T_MSG = 48ull << 56;
+const uint64_t T_OUT = 63ull << 56;
+
+inline void Mix(__m256i& a, __m256i& b, int r)
+{
+    a = Add(a, b);
+    b = Xor(RotL(b, r), a);
+}
+
+/** Subkey injection s, before rounds 4 * s */
+inline void Inject(__m256i* v, const __m256i* k, const uint64_t* t, int s)
+{
+    for (int i = 0; i < 8; i++)
+        v[i] = Add(v[i], k[(s + i) % 9]);
+    v[5] = Add(v[5], Set(t[s % 3]));
+    v[6] = Add(v[6], Set(t[(s + 1) % 3]));
+    v[7] = Add(v[7], Set(s));
+}
+
+/** One UBI block: Threefish-512 of x keyed with h and tweak (t0, t1), fed forward into x */
+void UBI(__m256i* h, const __m256i* x, uint64_t t0, uint64_t t1)
+{
+    __m256i k[9];
+    k[8] = Set(0x1BD11BDAA9FC1A22ull);
+    for (int i = 0; i < 8; i++) {
+        k[i] = h[i];
+        k[8] = Xor(k[8], h[i]);
+    }
+    const uint64_t t[3] = {t0, t1, t0 ^ t1};
+
+    // Eight rounds per iteration; the word permutation is folded into the
+    // choice of Mix operands instead of moving the state around
+    __m256i v[8];
+    for (int i = 0; i < 8; i++)
+        v[i] = x[i];
+    for (int s = 0; s < 18; s += 2) {
+        Inject(v, k, t, s);
+        Mix(v[0], v[1], 46); Mix(v[2], v[3], 36); Mix(v[4], v[5], 19); Mix(v[6], v[7], 37);
+        Mix(v[2], v[1], 33); Mix(v[4], v[7], 27); Mix(v[6], v[5], 14); Mix(v[0], v[3], 42);
+        Mix(v[4], v[1], 17); Mix(v[6], v[3], 49); Mix(v[0], v[5], 36); Mix(v[2], v[7], 39);
+        Mix(v[6], v[1], 44); Mix(v[0], v[7],  9); Mix(v[2], v[5], 54); Mix(v[4], v[3], 56);
+        Inject(v, k, t, s + 1);
+        Mix(v[0], v[1], 39); Mix(v[2], v[3], 30); Mix(v[4], v[5], 34); Mix(v[6], v[7], 24);
+        Mix(v[2], v[1], 13); Mix(v[4], v[7], 50); Mix(v[6], v[5], 10); Mix(v[0], v[3], 17);
+        Mix(v[4], v[1], 25); Mix(v[6], v[3], 29); Mix(v[0], v[5], 39); Mix(v[2], v[7], 43);
+        Mix(v[6], v[1],  8); Mix(v[0], v[7], 35); Mix(v[2], v[5], 56); Mix(v[4], v[3], 22);
+    }
+    Inject(v, k, t, 18);
+
+    for (int i = 0; i < 8; i++)
+        h[i] = Xor(v[i], x[i]);
+}
+
+} // namespace skein512
+
+} // namespace
+
+void Blake512_80(unsigned char* out, const unsigned char* in)
+{
+    using namespace blake512;
+
+    // A single padded block: 80 message bytes, 0x80, zeros, 0x01 and the
+    // 128-bit big-endian bit length
+    __m256i m[16];
+    for (int i = 0; i < 10; i++)
+        m[i] = LoadBE(in, 80, 8 * i);
+    m[10] = Set(0x8000000000000000ull);
+    m[11] = m[12] = Set(0);
+    m[13] = Set(1);
+    m[14] = Set(0);
+    m[15] = Set(80 * 8);
+
+    __m256i v[16];
+    for (int i = 0; i < 8; i++)
+        v[i] = Set(IV[i]);
+    v[8] = Set(C[0]);
+    v[9] = Set(C[1]);
+    v[10] = Set(C[2]);
+    v[11] = Set(C[3]);
+    v[12] = Set(C[4] ^ (80 * 8));
+    v[13] = Set(C[5] ^ (80 * 8));
+    v[14] = Set(C[6]);
+    v[15] = Set(C[7]);
+
+    for (int r = 0; r < 16; r++) {
+        G(v, m, r, 0, 0, 4,  8, 12);
+        G(v, m, r, 1, 1, 5,  9, 13);
+        G(v, m, r, 2, 2, 6, 10, 14);
+        G(v, m, r, 3, 3, 7, 11, 15);
+        G(v, m, r, 4, 0, 5, 10, 15);
+        G(v, m, r, 5, 1, 6, 11, 12);
+        G(v, m, r, 6, 2, 7,  8, 13);
+        G(v, m, r, 7, 3, 4,  9, 14);
+    }
+
+    for (int i = 0; i < 8; i++)
+        StoreBE(out, 64, 8 * i, Xor(Set(IV[i]), Xor(v[i], v[i + 8])));
+}
+
+void Skein512_64(unsigned char* out, const unsigned char* in)
+{
+    using namespace skein512;
+
+    __m256i h[8], m[8];
+    for (int i = 0; i < 8; i++) {
+        h[i] = Set(IV[i]);
+        m[i] = LoadLE(in, 64, 8 * i);
+    }
+    // The whole message is a single final block, followed by the output block
+    UBI(h, m, 64, T_FIRST | T_FINAL | T_MSG);
+    for (int i = 0; i < 8; i++)
+        m[i] = Set(0);
+    UBI(h, m, 8, T_FIRST | T_FINAL | T_OUT);
+
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, 64, 8 * i, h[i]);
+}
+
+void Keccak512_64(unsigned char* out, const unsigned char* in)
+{
+    using namespace keccak512;
+
+    // A single 72-byte block: 64 message bytes, then the 0x01 ... 0x80 padding
+    __m256i a[25];
+    for (int i = 0; i < 8; i++)
+        a[i] = LoadLE(in, 64, 8 * i);
+    a[8] = Set(0x8000000000000001ull);
+    for (int i = 9; i < 25; i++)
+        a[i] = Set(0);
+
+    Permute(a);
+
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, 64, 8 * i, a[i]);
+}
+
+} // namespace phichox_avx2
+
+#endif // ENABLE_AVX2
@@ -723,6 +723,18 @@ void CGovernanceObject::swap(CGovernanceObject& first, CGovernanceObject& second
     swap(first.fExpired, second.fExpired);
 }
 
+void CGovernanceObject::AddOrphanVoteSignatures(CSignatureBatch& batch) const
+{
+    int64_t nNow = GetAdjustedTime();
+    const vote_mcache_t::list_t& listVotes = mapOrphanVotes.GetItemList();
+    for(vote_mcache_t::list_cit it = listVotes.begin(); it != listVotes.end(); ++it) {
+        const vote_time_pair_t& pairVote = it->value;
+        if(pairVote.second >= nNow) {
+            pairVote.first.AddToSignatureBatch(batch);
+        }
+    }
+}
+
 void CGovernanceObject::CheckOrphanVotes(CConnman& connman)
 {
     int64_t nNow = GetAdjustedTime();
@@ -22,6 +22,7 @@ class CGovernanceManager;
 class CGovernanceTriggerManager;
 class CGovernanceObject;
 class CGovernanceVote;
+class CSignatureBatch;
 
 static const int MAX_GOVERNANCE_OBJECT_DATA_SIZE = 16 * 1024;
 static const int MIN_GOVERNANCE_PEER_PROTO_VERSION = 70206;
@@ -351,6 +352,9 @@ private:
 
     void CheckOrphanVotes(CConnman& connman);
 
+    /// Queue the signatures of the orphan votes CheckOrphanVotes would process
+    void AddOrphanVoteSignatures(CSignatureBatch& batch) const;
+
 };
 
 
@@ -14,6 +14,7 @@ using namespace std;
 
 class CGovernanceVote;
 class CConnman;
+class CSignatureBatch;
 
 // INTENTION OF MASTERNODES REGARDING ITEM
 enum vote_outcome_enum_t  {
@@ -121,8 +122,12 @@ public:
 
     void SetSignature(const std::vector<unsigned char>& vchSigIn) { vchSig = vchSigIn; }
 
+    /// The message the masternode signs, shared by signing and both verification paths
+    std::string GetSignatureMessage() const;
     bool Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode);
     bool IsValid(bool fSignatureCheck) const;
+    /// Queue the signature so that IsValid finds it verified, false if the masternode is unknown
+    bool AddToSignatureBatch(CSignatureBatch& batch) const;
     void Relay(CConnman& connman) const;
 
     std::string GetVoteString() const {
@@ -237,7 +237,11 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, std::string& strCommand, C
 
         uint256 nHash = vote.GetHash();
 
-        pfrom->setAskFor.erase(nHash);
+        {
+            // this runs on a message worker
+            LOCK(cs_main);
+            pfrom->setAskFor.erase(nHash);
+        }
 
         // Ignore such messages until masternode list is synced
         if(!masternodeSync.IsMasternodeListSynced()) {
@@ -264,6 +268,7 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, std::string& strCommand, C
         else {
             LogPrint("gobject", "MNGOVERNANCEOBJECTVOTE -- Rejected vote, error = %s\n", exception.what());
             if((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
+                LOCK(cs_main);
                 Misbehaving(pfrom->GetId(), exception.GetNodePenalty());
             }
             return;
@@ -281,6 +286,16 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernance
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
     int64_t nNow = GetAdjustedTime();
+
+    // verify all signatures at once, ProcessVote finds the valid ones in the signature cache
+    CSignatureBatch batch;
+    for(size_t i = 0; i < vecVotePairs.size(); ++i) {
+        if(vecVotePairs[i].second >= nNow) {
+            vecVotePairs[i].first.AddToSignatureBatch(batch);
+        }
+    }
+    batch.Verify();
+
     for(size_t i = 0; i < vecVotePairs.size(); ++i) {
         bool fRemove = false;
         vote_time_pair_t& pairVote = vecVotePairs[i];
@@ -989,6 +1004,14 @@ void CGovernanceManager::CheckMasternodeOrphanVotes(CConnman& connman)
 
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
+    // verify the signatures of all objects' orphan votes at once,
+    // ProcessVote finds the valid ones in the signature cache
+    CSignatureBatch batch;
+    for(object_m_it it = mapObjects.begin(); it != mapObjects.end(); ++it) {
+        it->second.AddOrphanVoteSignatures(batch);
+    }
+    batch.Verify();
+
     for(object_m_it it = mapObjects.begin(); it != mapObjects.end(); ++it) {
         it->second.CheckOrphanVotes(connman);
     }
@@ -424,6 +424,17 @@ bool CInstantSend::ProcessTxLockVote(CNode* pfrom, CTxLockVote& vote, CConnman&
 
 void CInstantSend::ProcessOrphanTxLockVotes(CConnman& connman)
 {
+    // verify the signatures of all orphan votes at once without holding any locks,
+    // ProcessTxLockVote will find the valid ones in the signature cache
+    CSignatureBatch batch;
+    {
+        LOCK(cs_instantsend);
+        for (const auto& pair : mapTxLockVotesOrphan) {
+            pair.second.AddToSignatureBatch(batch);
+        }
+    }
+    batch.Verify();
+
     LOCK(cs_main);
 #ifdef ENABLE_WALLET
     if (pwalletMain)
@@ -1052,10 +1063,15 @@ uint256 CTxLockVote::GetHash() const
     return ss.GetHash();
 }
 
+std::string CTxLockVote::GetSignatureMessage() const
+{
+    return txHash.ToString() + outpoint.ToStringShort();
+}
+
 bool CTxLockVote::CheckSignature() const
 {
     std::string strError;
-    std::string strMessage = txHash.ToString() + outpoint.ToStringShort();
+    std::string strMessage = GetSignatureMessage();
 
     masternode_info_t infoMn;
 
@@ -1072,10 +1088,22 @@ bool CTxLockVote::CheckSignature() const
     return true;
 }
 
+bool CTxLockVote::AddToSignatureBatch(CSignatureBatch& batch) const
+{
+    masternode_info_t infoMn;
+
+    if(!mnodeman.GetMasternodeInfo(outpointMasternode, infoMn)) {
+        return false;
+    }
+
+    batch.AddMessage(infoMn.pubKeyMasternode, vchMasternodeSignature, GetSignatureMessage());
+    return true;
+}
+
 bool CTxLockVote::Sign()
 {
     std::string strError;
-    std::string strMessage = txHash.ToString() + outpoint.ToStringShort();
+    std::string strMessage = GetSignatureMessage();
 
     if(!CMessageSigner::SignMessage(strMessage, vchMasternodeSignature, activeMasternode.keyMasternode)) {
         LogPrintf("CTxLockVote::Sign -- SignMessage() failed\n");
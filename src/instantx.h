@@ -8,6 +8,7 @@
 #include "net.h"
 #include "primitives/transaction.h"
 
+class CSignatureBatch;
 class CTxLockVote;
 class COutPointLock;
 class CTxLockRequest;
@@ -192,8 +193,12 @@ public:
     bool IsTimedOut() const;
     bool IsFailed() const;
 
+    /// The message the masternode signs, shared by signing and both verification paths
+    std::string GetSignatureMessage() const;
     bool Sign();
     bool CheckSignature() const;
+    /// Queue the signature so that CheckSignature finds it verified, false if the masternode is unknown
+    bool AddToSignatureBatch(CSignatureBatch& batch) const;
 
     void Relay(CConnman& connman) const;
 };
@@ -63,6 +63,7 @@ CMasternodeMan::CMasternodeMan()
   fMasternodesRemoved(false),
   vecDirtyGovernanceObjectHashes(),
   nLastWatchdogVoteTime(0),
+  mapRankingCache(MAX_RANKING_CACHE_SIZE),
   mapSeenMasternodeBroadcast(),
   mapSeenMasternodePing(),
   nDsqCount(0)
@@ -76,6 +77,7 @@ bool CMasternodeMan::Add(CMasternode &mn)
 
     LogPrint("masternode", "CMasternodeMan::Add -- Adding new Masternode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
     mapMasternodes[mn.vin.prevout] = mn;
+    InvalidateRankingCache();
     fMasternodesAdded = true;
     return true;
 }
@@ -190,6 +192,7 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
                 // and finally remove it from the list
                 it->second.FlagGovernanceItemsAsDirty();
                 mapMasternodes.erase(it++);
+                InvalidateRankingCache();
                 fMasternodesRemoved = true;
             } else {
                 bool fAsk = (nAskForMnbRecovery > 0) &&
@@ -345,6 +348,7 @@ void CMasternodeMan::Clear()
 {
     LOCK(cs);
     mapMasternodes.clear();
+    InvalidateRankingCache();
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
@@ -632,6 +636,33 @@ bool CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, CMasternodeM
     return !vecMasternodeScoresRet.empty();
 }
 
+CMasternodeMan::ranking_ref_t CMasternodeMan::GetMasternodeRanking(const uint256& nBlockHash, int nMinProtocol)
+{
+    AssertLockHeld(cs);
+
+    std::pair<uint256, int> key = std::make_pair(nBlockHash, nMinProtocol);
+    ranking_ref_t ranking;
+    if (mapRankingCache.Get(key, ranking)) {
+        // reinsert to make it the most recently used one, CacheMap evicts the oldest entry first
+        mapRankingCache.Erase(key);
+        mapRankingCache.Insert(key, ranking);
+        return ranking;
+    }
+
+    std::shared_ptr<CMasternodeRanking> newRanking = std::make_shared<CMasternodeRanking>();
+    if (!GetMasternodeScores(nBlockHash, newRanking->vecScores, nMinProtocol))
+        return ranking_ref_t();
+
+    newRanking->mapRanks.reserve(newRanking->vecScores.size());
+    int nRank = 0;
+    for (auto& scorePair : newRanking->vecScores) {
+        newRanking->mapRanks.emplace(scorePair.second->vin.prevout, ++nRank);
+    }
+
+    mapRankingCache.Insert(key, newRanking);
+    return newRanking;
+}
+
 bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight, int nMinProtocol)
 {
     nRankRet = -1;
@@ -648,20 +679,16 @@ bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet,
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    ranking_ref_t ranking = GetMasternodeRanking(nBlockHash, nMinProtocol);
+    if (!ranking)
         return false;
 
-    int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        if(scorePair.second->vin.prevout == outpoint) {
-            nRankRet = nRank;
-            return true;
-        }
-    }
+    auto it = ranking->mapRanks.find(outpoint);
+    if (it == ranking->mapRanks.end())
+        return false;
 
-    return false;
+    nRankRet = it->second;
+    return true;
 }
 
 bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight, int nMinProtocol)
@@ -680,12 +707,13 @@ bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMast
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    ranking_ref_t ranking = GetMasternodeRanking(nBlockHash, nMinProtocol);
+    if (!ranking)
         return false;
 
+    vecMasternodeRanksRet.reserve(ranking->vecScores.size());
     int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
+    for (auto& scorePair : ranking->vecScores) {
         nRank++;
         vecMasternodeRanksRet.push_back(std::make_pair(nRank, *scorePair.second));
     }
@@ -772,15 +800,16 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 
         uint256 nHash = mnp.GetHash();
 
+        // Need LOCK2 here to ensure consistent locking order because the CheckAndUpdate call below locks cs_main
+        // (it also protects setAskFor, this runs on a message worker)
+        LOCK2(cs_main, cs);
+
         pfrom->setAskFor.erase(nHash);
 
         if(!masternodeSync.IsBlockchainSynced()) return;
 
         LogPrint("masternode", "MNPING -- Masternode ping, masternode=%s\n", mnp.vin.prevout.ToStringShort());
 
-        // Need LOCK2 here to ensure consistent locking order because the CheckAndUpdate call below locks cs_main
-        LOCK2(cs_main, cs);
-
         if(mapSeenMasternodePing.count(nHash)) return; //seen
         mapSeenMasternodePing.insert(std::make_pair(nHash, mnp));
 
@@ -824,24 +853,34 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 
         LogPrint("masternode", "DSEG -- Masternode list, masternode=%s\n", vin.prevout.ToStringShort());
 
-        LOCK(cs);
-
         if(vin == CTxIn()) { //only should ask for this once
             //local network
             bool isLocal = (pfrom->addr.IsRFC1918() || pfrom->addr.IsLocal());
 
             if(!isLocal && Params().NetworkIDString() == CBaseChainParams::MAIN) {
-                std::map<CNetAddr, int64_t>::iterator it = mAskedUsForMasternodeList.find(pfrom->addr);
-                if (it != mAskedUsForMasternodeList.end() && it->second > GetTime()) {
+                bool fAskedAgain = false;
+                {
+                    LOCK(cs);
+                    std::map<CNetAddr, int64_t>::iterator it = mAskedUsForMasternodeList.find(pfrom->addr);
+                    if (it != mAskedUsForMasternodeList.end() && it->second > GetTime()) {
+                        fAskedAgain = true;
+                    } else {
+                        int64_t askAgain = GetTime() + DSEG_UPDATE_SECONDS;
+                        mAskedUsForMasternodeList[pfrom->addr] = askAgain;
+                    }
+                }
+                if (fAskedAgain) {
+                    // cs_main can't be taken while holding cs, it comes first
+                    LOCK(cs_main);
                     Misbehaving(pfrom->GetId(), 34);
                     LogPrintf("DSEG -- peer already asked me for the list, peer=%d\n", pfrom->id);
                     return;
                 }
-                int64_t askAgain = GetTime() + DSEG_UPDATE_SECONDS;
-                mAskedUsForMasternodeList[pfrom->addr] = askAgain;
             }
         } //else, asking for a specific node which is ok
 
+        LOCK(cs);
+
         int nInvCount = 0;
 
         for (auto& mnpair : mapMasternodes) {
@@ -1341,7 +1380,10 @@ void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& co
         }
     } else {
         CMasternodeBroadcast mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
-        if(pmn->UpdateFromNewBroadcast(mnb, connman)) {
+        bool fUpdated = pmn->UpdateFromNewBroadcast(mnb, connman);
+        // protocol version might have changed
+        InvalidateRankingCache();
+        if(fUpdated) {
             masternodeSync.BumpAssetLastTime("CMasternodeMan::UpdateMasternodeList - seen");
             mapSeenMasternodeBroadcast.erase(mnbOld.GetHash());
         }
@@ -1403,7 +1445,10 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
         CMasternode* pmn = Find(mnb.vin.prevout);
         if(pmn) {
             CMasternodeBroadcast mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
-            if(!mnb.Update(pmn, nDos, connman)) {
+            bool fUpdated = mnb.Update(pmn, nDos, connman);
+            // protocol version might have changed
+            InvalidateRankingCache();
+            if(!fUpdated) {
                 LogPrint("masternode", "CMasternodeMan::CheckMnbAndUpdateMasternodeList -- Update() failed, masternode=%s\n", mnb.vin.prevout.ToStringShort());
                 return false;
             }
@@ -5,9 +5,14 @@
 #ifndef MASTERNODEMAN_H
 #define MASTERNODEMAN_H
 
+#include "cachemap.h"
+#include "coins.h"
 #include "masternode.h"
 #include "sync.h"
 
+#include <memory>
+#include <unordered_map>
+
 using namespace std;
 
 class CMasternodeMan;
@@ -41,6 +46,9 @@ private:
     static const int MNB_RECOVERY_WAIT_SECONDS      = 60;
     static const int MNB_RECOVERY_RETRY_SECONDS     = 3 * 60 * 60;
 
+    /// How many block hashes to keep masternode rankings for
+    static const int MAX_RANKING_CACHE_SIZE         = 16;
+
 
     // critical section to chainox the inner data structures
     mutable CCriticalSection cs;
@@ -74,11 +82,25 @@ private:
 
     int64_t nLastWatchdogVoteTime;
 
+    /// Masternodes sorted by score for some block hash and the rank of every one of them
+    struct CMasternodeRanking {
+        score_pair_vec_t vecScores;
+        std::unordered_map<COutPoint, int, SaltedOutpointHasher> mapRanks;
+    };
+    typedef std::shared_ptr<const CMasternodeRanking> ranking_ref_t;
+
+    /// Recently used rankings keyed by (block hash, min protocol), dropped whenever the list changes
+    CacheMap<std::pair<uint256, int>, ranking_ref_t> mapRankingCache;
+
     friend class CMasternodeSync;
     /// Find an entry
     CMasternode* Find(const COutPoint& outpoint);
 
     bool GetMasternodeScores(const uint256& nBlockHash, score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol = 0);
+    /// Get the ranking for nBlockHash from the cache, calculating it on a miss (requires cs)
+    ranking_ref_t GetMasternodeRanking(const uint256& nBlockHash, int nMinProtocol);
+    /// Must be called whenever masternodes are added, removed or change their protocol version
+    void InvalidateRankingCache() { mapRankingCache.Clear(); }
 
 public:
     // Keep track of all broadcasts I've seen
@@ -106,6 +128,9 @@ public:
         }
 
         READWRITE(mapMasternodes);
+        if(ser_action.ForRead()) {
+            InvalidateRankingCache();
+        }
         READWRITE(mAskedUsForMasternodeList);
         READWRITE(mWeAskedForMasternodeList);
         READWRITE(mWeAskedForMasternodeListEntry);
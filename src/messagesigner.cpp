@@ -3,12 +3,95 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "base58.h"
+#include "checkqueue.h"
 #include "hash.h"
+#include "memusage.h"
+#include "random.h"
 #include "validation.h" // For strMessageMagic
 #include "messagesigner.h"
+#include "sync.h"
 #include "tinyformat.h"
+#include "util.h"
 #include "utilstrencodings.h"
 
+#include <boost/thread.hpp>
+#include <boost/unordered_set.hpp>
+
+namespace {
+
+/**
+ * We're hashing a nonce into the entries themselves, so we don't need extra
+ * blinding in the set hash computation.
+ */
+class CMessageSignatureCacheHasher
+{
+public:
+    size_t operator()(const uint256& key) const {
+        return key.GetCheapHash();
+    }
+};
+
+/**
+ * Valid compact signature cache, so that messages relayed by several peers
+ * or checked again later (orphan votes, mnb recovery replies, batches) need
+ * only one public key recovery. Modelled on the script signature cache.
+ */
+class CMessageSignatureCache
+{
+private:
+    //! Entries are SHA256(nonce || hash || public key || signature):
+    uint256 nonce;
+    typedef boost::unordered_set<uint256, CMessageSignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_msgsigcache;
+
+public:
+    CMessageSignatureCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(uint256& entry, const uint256& hash, const CPubKey& pubkey, const std::vector<unsigned char>& vchSig)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(hash.begin(), 32).Write(pubkey.begin(), pubkey.size()).Write(vchSig.data(), vchSig.size()).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_msgsigcache);
+        return setValid.count(entry);
+    }
+
+    void Set(const uint256& entry)
+    {
+        size_t nMaxCacheSize = GetArg("-maxmsgsigcachesize", DEFAULT_MAX_MSG_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+        if (nMaxCacheSize <= 0) return;
+
+        boost::unique_lock<boost::shared_mutex> lock(cs_msgsigcache);
+        while (memusage::DynamicUsage(setValid) > nMaxCacheSize)
+        {
+            map_type::size_type s = GetRand(setValid.bucket_count());
+            map_type::local_iterator it = setValid.begin(s);
+            if (it != setValid.end(s)) {
+                setValid.erase(*it);
+            }
+        }
+
+        setValid.insert(entry);
+    }
+};
+
+CMessageSignatureCache messageSignatureCache;
+
+CCheckQueue<CHashSignatureCheck> msgsigcheckqueue(32);
+/** Serializes masters of msgsigcheckqueue, which supports one at a time */
+CCriticalSection cs_msgsigcheckqueue;
+
+/** Below this many signatures a batch is checked on the calling thread */
+const size_t MIN_PARALLEL_SIGNATURE_BATCH = 4;
+
+}
+
 bool CMessageSigner::GetKeysFromSecret(const std::string strSecret, CKey& keyRet, CPubKey& pubkeyRet)
 {
     CBitcoinSecret vchSecret;
@@ -46,6 +129,11 @@ bool CHashSigner::SignHash(const uint256& hash, const CKey key, std::vector<unsi
 
 bool CHashSigner::VerifyHash(const uint256& hash, const CPubKey pubkey, const std::vector<unsigned char>& vchSig, std::string& strErrorRet)
 {
+    uint256 entry;
+    messageSignatureCache.ComputeEntry(entry, hash, pubkey, vchSig);
+    if (messageSignatureCache.Get(entry))
+        return true;
+
     CPubKey pubkeyFromSig;
     if(!pubkeyFromSig.RecoverCompact(hash, vchSig)) {
         strErrorRet = "Error recovering public key.";
@@ -59,5 +147,59 @@ bool CHashSigner::VerifyHash(const uint256& hash, const CPubKey pubkey, const st
         return false;
     }
 
+    messageSignatureCache.Set(entry);
     return true;
 }
+
+bool CHashSignatureCheck::operator()()
+{
+    std::string strError;
+    CHashSigner::VerifyHash(hash, pubkey, vchSig, strError);
+    return true;
+}
+
+void CHashSignatureCheck::swap(CHashSignatureCheck& check)
+{
+    std::swap(hash, check.hash);
+    std::swap(pubkey, check.pubkey);
+    vchSig.swap(check.vchSig);
+}
+
+void CSignatureBatch::AddMessage(const CPubKey& pubkey, const std::vector<unsigned char>& vchSig, const std::string& strMessage)
+{
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << strMessageMagic;
+    ss << strMessage;
+
+    AddHash(pubkey, vchSig, ss.GetHash());
+}
+
+void CSignatureBatch::AddHash(const CPubKey& pubkey, const std::vector<unsigned char>& vchSig, const uint256& hash)
+{
+    vChecks.push_back(CHashSignatureCheck(hash, pubkey, vchSig));
+}
+
+void CSignatureBatch::Verify()
+{
+    int64_t nTimeStart = GetTimeMicros();
+    size_t nChecks = vChecks.size();
+
+    if (nScriptCheckThreads && nChecks >= MIN_PARALLEL_SIGNATURE_BATCH) {
+        LOCK(cs_msgsigcheckqueue);
+        CCheckQueueControl<CHashSignatureCheck> control(&msgsigcheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (size_t i = 0; i < vChecks.size(); i++)
+            vChecks[i]();
+    }
+    vChecks.clear();
+
+    LogPrint("bench", "    - Verify %u message signatures: %.2fms\n", nChecks, 0.001 * (GetTimeMicros() - nTimeStart));
+}
+
+void ThreadMessageSignatureCheck()
+{
+    RenameThread("chainox-msgsigch");
+    msgsigcheckqueue.Thread();
+}
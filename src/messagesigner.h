@@ -7,6 +7,11 @@
 
 #include "key.h"
 
+#include <vector>
+
+/** Default for -maxmsgsigcachesize, maximum size of the message signature cache in MiB */
+static const unsigned int DEFAULT_MAX_MSG_SIG_CACHE_SIZE = 8;
+
 /** Helper class for signing messages and checking their signatures
  */
 class CMessageSigner
@@ -28,7 +33,51 @@ public:
     /// Sign the hash, returns true if successful
     static bool SignHash(const uint256& hash, const CKey key, std::vector<unsigned char>& vchSigRet);
     /// Verify the hash signature, returns true if succcessful
+    /// (valid signatures are cached, so checking one again is cheap)
     static bool VerifyHash(const uint256& hash, const CPubKey pubkey, const std::vector<unsigned char>& vchSig, std::string& strErrorRet);
 };
 
+/** Closure verifying one hash signature on the message signature check threads
+ */
+class CHashSignatureCheck
+{
+private:
+    uint256 hash;
+    CPubKey pubkey;
+    std::vector<unsigned char> vchSig;
+
+public:
+    CHashSignatureCheck() {}
+    CHashSignatureCheck(const uint256& hashIn, const CPubKey& pubkeyIn, const std::vector<unsigned char>& vchSigIn) :
+        hash(hashIn), pubkey(pubkeyIn), vchSig(vchSigIn) {}
+
+    /// Always returns true, an invalid signature must not stop the others in the batch from being checked
+    bool operator()();
+
+    void swap(CHashSignatureCheck& check);
+};
+
+/** Helper class for checking many signatures at once, e.g. a flood of votes
+ *  or orphan votes that became processable. Signatures are checked on the
+ *  message signature check threads and the valid ones end up in the
+ *  signature cache, so that the CMessageSigner::VerifyMessage and
+ *  CHashSigner::VerifyHash calls made while processing them are cheap.
+ */
+class CSignatureBatch
+{
+private:
+    std::vector<CHashSignatureCheck> vChecks;
+
+public:
+    /// Queue the message signature for verification
+    void AddMessage(const CPubKey& pubkey, const std::vector<unsigned char>& vchSig, const std::string& strMessage);
+    /// Queue the hash signature for verification
+    void AddHash(const CPubKey& pubkey, const std::vector<unsigned char>& vchSig, const uint256& hash);
+    size_t size() const { return vChecks.size(); }
+    /// Verify all queued signatures and clear the batch
+    void Verify();
+};
+
+void ThreadMessageSignatureCheck();
+
 #endif
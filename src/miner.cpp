@@ -13,6 +13,7 @@
 #include "consensus/consensus.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "crypto/common.h"
 #include "hash.h"
 #include "validation.h"
 #include "net.h"
@@ -20,6 +21,7 @@
 #include "pow.h"
 #include "primitives/transaction.h"
 #include "script/standard.h"
+#include "streams.h"
 #include "timedata.h"
 #include "txmempool.h"
 #include "util.h"
@@ -30,7 +32,6 @@
 
 #include <boost/thread.hpp>
 #include <boost/tuple/tuple.hpp>
-#include <queue>
 
 using namespace std;
 
@@ -48,17 +49,6 @@ using namespace std;
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockSize = 0;
 
-class ScoreCompare
-{
-public:
-    ScoreCompare() {}
-
-    bool operator()(const CTxMemPool::txiter a, const CTxMemPool::txiter b)
-    {
-        return CompareTxMemPoolEntryByScore()(*b,*a); // Convert to less than
-    }
-};
-
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
 {
     int64_t nOldTime = pblock->nTime;
@@ -74,13 +64,389 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
     return nNewTime - nOldTime;
 }
 
-CBlockTemplate* CreateNewBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn)
+namespace {
+/**
+ * An in-mempool transaction together with its in-mempool ancestors that are
+ * not in the block yet: what it takes to add the transaction to the block.
+ */
+struct CTxPackage
 {
-    // Create new block
-    std::unique_ptr<CBlockTemplate> pblocktemplate(new CBlockTemplate());
-    if(!pblocktemplate.get())
-        return NULL;
-    CBlock *pblock = &pblocktemplate->block; // pointer for convenience
+    uint64_t nSize;
+    CAmount nModFees;
+    unsigned int nSigOps;
+
+    CTxPackage() : nSize(0), nModFees(0), nSigOps(0) {}
+
+    void Add(const CTxMemPoolEntry& entry)
+    {
+        nSize += entry.GetTxSize();
+        nModFees += entry.GetModifiedFee();
+        nSigOps += entry.GetSigOpCount();
+    }
+
+    void Remove(const CTxMemPoolEntry& entry)
+    {
+        nSize -= entry.GetTxSize();
+        nModFees -= entry.GetModifiedFee();
+        nSigOps -= entry.GetSigOpCount();
+    }
+};
+
+typedef std::map<CTxMemPool::txiter, CTxPackage, CTxMemPool::CompareIteratorByHash> packagemap_t;
+
+/** Highest package fee rate first */
+class ComparePackageFeeRate
+{
+private:
+    const packagemap_t* mapPackages;
+
+public:
+    ComparePackageFeeRate(const packagemap_t* mapPackagesIn) : mapPackages(mapPackagesIn) {}
+
+    bool operator()(const CTxMemPool::txiter a, const CTxMemPool::txiter b) const
+    {
+        const CTxPackage& packageA = mapPackages->find(a)->second;
+        const CTxPackage& packageB = mapPackages->find(b)->second;
+        double f1 = (double)packageA.nModFees * packageB.nSize;
+        double f2 = (double)packageB.nModFees * packageA.nSize;
+        if (f1 == f2)
+            return a->GetTx().GetHash() < b->GetTx().GetHash();
+        return f1 > f2;
+    }
+};
+
+/**
+ * The transactions of the last block template. While the tip stays the same,
+ * transactions entering the mempool are added to it rather than building it
+ * again from the whole mempool.
+ */
+struct CTemplateState
+{
+    // What the template was made for
+    uint256 hashPrevBlock;
+    int nHeight;
+    int64_t nLockTimeCutoff;
+    unsigned int nBlockMaxSize;
+    unsigned int nBlockMinSize;
+    unsigned int nBlockPrioritySize;
+    unsigned int nMaxBlockSigOps;
+    bool fPrintPriority;
+    //! Cleared by mempool changes an update can't follow
+    bool fValid;
+
+    // The transactions after the coinbase
+    std::vector<CTransactionRef> vtx;
+    std::vector<CAmount> vTxFees;
+    std::vector<int64_t> vTxSigOps;
+    std::set<uint256> setInBlock;
+    uint64_t nBlockSize;
+    unsigned int nBlockSigOps;
+    CAmount nFees;
+    //! Lowest fee rate of the packages selected by fee
+    CFeeRate minPackageFeeRate;
+    bool fHavePackage;
+
+    //! Transactions that entered the mempool since
+    std::vector<uint256> vAdded;
+
+    CTemplateState() : nHeight(0), nLockTimeCutoff(0), nBlockMaxSize(0), nBlockMinSize(0), nBlockPrioritySize(0),
+        nMaxBlockSigOps(0), fPrintPriority(false), fValid(false), nBlockSize(0), nBlockSigOps(0), nFees(0),
+        fHavePackage(false) {}
+};
+
+CCriticalSection cs_template;
+CTemplateState templateState;
+CBlockTemplateStats templateStats;
+bool fTemplateSignalsConnected = false;
+}
+
+static void TemplateEntryAdded(CTransactionRef ptx)
+{
+    LOCK(cs_template);
+    if (!templateState.fValid)
+        return;
+    if (templateState.vAdded.size() >= MAX_TEMPLATE_UPDATE_TXS) {
+        // Building it again costs less than adding them one by one
+        templateState.fValid = false;
+        return;
+    }
+    templateState.vAdded.push_back(ptx->GetHash());
+}
+
+static void TemplateEntryRemoved(CTransactionRef ptx)
+{
+    LOCK(cs_template);
+    // The room it leaves may go to transactions that were left out
+    if (templateState.setInBlock.count(ptx->GetHash()))
+        templateState.fValid = false;
+}
+
+static bool TestForBlock(const CTemplateState& state, uint64_t nSize, unsigned int nSigOps)
+{
+    return state.nBlockSize + nSize < state.nBlockMaxSize && state.nBlockSigOps + nSigOps < state.nMaxBlockSigOps;
+}
+
+static bool IsStillDependent(const CTemplateState& state, CTxMemPool::txiter iter)
+{
+    BOOST_FOREACH(CTxMemPool::txiter parent, mempool.GetMemPoolParents(iter)) {
+        if (!state.setInBlock.count(parent->GetTx().GetHash()))
+            return true;
+    }
+    return false;
+}
+
+static void AddToBlock(CTemplateState& state, CTxMemPool::txiter iter)
+{
+    state.vtx.push_back(iter->GetSharedTx());
+    state.vTxFees.push_back(iter->GetFee());
+    state.vTxSigOps.push_back(iter->GetSigOpCount());
+    state.setInBlock.insert(iter->GetTx().GetHash());
+    state.nBlockSize += iter->GetTxSize();
+    state.nBlockSigOps += iter->GetSigOpCount();
+    state.nFees += iter->GetFee();
+
+    if (state.fPrintPriority) {
+        double dPriority = iter->GetPriority(state.nHeight);
+        CAmount dummy;
+        mempool.ApplyDeltas(iter->GetTx().GetHash(), dPriority, dummy);
+        LogPrintf("priority %.1f fee %s txid %s\n",
+                  dPriority, CFeeRate(iter->GetModifiedFee(), iter->GetTxSize()).ToString(), iter->GetTx().GetHash().ToString());
+    }
+}
+
+/** Fill the first -blockprioritysize bytes with the highest priority transactions that may go for free */
+static void AddPriorityTxs(CTemplateState& state)
+{
+    if (state.nBlockPrioritySize == 0)
+        return;
+
+    // This vector will be sorted into a priority queue:
+    std::vector<TxCoinAgePriority> vecPriority;
+    TxCoinAgePriorityCompare pricomparer;
+    std::map<CTxMemPool::txiter, double, CTxMemPool::CompareIteratorByHash> waitPriMap;
+    typedef std::map<CTxMemPool::txiter, double, CTxMemPool::CompareIteratorByHash>::iterator waitPriIter;
+
+    vecPriority.reserve(mempool.mapTx.size());
+    for (CTxMemPool::indexed_transaction_set::iterator mi = mempool.mapTx.begin(); mi != mempool.mapTx.end(); ++mi) {
+        double dPriority = mi->GetPriority(state.nHeight);
+        CAmount dummy;
+        mempool.ApplyDeltas(mi->GetTx().GetHash(), dPriority, dummy);
+        vecPriority.push_back(TxCoinAgePriority(dPriority, mi));
+    }
+    std::make_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
+
+    while (!vecPriority.empty()) {
+        CTxMemPool::txiter iter = vecPriority.front().second;
+        double actualPriority = vecPriority.front().first;
+        std::pop_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
+        vecPriority.pop_back();
+
+        // Children wait for their parents
+        if (IsStillDependent(state, iter)) {
+            waitPriMap.insert(std::make_pair(iter, actualPriority));
+            continue;
+        }
+
+        unsigned int nTxSize = iter->GetTxSize();
+        if (state.nBlockSize + nTxSize >= state.nBlockPrioritySize || !AllowFree(actualPriority))
+            break;
+        if (!TestForBlock(state, nTxSize, iter->GetSigOpCount()))
+            continue;
+        if (!IsFinalTx(iter->GetTx(), state.nHeight, state.nLockTimeCutoff))
+            continue;
+
+        AddToBlock(state, iter);
+
+        // Add transactions that depend on this one to the priority queue
+        BOOST_FOREACH(CTxMemPool::txiter child, mempool.GetMemPoolChildren(iter)) {
+            waitPriIter wpiter = waitPriMap.find(child);
+            if (wpiter != waitPriMap.end()) {
+                vecPriority.push_back(TxCoinAgePriority(wpiter->second, child));
+                std::push_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
+                waitPriMap.erase(wpiter);
+            }
+        }
+    }
+}
+
+/**
+ * Add the candidates together with their ancestors, highest package fee rate
+ * first, for as long as the packages pay the relay fee or the block is below
+ * -blockminsize. Returns false if a package paying a higher fee rate than one
+ * already in the block did not fit.
+ */
+static bool AddPackageTxs(CTemplateState& state, const std::vector<CTxMemPool::txiter>& vCandidates)
+{
+    uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+    std::string dummy;
+
+    packagemap_t mapPackages;
+    BOOST_FOREACH(CTxMemPool::txiter iter, vCandidates) {
+        if (state.setInBlock.count(iter->GetTx().GetHash()) || mapPackages.count(iter))
+            continue;
+        CTxMemPool::setEntries setAncestors;
+        mempool.CalculateMemPoolAncestors(*iter, setAncestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        CTxPackage& package = mapPackages[iter];
+        package.Add(*iter);
+        BOOST_FOREACH(CTxMemPool::txiter ancestor, setAncestors) {
+            if (!state.setInBlock.count(ancestor->GetTx().GetHash()))
+                package.Add(*ancestor);
+        }
+    }
+
+    // A package may only change while it is out of the queue
+    std::set<CTxMemPool::txiter, ComparePackageFeeRate> setQueue((ComparePackageFeeRate(&mapPackages)));
+    for (packagemap_t::const_iterator it = mapPackages.begin(); it != mapPackages.end(); ++it)
+        setQueue.insert(it->first);
+
+    bool fFitted = true;
+    int nConsecutiveFailed = 0;
+    while (!setQueue.empty()) {
+        CTxMemPool::txiter iter = *setQueue.begin();
+        setQueue.erase(setQueue.begin());
+        const CTxPackage& package = mapPackages[iter];
+        CFeeRate packageFeeRate(package.nModFees, package.nSize);
+
+        // Everything left in the queue pays less
+        if (package.nModFees < ::minRelayTxFee.GetFee(package.nSize) && state.nBlockSize >= state.nBlockMinSize)
+            break;
+
+        if (!TestForBlock(state, package.nSize, package.nSigOps)) {
+            if (!state.fHavePackage || state.minPackageFeeRate < packageFeeRate)
+                fFitted = false;
+            // Once we're within 1000 bytes of a full block, only look at 50 more packages
+            // to try to fill the remaining space.
+            if (state.nBlockSize > state.nBlockMaxSize - 1000 && ++nConsecutiveFailed > 50)
+                break;
+            continue;
+        }
+
+        CTxMemPool::setEntries setAncestors;
+        mempool.CalculateMemPoolAncestors(*iter, setAncestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        std::vector<CTxMemPool::txiter> vPackage(1, iter);
+        BOOST_FOREACH(CTxMemPool::txiter ancestor, setAncestors) {
+            if (!state.setInBlock.count(ancestor->GetTx().GetHash()))
+                vPackage.push_back(ancestor);
+        }
+
+        bool fFinal = true;
+        BOOST_FOREACH(CTxMemPool::txiter member, vPackage) {
+            if (!IsFinalTx(member->GetTx(), state.nHeight, state.nLockTimeCutoff)) {
+                fFinal = false;
+                break;
+            }
+        }
+        if (!fFinal)
+            continue;
+
+        // Parents go before their children
+        std::vector<CTxMemPool::txiter> vAdded;
+        while (vAdded.size() < vPackage.size()) {
+            BOOST_FOREACH(CTxMemPool::txiter member, vPackage) {
+                if (!state.setInBlock.count(member->GetTx().GetHash()) && !IsStillDependent(state, member)) {
+                    AddToBlock(state, member);
+                    vAdded.push_back(member);
+                }
+            }
+        }
+        nConsecutiveFailed = 0;
+        if (!state.fHavePackage || packageFeeRate < state.minPackageFeeRate) {
+            state.minPackageFeeRate = packageFeeRate;
+            state.fHavePackage = true;
+        }
+
+        // The packages of their descendants don't include them anymore
+        BOOST_FOREACH(CTxMemPool::txiter added, vAdded) {
+            if (mapPackages.count(added))
+                setQueue.erase(added);
+        }
+        BOOST_FOREACH(CTxMemPool::txiter added, vAdded) {
+            CTxMemPool::setEntries setDescendants;
+            mempool.CalculateDescendants(added, setDescendants);
+            BOOST_FOREACH(CTxMemPool::txiter descendant, setDescendants) {
+                packagemap_t::iterator mit = mapPackages.find(descendant);
+                if (mit == mapPackages.end() || state.setInBlock.count(descendant->GetTx().GetHash()))
+                    continue;
+                bool fQueued = setQueue.erase(descendant) > 0;
+                mit->second.Remove(*added);
+                if (fQueued)
+                    setQueue.insert(descendant);
+            }
+        }
+    }
+    return fFitted;
+}
+
+/** Select the transactions of a new template from the whole mempool */
+static void BuildTemplate(CTemplateState& state)
+{
+    state.vtx.clear();
+    state.vTxFees.clear();
+    state.vTxSigOps.clear();
+    state.setInBlock.clear();
+    state.vAdded.clear();
+    // Room for the coinbase
+    state.nBlockSize = 1000;
+    state.nBlockSigOps = 100;
+    state.nFees = 0;
+    state.fHavePackage = false;
+
+    AddPriorityTxs(state);
+
+    std::vector<CTxMemPool::txiter> vCandidates;
+    vCandidates.reserve(mempool.mapTx.size());
+    for (CTxMemPool::indexed_transaction_set::iterator mi = mempool.mapTx.begin(); mi != mempool.mapTx.end(); ++mi)
+        vCandidates.push_back(mi);
+    AddPackageTxs(state, vCandidates);
+    state.fValid = true;
+}
+
+/**
+ * Add the transactions that entered the mempool since the template was made.
+ * New transactions only compete on fee, the priority space isn't revisited.
+ * Returns false if the template has to be built again instead.
+ */
+static bool UpdateTemplate(CTemplateState& state)
+{
+    std::vector<CTxMemPool::txiter> vCandidates;
+    BOOST_FOREACH(const uint256& hash, state.vAdded) {
+        CTxMemPool::txiter iter = mempool.mapTx.find(hash);
+        if (iter != mempool.mapTx.end())
+            vCandidates.push_back(iter);
+    }
+    state.vAdded.clear();
+    return AddPackageTxs(state, vCandidates);
+}
+
+CBlockTemplateStats GetBlockTemplateStats()
+{
+    LOCK(cs_template);
+    return templateStats;
+}
+
+/** Header fields that don't depend on the transactions, and a placeholder for the coinbase */
+static void StartBlock(CBlockTemplate* pblocktemplate, const CChainParams& chainparams, const CBlockIndex* pindexPrev)
+{
+    CBlock *pblock = &pblocktemplate->block;
+    pblock->nTime = GetAdjustedTime();
+
+    // Add our coinbase tx as first transaction
+    pblock->vtx.push_back(MakeTransactionRef());
+    pblocktemplate->vTxFees.push_back(-1); // updated at end
+    pblocktemplate->vTxSigOps.push_back(-1); // updated at end
+    pblock->nVersion = ComputeBlockVersion(pindexPrev, chainparams.GetConsensus());
+    // -regtest only: allow overriding block.nVersion with
+    // -blockversion=N to test forking scenarios
+    if (chainparams.MineBlocksOnDemand())
+        pblock->nVersion = GetArg("-blockversion", pblock->nVersion);
+}
+
+/** Create the coinbase, paying the masternode and superblock their share of the reward, and fill in the header */
+static void FinishBlock(CBlockTemplate* pblocktemplate, const CScript& scriptPubKeyIn, const CChainParams& chainparams,
+                        CBlockIndex* pindexPrev, CAmount nFees)
+{
+    CBlock *pblock = &pblocktemplate->block;
+    const int nHeight = pindexPrev->nHeight + 1;
 
     // Create coinbase tx
     CMutableTransaction txNew;
@@ -89,6 +455,41 @@ CBlockTemplate* CreateNewBlock(const CChainParams& chainparams, const CScript& s
     txNew.vout.resize(1);
     txNew.vout[0].scriptPubKey = scriptPubKeyIn;
 
+    // NOTE: unlike in bitcoin, we need to pass PREVIOUS block height here
+    CAmount blockReward = nFees + GetBlockSubsidy(pindexPrev->nBits, pindexPrev->nHeight, Params().GetConsensus());
+
+    // Compute regular coinbase transaction.
+    txNew.vout[0].nValue = blockReward;
+    txNew.vin[0].scriptSig = CScript() << nHeight << OP_0;
+
+    // Update coinbase transaction with additional info about masternode and governance payments,
+    // get some info back to pass to getblocktemplate
+    FillBlockPayments(txNew, nHeight, blockReward, pblock->txoutMasternode, pblock->voutSuperblock);
+    // LogPrintf("CreateNewBlock -- nBlockHeight %d blockReward %lld txoutMasternode %s txNew %s",
+    //             nHeight, blockReward, pblock->txoutMasternode.ToString(), txNew.ToString());
+
+    // Update block coinbase
+    pblock->vtx[0] = MakeTransactionRef(std::move(txNew));
+    pblocktemplate->vTxFees[0] = -nFees;
+
+    // Fill in header
+    pblock->hashPrevBlock  = pindexPrev->GetBlockHash();
+    UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev);
+    pblock->nBits          = GetNextWorkRequired(pindexPrev, pblock, chainparams.GetConsensus());
+    pblock->nNonce         = 0;
+    pblocktemplate->vTxSigOps[0] = GetLegacySigOpCount(*pblock->vtx[0]);
+}
+
+CBlockTemplate* CreateNewBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn)
+{
+    int64_t nTimeStart = GetTimeMicros();
+
+    // Create new block
+    std::unique_ptr<CBlockTemplate> pblocktemplate(new CBlockTemplate());
+    if(!pblocktemplate.get())
+        return NULL;
+    CBlock *pblock = &pblocktemplate->block; // pointer for convenience
+
     // Largest block you're willing to create:
     unsigned int nBlockMaxSize = GetArg("-blockmaxsize", DEFAULT_BLOCK_MAX_SIZE);
     // Limit to between 1K and MAX_BLOCK_SIZE-1K for sanity:
@@ -104,218 +505,209 @@ CBlockTemplate* CreateNewBlock(const CChainParams& chainparams, const CScript& s
     unsigned int nBlockMinSize = GetArg("-blockminsize", DEFAULT_BLOCK_MIN_SIZE);
     nBlockMinSize = std::min(nBlockMaxSize, nBlockMinSize);
 
-    // Collect memory pool transactions into the block
-    CTxMemPool::setEntries inBlock;
-    CTxMemPool::setEntries waitSet;
-
-    // This vector will be sorted into a priority queue:
-    vector<TxCoinAgePriority> vecPriority;
-    TxCoinAgePriorityCompare pricomparer;
-    std::map<CTxMemPool::txiter, double, CTxMemPool::CompareIteratorByHash> waitPriMap;
-    typedef std::map<CTxMemPool::txiter, double, CTxMemPool::CompareIteratorByHash>::iterator waitPriIter;
-    double actualPriority = -1;
-
-    std::priority_queue<CTxMemPool::txiter, std::vector<CTxMemPool::txiter>, ScoreCompare> clearedTxs;
     bool fPrintPriority = GetBoolArg("-printpriority", DEFAULT_PRINTPRIORITY);
-    uint64_t nBlockSize = 1000;
-    uint64_t nBlockTx = 0;
-    unsigned int nBlockSigOps = 100;
-    int lastFewTxs = 0;
-    CAmount nFees = 0;
+    uint64_t nBlockSize;
+    unsigned int nBlockSigOps;
+    CAmount nFees;
 
     {
         LOCK(cs_main);
 
         CBlockIndex* pindexPrev = chainActive.Tip();
         const int nHeight = pindexPrev->nHeight + 1;
-        pblock->nTime = GetAdjustedTime();
         const int64_t nMedianTimePast = pindexPrev->GetMedianTimePast();
-
-        // Add our coinbase tx as first transaction
-        pblock->vtx.push_back(txNew);
-        pblocktemplate->vTxFees.push_back(-1); // updated at end
-        pblocktemplate->vTxSigOps.push_back(-1); // updated at end
-        pblock->nVersion = ComputeBlockVersion(pindexPrev, chainparams.GetConsensus());
-        // -regtest only: allow overriding block.nVersion with
-        // -blockversion=N to test forking scenarios
-        if (chainparams.MineBlocksOnDemand())
-            pblock->nVersion = GetArg("-blockversion", pblock->nVersion);
+        StartBlock(pblocktemplate.get(), chainparams, pindexPrev);
 
         int64_t nLockTimeCutoff = (STANDARD_LOCKTIME_VERIFY_FLAGS & LOCKTIME_MEDIAN_TIME_PAST)
                                 ? nMedianTimePast
                                 : pblock->GetBlockTime();
+        unsigned int nMaxBlockSigOps = MaxBlockSigOps(fDIP0001ActiveAtTip);
 
+        bool fUpdated = false;
         {
-            LOCK(mempool.cs);
-
-            bool fPriorityBlock = nBlockPrioritySize > 0;
-            if (fPriorityBlock) {
-                vecPriority.reserve(mempool.mapTx.size());
-                for (CTxMemPool::indexed_transaction_set::iterator mi = mempool.mapTx.begin();
-                     mi != mempool.mapTx.end(); ++mi)
-                {
-                    double dPriority = mi->GetPriority(nHeight);
-                    CAmount dummy;
-                    mempool.ApplyDeltas(mi->GetTx().GetHash(), dPriority, dummy);
-                    vecPriority.push_back(TxCoinAgePriority(dPriority, mi));
-                }
-                std::make_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
+            LOCK2(mempool.cs, cs_template);
+            if (!fTemplateSignalsConnected) {
+                mempool.NotifyEntryAdded.connect(&TemplateEntryAdded);
+                mempool.NotifyEntryRemoved.connect(&TemplateEntryRemoved);
+                fTemplateSignalsConnected = true;
             }
 
-            CTxMemPool::indexed_transaction_set::nth_index<3>::type::iterator mi = mempool.mapTx.get<3>().begin();
-            CTxMemPool::txiter iter;
+            CTemplateState& state = templateState;
+            if (state.fValid && state.hashPrevBlock == pindexPrev->GetBlockHash() && state.nHeight == nHeight &&
+                state.nLockTimeCutoff == nLockTimeCutoff && state.nBlockMaxSize == nBlockMaxSize &&
+                state.nBlockMinSize == nBlockMinSize && state.nBlockPrioritySize == nBlockPrioritySize &&
+                state.nMaxBlockSigOps == nMaxBlockSigOps) {
+                fUpdated = UpdateTemplate(state);
+            }
+            if (!fUpdated) {
+                state.hashPrevBlock = pindexPrev->GetBlockHash();
+                state.nHeight = nHeight;
+                state.nLockTimeCutoff = nLockTimeCutoff;
+                state.nBlockMaxSize = nBlockMaxSize;
+                state.nBlockMinSize = nBlockMinSize;
+                state.nBlockPrioritySize = nBlockPrioritySize;
+                state.nMaxBlockSigOps = nMaxBlockSigOps;
+                state.fPrintPriority = fPrintPriority;
+                BuildTemplate(state);
+            }
 
-            while (mi != mempool.mapTx.get<3>().end() || !clearedTxs.empty())
-            {
-                bool priorityTx = false;
-                if (fPriorityBlock && !vecPriority.empty()) { // add a tx from priority queue to fill the blockprioritysize
-                    priorityTx = true;
-                    iter = vecPriority.front().second;
-                    actualPriority = vecPriority.front().first;
-                    std::pop_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
-                    vecPriority.pop_back();
-                }
-                else if (clearedTxs.empty()) { // add tx with next highest score
-                    iter = mempool.mapTx.project<0>(mi);
-                    mi++;
-                }
-                else {  // try to add a previously postponed child tx
-                    iter = clearedTxs.top();
-                    clearedTxs.pop();
-                }
+            pblock->vtx.insert(pblock->vtx.end(), state.vtx.begin(), state.vtx.end());
+            pblocktemplate->vTxFees.insert(pblocktemplate->vTxFees.end(), state.vTxFees.begin(), state.vTxFees.end());
+            pblocktemplate->vTxSigOps.insert(pblocktemplate->vTxSigOps.end(), state.vTxSigOps.begin(), state.vTxSigOps.end());
+            nBlockSize = state.nBlockSize;
+            nBlockSigOps = state.nBlockSigOps;
+            nFees = state.nFees;
+        }
+        int64_t nTime1 = GetTimeMicros();
 
-                if (inBlock.count(iter))
-                    continue; // could have been added to the priorityBlock
+        nLastBlockTx = pblock->vtx.size() - 1;
+        nLastBlockSize = nBlockSize;
+        LogPrintf("CreateNewBlock(): total size %u txs: %u fees: %ld sigops %d\n", nBlockSize, nLastBlockTx, nFees, nBlockSigOps);
 
-                const CTransaction& tx = iter->GetTx();
+        FinishBlock(pblocktemplate.get(), scriptPubKeyIn, chainparams, pindexPrev, nFees);
+        int64_t nTime2 = GetTimeMicros();
 
-                bool fOrphan = false;
-                BOOST_FOREACH(CTxMemPool::txiter parent, mempool.GetMemPoolParents(iter))
-                {
-                    if (!inBlock.count(parent)) {
-                        fOrphan = true;
-                        break;
-                    }
-                }
-                if (fOrphan) {
-                    if (priorityTx)
-                        waitPriMap.insert(std::make_pair(iter,actualPriority));
-                    else
-                        waitSet.insert(iter);
-                    continue;
-                }
+        CValidationState state;
+        if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
+            {
+                LOCK(cs_template);
+                templateState.fValid = false;
+            }
+            throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
+        }
+        int64_t nTime3 = GetTimeMicros();
+
+        LogPrint("bench", "CreateNewBlock() %s: select %.2fms, payments %.2fms, validity %.2fms (total %.2fms)\n",
+                 fUpdated ? "updated" : "built", 0.001 * (nTime1 - nTimeStart), 0.001 * (nTime2 - nTime1),
+                 0.001 * (nTime3 - nTime2), 0.001 * (nTime3 - nTimeStart));
+        LOCK(cs_template);
+        if (fUpdated)
+            templateStats.nUpdates++;
+        else
+            templateStats.nBuilds++;
+        templateStats.fLastUpdated = fUpdated;
+        templateStats.nLastSelectMicros = nTime1 - nTimeStart;
+        templateStats.nLastPaymentsMicros = nTime2 - nTime1;
+        templateStats.nLastValidityMicros = nTime3 - nTime2;
+        templateStats.nLastTotalMicros = nTime3 - nTimeStart;
+    }
 
-                unsigned int nTxSize = iter->GetTxSize();
-                if (fPriorityBlock &&
-                    (nBlockSize + nTxSize >= nBlockPrioritySize || !AllowFree(actualPriority))) {
-                    fPriorityBlock = false;
-                    waitPriMap.clear();
-                }
-                if (!priorityTx &&
-                    (iter->GetModifiedFee() < ::minRelayTxFee.GetFee(nTxSize) && nBlockSize >= nBlockMinSize)) {
-                    break;
-                }
-                if (nBlockSize + nTxSize >= nBlockMaxSize) {
-                    if (nBlockSize >  nBlockMaxSize - 100 || lastFewTxs > 50) {
-                        break;
-                    }
-                    // Once we're within 1000 bytes of a full block, only look at 50 more txs
-                    // to try to fill the remaining space.
-                    if (nBlockSize > nBlockMaxSize - 1000) {
-                        lastFewTxs++;
-                    }
-                    continue;
-                }
+    return pblocktemplate.release();
+}
 
-                if (!IsFinalTx(tx, nHeight, nLockTimeCutoff))
-                    continue;
+CBlockTemplate* CreateEmptyBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn)
+{
+    std::unique_ptr<CBlockTemplate> pblocktemplate(new CBlockTemplate());
 
-                unsigned int nTxSigOps = iter->GetSigOpCount();
-                unsigned int nMaxBlockSigOps = MaxBlockSigOps(fDIP0001ActiveAtTip);
-                if (nBlockSigOps + nTxSigOps >= nMaxBlockSigOps) {
-                    if (nBlockSigOps > nMaxBlockSigOps - 2) {
-                        break;
-                    }
-                    continue;
-                }
+    LOCK(cs_main);
+    CBlockIndex* pindexPrev = chainActive.Tip();
+    StartBlock(pblocktemplate.get(), chainparams, pindexPrev);
+    // Without transactions there are no fees, the subsidy still has to be split up correctly
+    FinishBlock(pblocktemplate.get(), scriptPubKeyIn, chainparams, pindexPrev, 0);
 
-                CAmount nTxFees = iter->GetFee();
-                // Added
-                pblock->vtx.push_back(tx);
-                pblocktemplate->vTxFees.push_back(nTxFees);
-                pblocktemplate->vTxSigOps.push_back(nTxSigOps);
-                nBlockSize += nTxSize;
-                ++nBlockTx;
-                nBlockSigOps += nTxSigOps;
-                nFees += nTxFees;
-
-                if (fPrintPriority)
-                {
-                    double dPriority = iter->GetPriority(nHeight);
-                    CAmount dummy;
-                    mempool.ApplyDeltas(tx.GetHash(), dPriority, dummy);
-                    LogPrintf("priority %.1f fee %s txid %s\n",
-                              dPriority , CFeeRate(iter->GetModifiedFee(), nTxSize).ToString(), tx.GetHash().ToString());
-                }
+    CValidationState state;
+    if (!TestBlockValidity(state, chainparams, pblocktemplate->block, pindexPrev, false, false))
+        throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
+    LogPrint("bench", "CreateEmptyBlock(): height %d\n", pindexPrev->nHeight + 1);
 
-                inBlock.insert(iter);
+    return pblocktemplate.release();
+}
 
-                // Add transactions that depend on this one to the priority queue
-                BOOST_FOREACH(CTxMemPool::txiter child, mempool.GetMemPoolChildren(iter))
-                {
-                    if (fPriorityBlock) {
-                        waitPriIter wpiter = waitPriMap.find(child);
-                        if (wpiter != waitPriMap.end()) {
-                            vecPriority.push_back(TxCoinAgePriority(wpiter->second,child));
-                            std::push_heap(vecPriority.begin(), vecPriority.end(), pricomparer);
-                            waitPriMap.erase(wpiter);
-                        }
-                    }
-                    else {
-                        if (waitSet.count(child)) {
-                            clearedTxs.push(child);
-                            waitSet.erase(child);
-                        }
-                    }
-                }
-            }
+CBlockTemplatePrebuilder* pblocktemplatePrebuilder = NULL;
 
-        }
+CBlockTemplatePrebuilder::CBlockTemplatePrebuilder(const CChainParams& chainparamsIn, const CScript& scriptPubKeyIn) :
+    chainparams(chainparamsIn), scriptPubKey(scriptPubKeyIn), pindexPending(NULL), pindexBuilding(NULL), fStop(false)
+{
+    thread = boost::thread(boost::bind(&CBlockTemplatePrebuilder::ThreadBuild, this));
+}
 
-        // NOTE: unlike in bitcoin, we need to pass PREVIOUS block height here
-        CAmount blockReward = nFees + GetBlockSubsidy(pindexPrev->nBits, pindexPrev->nHeight, Params().GetConsensus());
+CBlockTemplatePrebuilder::~CBlockTemplatePrebuilder()
+{
+    boost::this_thread::disable_interruption di;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStop = true;
+    }
+    condWork.notify_all();
+    thread.join();
+}
 
-        // Compute regular coinbase transaction.
-        txNew.vout[0].nValue = blockReward;
-        txNew.vin[0].scriptSig = CScript() << nHeight << OP_0;
+void CBlockTemplatePrebuilder::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    if (fInitialDownload)
+        return;
+    Request(pindexNew);
+}
 
-        // Update coinbase transaction with additional info about masternode and governance payments,
-        // get some info back to pass to getblocktemplate
-        FillBlockPayments(txNew, nHeight, blockReward, pblock->txoutMasternode, pblock->voutSuperblock);
-        // LogPrintf("CreateNewBlock -- nBlockHeight %d blockReward %lld txoutMasternode %s txNew %s",
-        //             nHeight, blockReward, pblock->txoutMasternode.ToString(), txNew.ToString());
+void CBlockTemplatePrebuilder::Request(const CBlockIndex* pindexPrev)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        // getblocktemplate may have asked for this tip before the notification came
+        if (pindexPrev == pindexPending || pindexPrev == pindexBuilding ||
+            (pblocktemplate && pblocktemplate->block.hashPrevBlock == pindexPrev->GetBlockHash()))
+            return;
+        // only the latest tip is worth building for
+        pindexPending = pindexPrev;
+    }
+    condWork.notify_all();
+}
 
-        nLastBlockTx = nBlockTx;
-        nLastBlockSize = nBlockSize;
-        LogPrintf("CreateNewBlock(): total size %u txs: %u fees: %ld sigops %d\n", nBlockSize, nBlockTx, nFees, nBlockSigOps);
+void CBlockTemplatePrebuilder::ThreadBuild()
+{
+    RenameThread("chainox-prebuild");
 
-        // Update block coinbase
-        pblock->vtx[0] = txNew;
-        pblocktemplate->vTxFees[0] = -nFees;
+    while (true) {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && !pindexPending)
+                condWork.wait(lock);
+            if (fStop)
+                return;
+            pindexBuilding = pindexPending;
+            pindexPending = NULL;
+        }
 
-        // Fill in header
-        pblock->hashPrevBlock  = pindexPrev->GetBlockHash();
-        UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev);
-        pblock->nBits          = GetNextWorkRequired(pindexPrev, pblock, chainparams.GetConsensus());
-        pblock->nNonce         = 0;
-        pblocktemplate->vTxSigOps[0] = GetLegacySigOpCount(pblock->vtx[0]);
+        std::unique_ptr<CBlockTemplate> pblocktemplateNew;
+        try {
+            pblocktemplateNew.reset(CreateNewBlock(chainparams, scriptPubKey));
+        } catch (const std::exception& e) {
+            // getblocktemplate builds it again and reports the error
+            LogPrintf("%s: %s\n", __func__, e.what());
+        }
 
-        CValidationState state;
-        if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
-            throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            pindexBuilding = NULL;
+            // the tip may have moved on meanwhile, TakeTemplate checks what it was built on
+            if (pblocktemplateNew)
+                pblocktemplate = std::move(pblocktemplateNew);
+        }
+        // Wake up longpolls waiting for the full template
+        {
+            boost::unique_lock<boost::mutex> lock(csBestBlock);
+            cvBlockChange.notify_all();
         }
     }
+}
 
+bool CBlockTemplatePrebuilder::IsBuilding(const CBlockIndex* pindexPrev) const
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return pindexPrev == pindexPending || pindexPrev == pindexBuilding;
+}
+
+bool CBlockTemplatePrebuilder::HaveTemplate(const CBlockIndex* pindexPrev) const
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return pblocktemplate && pblocktemplate->block.hashPrevBlock == pindexPrev->GetBlockHash();
+}
+
+CBlockTemplate* CBlockTemplatePrebuilder::TakeTemplate(const CBlockIndex* pindexPrev)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (!pblocktemplate || pblocktemplate->block.hashPrevBlock != pindexPrev->GetBlockHash())
+        return NULL;
     return pblocktemplate.release();
 }
 
@@ -330,11 +722,11 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     }
     ++nExtraNonce;
     unsigned int nHeight = pindexPrev->nHeight+1; // Height first in coinbase required for block.version=2
-    CMutableTransaction txCoinbase(pblock->vtx[0]);
+    CMutableTransaction txCoinbase(*pblock->vtx[0]);
     txCoinbase.vin[0].scriptSig = (CScript() << nHeight << CScriptNum(nExtraNonce)) + COINBASE_FLAGS;
     assert(txCoinbase.vin[0].scriptSig.size() <= 100);
 
-    pblock->vtx[0] = txCoinbase;
+    pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
 
@@ -343,44 +735,81 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
 // Internal miner
 //
 
-// ***TODO*** ScanHash is not yet used in Chainox
-//
-// ScanHash scans nonces looking for a hash with at least some zero bits.
-// The nonce is usually preserved between calls, but periodically or if the
-// nonce is 0xffff0000 or above, the block is rebuilt and nNonce starts over at
-// zero.
-//
-//bool static ScanHash(const CBlockHeader *pblock, uint32_t& nNonce, uint256 *phash)
-//{
-//    // Write the first 76 bytes of the block header to a double-SHA256 state.
-//    CHash256 hasher;
-//    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-//    ss << *pblock;
-//    assert(ss.size() == 80);
-//    hasher.Write((unsigned char*)&ss[0], 76);
-
-//    while (true) {
-//        nNonce++;
-
-//        // Write the last 4 bytes of the block header (the nonce) to a copy of
-//        // the double-SHA256 state, and compute the result.
-//        CHash256(hasher).Write((unsigned char*)&nNonce, 4).Finalize((unsigned char*)phash);
-
-//        // Return the nonce if the hash has at least some zero bits,
-//        // caller will check if it has enough to reach the target
-//        if (((uint16_t*)phash)[15] == 0)
-//            return true;
-
-//        // Ichoxthing found after trying for a while, return -1
-//        if ((nNonce & 0xfff) == 0)
-//            return false;
-//    }
-//}
+CNonceScanner::CNonceScanner(const CBlockHeader& header) :
+    fPhiCHOX(header.nTime >= PHICHOX_START_TIME),
+    phichox(header.nTime, *header.hashPrevBlock.begin())
+{
+    // Hash the first 76 bytes of the header (everything but nNonce) once
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << header;
+    assert(ss.size() == 80);
+    if (fPhiCHOX)
+        phichox.Write((unsigned char*)&ss[0], 76);
+    else
+        sha256d.Write((unsigned char*)&ss[0], 76);
+}
+
+template<typename Hasher>
+static bool ScanNonces(const Hasher& midstate, uint32_t& nNonce, uint32_t nCount, const arith_uint256& hashTarget, uint256& hash)
+{
+    unsigned char vchNonce[4];
+    for (uint32_t i = 0; i < nCount; i++, nNonce++) {
+        // Finish a copy of the midstate with the last 4 bytes of the header
+        WriteLE32(vchNonce, nNonce);
+        Hasher(midstate).Write(vchNonce, sizeof(vchNonce)).Finalize(hash.begin());
+        if (UintToArith256(hash) <= hashTarget)
+            return true;
+    }
+    return false;
+}
+
+bool CNonceScanner::Scan(uint32_t& nNonce, uint32_t nCount, const arith_uint256& hashTarget, uint256& hash) const
+{
+    if (fPhiCHOX)
+        return ScanNonces(phichox, nNonce, nCount, hashTarget, hash);
+    return ScanNonces(sha256d, nNonce, nCount, hashTarget, hash);
+}
+
+static CCriticalSection cs_hashmeter;
+static int64_t nHashMeterStart = 0;
+static uint64_t nHashMeterCount = 0;
+static double dHashesPerSec = 0;
+
+void UpdateHashesPerSec(uint64_t nHashes)
+{
+    LOCK(cs_hashmeter);
+    int64_t nNow = GetTimeMillis();
+    if (nHashMeterStart == 0) {
+        nHashMeterStart = nNow;
+        nHashMeterCount = 0;
+    }
+    nHashMeterCount += nHashes;
+    if (nNow - nHashMeterStart > 4000) {
+        dHashesPerSec = 1000.0 * nHashMeterCount / (nNow - nHashMeterStart);
+        nHashMeterStart = nNow;
+        nHashMeterCount = 0;
+        LogPrint("mining", "%s -- %.0f hashes/s\n", __func__, dHashesPerSec);
+    }
+}
+
+double GetHashesPerSec()
+{
+    LOCK(cs_hashmeter);
+    return dHashesPerSec;
+}
+
+static void ResetHashesPerSec()
+{
+    LOCK(cs_hashmeter);
+    nHashMeterStart = 0;
+    nHashMeterCount = 0;
+    dHashesPerSec = 0;
+}
 
 static bool ProcessBlockFound(const CBlock* pblock, const CChainParams& chainparams)
 {
     LogPrintf("%s\n", pblock->ToString());
-    LogPrintf("generated %s\n", FormatMoney(pblock->vtx[0].vout[0].nValue));
+    LogPrintf("generated %s\n", FormatMoney(pblock->vtx[0]->vout[0].nValue));
 
     // Found a solution
     {
@@ -456,34 +885,28 @@ void static BitcoinMiner(const CChainParams& chainparams, CConnman& connman)
             //
             int64_t nStart = GetTime();
             arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+            CNonceScanner scanner(*pblock);
             while (true)
             {
-                unsigned int nHashesDone = 0;
-
                 uint256 hash;
-                while (true)
+                uint32_t nNonceStart = pblock->nNonce;
+                bool fFound = scanner.Scan(pblock->nNonce, MINER_SCAN_BATCH_SIZE, hashTarget, hash);
+                UpdateHashesPerSec(pblock->nNonce - nNonceStart + (fFound ? 1 : 0));
+                if (fFound)
                 {
-                    hash = pblock->GetHash();
-                    if (UintToArith256(hash) <= hashTarget)
-                    {
-                        // Found a solution
-                        SetThreadPriority(THREAD_PRIORITY_NORMAL);
-                        LogPrintf("ChainoxMiner:\n  proof-of-work found\n  hash: %s\n  target: %s\n", hash.GetHex(), hashTarget.GetHex());
-                        ProcessBlockFound(pblock, chainparams);
-                        SetThreadPriority(THREAD_PRIORITY_LOWEST);
-                        coinbaseScript->KeepScript();
-
-                        // In regression test mode, stop mining after a block is found. This
-                        // allows developers to controllably generate a block on demand.
-                        if (chainparams.MineBlocksOnDemand())
-                            throw boost::thread_interrupted();
+                    // Found a solution
+                    SetThreadPriority(THREAD_PRIORITY_NORMAL);
+                    LogPrintf("ChainoxMiner:\n  proof-of-work found\n  hash: %s\n  target: %s\n", hash.GetHex(), hashTarget.GetHex());
+                    ProcessBlockFound(pblock, chainparams);
+                    SetThreadPriority(THREAD_PRIORITY_LOWEST);
+                    coinbaseScript->KeepScript();
+
+                    // In regression test mode, stop mining after a block is found. This
+                    // allows developers to controllably generate a block on demand.
+                    if (chainparams.MineBlocksOnDemand())
+                        throw boost::thread_interrupted();
 
-                        break;
-                    }
-                    pblock->nNonce += 1;
-                    nHashesDone += 1;
-                    if ((pblock->nNonce & 0xFF) == 0)
-                        break;
+                    break;
                 }
 
                 // Check for stop or if block needs to be rebuilt
@@ -499,13 +922,19 @@ void static BitcoinMiner(const CChainParams& chainparams, CConnman& connman)
                     break;
 
                 // Update nTime every few seconds
-                if (UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev) < 0)
+                int64_t nTimeDelta = UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev);
+                if (nTimeDelta < 0)
                     break; // Recreate the block if the clock has run backwards,
                            // so that we can use the correct time.
-                if (chainparams.GetConsensus().fPowAllowMinDifficultyBlocks)
+                if (nTimeDelta > 0)
                 {
-                    // Changing pblock->nTime can change work required on testnet:
-                    hashTarget.SetCompact(pblock->nBits);
+                    if (chainparams.GetConsensus().fPowAllowMinDifficultyBlocks)
+                    {
+                        // Changing pblock->nTime can change work required on testnet:
+                        hashTarget.SetCompact(pblock->nBits);
+                    }
+                    // The header changed, so its midstate has to be recomputed
+                    scanner = CNonceScanner(*pblock);
                 }
             }
         }
@@ -534,6 +963,7 @@ void GenerateBitcoins(bool fGenerate, int nThreads, const CChainParams& chainpar
         minerThreads->interrupt_all();
         delete minerThreads;
         minerThreads = NULL;
+        ResetHashesPerSec();
     }
 
     if (nThreads == 0 || !fGenerate)
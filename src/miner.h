@@ -6,15 +6,23 @@
 #ifndef BITCOIN_MINER_H
 #define BITCOIN_MINER_H
 
+#include "arith_uint256.h"
+#include "crypto/phichox.h"
+#include "hash.h"
 #include "primitives/block.h"
+#include "script/script.h"
+#include "validationinterface.h"
 
 #include <stdint.h>
 
+#include <memory>
+
+#include <boost/thread.hpp>
+
 class CBlockIndex;
 class CChainParams;
 class CConnman;
 class CReserveKey;
-class CScript;
 class CWallet;
 namespace Consensus { struct Params; };
 
@@ -23,6 +31,15 @@ static const int DEFAULT_GENERATE_THREADS = 1;
 
 static const bool DEFAULT_PRINTPRIORITY = false;
 
+/** -fasttemplates default, serve a coinbase-only template for a new tip until the full one was built in the background */
+static const bool DEFAULT_FAST_TEMPLATES = false;
+
+/** Transactions entering the mempool after which the template is built again rather than updated */
+static const unsigned int MAX_TEMPLATE_UPDATE_TXS = 10000;
+
+/** Number of nonces the internal miner tries between checks for a new tip, a stale template or shutdown */
+static const uint32_t MINER_SCAN_BATCH_SIZE = 0x1000;
+
 struct CBlockTemplate
 {
     CBlock block;
@@ -30,12 +47,123 @@ struct CBlockTemplate
     std::vector<int64_t> vTxSigOps;
 };
 
+/** How CreateNewBlock made its templates, and how long the stages of the last one took */
+struct CBlockTemplateStats
+{
+    //! Templates selected from the whole mempool, for a new tip or after changes an update can't follow
+    uint64_t nBuilds;
+    //! Templates that only added the transactions that entered the mempool since the previous one
+    uint64_t nUpdates;
+    bool fLastUpdated;
+    //! Selecting the transactions
+    int64_t nLastSelectMicros;
+    //! Coinbase with the masternode and superblock payments
+    int64_t nLastPaymentsMicros;
+    //! TestBlockValidity
+    int64_t nLastValidityMicros;
+    int64_t nLastTotalMicros;
+
+    CBlockTemplateStats() : nBuilds(0), nUpdates(0), fLastUpdated(false), nLastSelectMicros(0),
+        nLastPaymentsMicros(0), nLastValidityMicros(0), nLastTotalMicros(0) {}
+};
+
+/** Proof-of-work nonce scanner for a fixed block header.
+ *
+ * Everything that does not depend on nNonce is computed once on construction:
+ * the hashing algorithm (double SHA-256 or the phiCHOX branch for this nTime
+ * and hashPrevBlock) and the hasher state after the first 76 header bytes.
+ * Each nonce then only costs finishing that midstate. Construct a new scanner
+ * whenever any header field other than nNonce changes.
+ */
+class CNonceScanner
+{
+private:
+    bool fPhiCHOX;
+    CPhiCHOX phichox;
+    CHash256 sha256d;
+
+public:
+    CNonceScanner(const CBlockHeader& header);
+
+    /**
+     * Try nonces nNonce, nNonce + 1, ... for at most nCount nonces. If one of
+     * them hashes to at most hashTarget, return true with nNonce and hash set
+     * to it. Otherwise return false with nNonce just past the scanned range.
+     */
+    bool Scan(uint32_t& nNonce, uint32_t nCount, const arith_uint256& hashTarget, uint256& hash) const;
+};
+
+/**
+ * Builds the block template for a new tip in the background as soon as the
+ * tip changes, so that getblocktemplate doesn't have to select the
+ * transactions while miners wait for work on the new tip.
+ */
+class CBlockTemplatePrebuilder final : public CValidationInterface
+{
+private:
+    const CChainParams& chainparams;
+    const CScript scriptPubKey;
+
+    mutable boost::mutex mutex;
+    boost::condition_variable condWork;
+    //! Tip a template is to be built for next
+    const CBlockIndex* pindexPending;
+    //! Tip the template is being built for
+    const CBlockIndex* pindexBuilding;
+    //! The last template built, until it is taken
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+    bool fStop;
+
+    boost::thread thread;
+
+    CBlockTemplatePrebuilder(const CBlockTemplatePrebuilder&);
+    CBlockTemplatePrebuilder& operator=(const CBlockTemplatePrebuilder&);
+
+    void ThreadBuild();
+
+protected:
+    // CValidationInterface
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+
+public:
+    CBlockTemplatePrebuilder(const CChainParams& chainparamsIn, const CScript& scriptPubKeyIn);
+    ~CBlockTemplatePrebuilder();
+
+    /** Build a template for pindexPrev in the background, unless it is built or being built already */
+    void Request(const CBlockIndex* pindexPrev);
+    /** Whether a template for pindexPrev is still being built */
+    bool IsBuilding(const CBlockIndex* pindexPrev) const;
+    /** Whether the template for pindexPrev is ready to be taken */
+    bool HaveTemplate(const CBlockIndex* pindexPrev) const;
+    /** Hand over the template built for pindexPrev, NULL if there is none */
+    CBlockTemplate* TakeTemplate(const CBlockIndex* pindexPrev);
+};
+
+/** Set when -fasttemplates is enabled */
+extern CBlockTemplatePrebuilder* pblocktemplatePrebuilder;
+
 /** Run the miner threads */
 void GenerateBitcoins(bool fGenerate, int nThreads, const CChainParams& chainparams, CConnman& connman);
-/** Generate a new block, without valid proof-of-work */
+/**
+ * Generate a new block, without valid proof-of-work. Transactions are selected
+ * by the fee rate of their package of unconfirmed ancestors. While the tip
+ * stays the same, the previous selection is extended with the transactions
+ * that entered the mempool since, instead of selecting from scratch.
+ */
 CBlockTemplate* CreateNewBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn);
+/**
+ * Generate a new block with only the coinbase, paying the subsidy with the
+ * masternode and superblock shares. Used while the full template for a new
+ * tip is still being built.
+ */
+CBlockTemplate* CreateEmptyBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn);
+CBlockTemplateStats GetBlockTemplateStats();
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
+/** Add nHashes to the hash meter shared by the internal miner and the generate RPC */
+void UpdateHashesPerSec(uint64_t nHashes);
+/** Hashes per second over all mining threads, as of the last hash meter update */
+double GetHashesPerSec();
 
 #endif // BITCOIN_MINER_H
@@ -33,6 +33,10 @@
 #include <fcntl.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/miniwget.h>
@@ -427,6 +431,7 @@ CNode* CConnman::ConnectNode(CAddress addrConnect, const char *pszDest, bool fCo
         GetNodeSignals().InitializeNode(pnode, *this);
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterSocketEvents(pnode);
 
         return pnode;
     } else if (!proxyConnectionFailed) {
@@ -1102,285 +1107,470 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
     {
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterSocketEvents(pnode);
     }
 }
 
-void CConnman::ThreadSocketHandler()
+void CConnman::RegisterSocketEvents(CNode *pnode)
+{
+    AssertLockHeld(cs_vNodes);
+#ifdef USE_EPOLL
+    mapNodesById[pnode->id] = pnode;
+
+    // Registered once for the lifetime of the socket, closing it removes it from the set
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = pnode->id;
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, pnode->hSocket, &event) != 0) {
+        LogPrintf("epoll_ctl failed for peer=%d: %s\n", pnode->id, NetworkErrorString(WSAGetLastError()));
+        pnode->fDisconnect = true;
+    }
+#endif
+}
+
+void CConnman::DisconnectNodes()
 {
-    unsigned int nPrevNodeCount = 0;
-    while (!interruptNet)
     {
-        //
-        // Disconnect nodes
-        //
+        LOCK(cs_vNodes);
+        // Disconnect unused nodes
+        std::vector<CNode*> vNodesCopy = vNodes;
+        BOOST_FOREACH(CNode* pnode, vNodesCopy)
         {
-            LOCK(cs_vNodes);
-            // Disconnect unused nodes
-            std::vector<CNode*> vNodesCopy = vNodes;
-            BOOST_FOREACH(CNode* pnode, vNodesCopy)
+            if (pnode->fDisconnect)
             {
-                if (pnode->fDisconnect)
-                {
-                    LogPrintf("ThreadSocketHandler -- removing node: peer=%d addr=%s nRefCount=%d fNetworkNode=%d fInbound=%d fMasternode=%d\n",
-                              pnode->id, pnode->addr.ToString(), pnode->GetRefCount(), pnode->fNetworkNode, pnode->fInbound, pnode->fMasternode);
+                LogPrintf("ThreadSocketHandler -- removing node: peer=%d addr=%s nRefCount=%d fNetworkNode=%d fInbound=%d fMasternode=%d\n",
+                          pnode->id, pnode->addr.ToString(), pnode->GetRefCount(), pnode->fNetworkNode, pnode->fInbound, pnode->fMasternode);
 
-                    // remove from vNodes
-                    vNodes.erase(remove(vNodes.begin(), vNodes.end(), pnode), vNodes.end());
+                // remove from vNodes
+                vNodes.erase(remove(vNodes.begin(), vNodes.end(), pnode), vNodes.end());
+#ifdef USE_EPOLL
+                mapNodesById.erase(pnode->id);
+#endif
 
-                    // release outbound grant (if any)
-                    pnode->grantOutbound.Release();
-                    pnode->grantMasternodeOutbound.Release();
+                // release outbound grant (if any)
+                pnode->grantOutbound.Release();
+                pnode->grantMasternodeOutbound.Release();
 
-                    // close socket and cleanup
-                    pnode->CloseSocketDisconnect();
+                // close socket and cleanup
+                pnode->CloseSocketDisconnect();
 
-                    // hold in disconnected pool until all refs are released
-                    if (pnode->fNetworkNode || pnode->fInbound)
-                        pnode->Release();
-                    if (pnode->fMasternode)
-                        pnode->Release();
-                    vNodesDisconnected.push_back(pnode);
-                }
+                // hold in disconnected pool until all refs are released
+                if (pnode->fNetworkNode || pnode->fInbound)
+                    pnode->Release();
+                if (pnode->fMasternode)
+                    pnode->Release();
+                vNodesDisconnected.push_back(pnode);
             }
         }
+    }
+    {
+        // Delete disconnected nodes
+        std::list<CNode*> vNodesDisconnectedCopy = vNodesDisconnected;
+        BOOST_FOREACH(CNode* pnode, vNodesDisconnectedCopy)
         {
-            // Delete disconnected nodes
-            std::list<CNode*> vNodesDisconnectedCopy = vNodesDisconnected;
-            BOOST_FOREACH(CNode* pnode, vNodesDisconnectedCopy)
+            // wait until threads are done using it
+            if (pnode->GetRefCount() <= 0)
             {
-                // wait until threads are done using it
-                if (pnode->GetRefCount() <= 0)
+                bool fDelete = false;
                 {
-                    bool fDelete = false;
-                    {
-                        TRY_LOCK(pnode->cs_vSend, lockSend);
-                        if (lockSend)
-                        {
-                                TRY_LOCK(pnode->cs_inventory, lockInv);
-                                if (lockInv)
-                                    fDelete = true;
-                        }
-                    }
-                    if (fDelete)
+                    TRY_LOCK(pnode->cs_vSend, lockSend);
+                    if (lockSend)
                     {
-                        vNodesDisconnected.remove(pnode);
-                        DeleteNode(pnode);
+                            TRY_LOCK(pnode->cs_inventory, lockInv);
+                            if (lockInv)
+                                fDelete = true;
                     }
                 }
+                if (fDelete)
+                {
+                    vNodesDisconnected.remove(pnode);
+                    DeleteNode(pnode);
+                }
             }
         }
-        size_t vNodesSize;
+    }
+}
+
+void CConnman::NotifyNumConnectionsChanged()
+{
+    size_t vNodesSize;
+    {
+        LOCK(cs_vNodes);
+        vNodesSize = vNodes.size();
+    }
+    if(vNodesSize != nPrevNodeCount) {
+        nPrevNodeCount = vNodesSize;
+        if(clientInterface)
+            clientInterface->NotifyNumConnectionsChanged(nPrevNodeCount);
+    }
+}
+
+void CConnman::InactivityCheck(CNode *pnode)
+{
+    int64_t nTime = GetSystemTimeInSeconds();
+    if (nTime - pnode->nTimeConnected > 60)
+    {
+        if (pnode->nLastRecv == 0 || pnode->nLastSend == 0)
         {
-            LOCK(cs_vNodes);
-            vNodesSize = vNodes.size();
+            LogPrint("net", "socket no message in first 60 seconds, %d %d from %d\n", pnode->nLastRecv != 0, pnode->nLastSend != 0, pnode->id);
+            pnode->fDisconnect = true;
         }
-        if(vNodesSize != nPrevNodeCount) {
-            nPrevNodeCount = vNodesSize;
-            if(clientInterface)
-                clientInterface->NotifyNumConnectionsChanged(nPrevNodeCount);
+        else if (nTime - pnode->nLastSend > TIMEOUT_INTERVAL)
+        {
+            LogPrintf("socket sending timeout: %is\n", nTime - pnode->nLastSend);
+            pnode->fDisconnect = true;
         }
+        else if (nTime - pnode->nLastRecv > (pnode->nVersion > BIP0031_VERSION ? TIMEOUT_INTERVAL : 90*60))
+        {
+            LogPrintf("socket receive timeout: %is\n", nTime - pnode->nLastRecv);
+            pnode->fDisconnect = true;
+        }
+        else if (pnode->nPingNonceSent && pnode->nPingUsecStart + TIMEOUT_INTERVAL * 1000000 < GetTimeMicros())
+        {
+            LogPrintf("ping timeout: %fs\n", 0.000001 * (GetTimeMicros() - pnode->nPingUsecStart));
+            pnode->fDisconnect = true;
+        }
+    }
+}
 
-        //
-        // Find which sockets have data to receive
-        //
-        struct timeval timeout;
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 50000; // frequency to poll pnode->vSend
-
-        fd_set fdsetRecv;
-        fd_set fdsetSend;
-        fd_set fdsetError;
-        FD_ZERO(&fdsetRecv);
-        FD_ZERO(&fdsetSend);
-        FD_ZERO(&fdsetError);
-        SOCKET hSocketMax = 0;
-        bool have_fds = false;
-
-        BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket) {
-            FD_SET(hListenSocket.socket, &fdsetRecv);
-            hSocketMax = std::max(hSocketMax, hListenSocket.socket);
-            have_fds = true;
+/** Read one buffer worth of data from the socket, returns true if it was filled and more may be waiting */
+bool CConnman::SocketRecvData(CNode *pnode)
+{
+    // typical socket buffer is 8K-64K
+    char pchBuf[0x10000];
+    int nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+    if (nBytes > 0)
+    {
+        bool notify = false;
+        if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
+            pnode->CloseSocketDisconnect();
+        RecordBytesRecv(nBytes);
+        if (notify) {
+            size_t nSizeAdded = 0;
+            auto it(pnode->vRecvMsg.begin());
+            for (; it != pnode->vRecvMsg.end(); ++it) {
+                if (!it->complete())
+                    break;
+                nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
+            }
+            {
+                LOCK(pnode->cs_vProcessMsg);
+                pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
+                pnode->nProcessQueueSize += nSizeAdded;
+                pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
+            }
+            WakeMessageHandler();
         }
+        return nBytes == (int)sizeof(pchBuf) && !pnode->fDisconnect;
+    }
+    else if (nBytes == 0)
+    {
+        // socket closed gracefully
+        if (!pnode->fDisconnect)
+            LogPrint("net", "socket closed\n");
+        pnode->CloseSocketDisconnect();
+    }
+    else if (nBytes < 0)
+    {
+        // error
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
+        {
+            if (!pnode->fDisconnect)
+                LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
+            pnode->CloseSocketDisconnect();
+        }
+        else if (nErr == WSAEINTR)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CConnman::SocketHandlerSelect()
+{
+    //
+    // Find which sockets have data to receive
+    //
+    struct timeval timeout;
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = 50000; // frequency to poll pnode->vSend
+
+    fd_set fdsetRecv;
+    fd_set fdsetSend;
+    fd_set fdsetError;
+    FD_ZERO(&fdsetRecv);
+    FD_ZERO(&fdsetSend);
+    FD_ZERO(&fdsetError);
+    SOCKET hSocketMax = 0;
+    bool have_fds = false;
+
+    BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket) {
+        FD_SET(hListenSocket.socket, &fdsetRecv);
+        hSocketMax = std::max(hSocketMax, hListenSocket.socket);
+        have_fds = true;
+    }
 
+    {
+        LOCK(cs_vNodes);
+        BOOST_FOREACH(CNode* pnode, vNodes)
         {
-            LOCK(cs_vNodes);
-            BOOST_FOREACH(CNode* pnode, vNodes)
+            if (pnode->hSocket == INVALID_SOCKET)
+                continue;
+            FD_SET(pnode->hSocket, &fdsetError);
+            hSocketMax = std::max(hSocketMax, pnode->hSocket);
+            have_fds = true;
+
+            // Implement the following logic:
+            // * If there is data to send, select() for sending data. As this only
+            //   happens when optimistic write failed, we choose to first drain the
+            //   write buffer in this case before receiving more. This avoids
+            //   needlessly queueing received data, if the remote peer is not themselves
+            //   receiving data. This means properly utilizing TCP flow control signalling.
+            // * Otherwise, if there is space left in the receive buffer, select() for
+            //   receiving data.
+            // * Hand off all complete messages to the processor, to be handled without
+            //   blocking here.
             {
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-                FD_SET(pnode->hSocket, &fdsetError);
-                hSocketMax = std::max(hSocketMax, pnode->hSocket);
-                have_fds = true;
-
-                // Implement the following logic:
-                // * If there is data to send, select() for sending data. As this only
-                //   happens when optimistic write failed, we choose to first drain the
-                //   write buffer in this case before receiving more. This avoids
-                //   needlessly queueing received data, if the remote peer is not themselves
-                //   receiving data. This means properly utilizing TCP flow control signalling.
-                // * Otherwise, if there is space left in the receive buffer, select() for
-                //   receiving data.
-                // * Hand off all complete messages to the processor, to be handled without
-                //   blocking here.
-                {
-                    TRY_LOCK(pnode->cs_vSend, lockSend);
-                    if (lockSend) {
-                        if (!pnode->vSendMsg.empty()) {
-                            FD_SET(pnode->hSocket, &fdsetSend);
-                            continue;
-                        }
+                TRY_LOCK(pnode->cs_vSend, lockSend);
+                if (lockSend) {
+                    if (!pnode->vSendMsg.empty()) {
+                        FD_SET(pnode->hSocket, &fdsetSend);
+                        continue;
                     }
                 }
-                {
-                    if (!pnode->fPauseRecv)
-                        FD_SET(pnode->hSocket, &fdsetRecv);
-                }
+            }
+            {
+                if (!pnode->fPauseRecv)
+                    FD_SET(pnode->hSocket, &fdsetRecv);
             }
         }
+    }
 
-        int nSelect = select(have_fds ? hSocketMax + 1 : 0,
-                             &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
-        if (interruptNet)
+    int nSelect = select(have_fds ? hSocketMax + 1 : 0,
+                         &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+    if (interruptNet)
+        return;
+
+    if (nSelect == SOCKET_ERROR)
+    {
+        if (have_fds)
+        {
+            int nErr = WSAGetLastError();
+            LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
+            for (unsigned int i = 0; i <= hSocketMax; i++)
+                FD_SET(i, &fdsetRecv);
+        }
+        FD_ZERO(&fdsetSend);
+        FD_ZERO(&fdsetError);
+        if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
             return;
+    }
 
-        if (nSelect == SOCKET_ERROR)
+    //
+    // Accept new connections
+    //
+    BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket)
+    {
+        if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
         {
-            if (have_fds)
-            {
-                int nErr = WSAGetLastError();
-                LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
-                for (unsigned int i = 0; i <= hSocketMax; i++)
-                    FD_SET(i, &fdsetRecv);
-            }
-            FD_ZERO(&fdsetSend);
-            FD_ZERO(&fdsetError);
-            if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
-                return;
+            AcceptConnection(hListenSocket);
         }
+    }
+
+    //
+    // Service each socket
+    //
+    std::vector<CNode*> vNodesCopy = CopyNodeVector();
+    BOOST_FOREACH(CNode* pnode, vNodesCopy)
+    {
+        if (interruptNet)
+            break;
+
+        //
+        // Receive
+        //
+        if (pnode->hSocket == INVALID_SOCKET)
+            continue;
+        if (FD_ISSET(pnode->hSocket, &fdsetRecv) || FD_ISSET(pnode->hSocket, &fdsetError))
+            SocketRecvData(pnode);
 
         //
-        // Accept new connections
+        // Send
         //
-        BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket)
+        if (pnode->hSocket == INVALID_SOCKET)
+            continue;
+        if (FD_ISSET(pnode->hSocket, &fdsetSend))
         {
-            if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
-            {
-                AcceptConnection(hListenSocket);
+            TRY_LOCK(pnode->cs_vSend, lockSend);
+            if (lockSend) {
+                size_t nBytes = SocketSendData(pnode);
+                if (nBytes) {
+                    RecordBytesSent(nBytes);
+                }
             }
         }
 
         //
-        // Service each socket
+        // Inactivity checking
         //
-        std::vector<CNode*> vNodesCopy = CopyNodeVector();
-        BOOST_FOREACH(CNode* pnode, vNodesCopy)
-        {
-            if (interruptNet)
+        InactivityCheck(pnode);
+    }
+    ReleaseNodeVector(vNodesCopy);
+}
+
+#ifdef USE_EPOLL
+// Listen sockets are tagged with their index in vhListenSocket, node ids never reach this bit
+static const uint64_t LISTEN_SOCKET_TAG = 1ULL << 63;
+static const int MAX_EPOLL_EVENTS = 256;
+
+void CConnman::SocketHandlerEpoll()
+{
+    // Sockets are registered once and epoll reports only the ones whose state
+    // changed, so an idle connection costs nothing here. With edge triggering a
+    // socket is reported again only after we have drained it, so the readiness
+    // is kept per node and the node stays pending until it has been acted on.
+    // The select() rules are kept: a node with queued data to send is not read
+    // from until that data is drained, and nothing is read while fPauseRecv.
+    int nTimeout = 50; // frequency to poll paused and blocked nodes
+    if (fSocketMoreWork && !setNodesSocketPending.empty())
+        nTimeout = 0;
+
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    int nEvents = epoll_wait(epollfd, events, MAX_EPOLL_EVENTS, nTimeout);
+    if (interruptNet)
+        return;
+
+    if (nEvents < 0)
+    {
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEINTR) {
+            LogPrintf("socket epoll error %s\n", NetworkErrorString(nErr));
+            if (!interruptNet.sleep_for(std::chrono::milliseconds(nTimeout)))
                 return;
+        }
+        nEvents = 0;
+    }
 
-            //
-            // Receive
-            //
-            if (pnode->hSocket == INVALID_SOCKET)
+    //
+    // Accept new connections and collect the nodes to service
+    //
+    std::vector<CNode*> vNodesReady;
+    {
+        LOCK(cs_vNodes);
+        for (int i = 0; i < nEvents; i++) {
+            if (events[i].data.u64 & LISTEN_SOCKET_TAG)
                 continue;
-            if (FD_ISSET(pnode->hSocket, &fdsetRecv) || FD_ISSET(pnode->hSocket, &fdsetError))
-            {
-                {
-                    {
-                        // typical socket buffer is 8K-64K
-                        char pchBuf[0x10000];
-                        int nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-                        if (nBytes > 0)
-                        {
-                            bool notify = false;
-                            if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
-                                pnode->CloseSocketDisconnect();
-                            RecordBytesRecv(nBytes);
-                            if (notify) {
-                                size_t nSizeAdded = 0;
-                                auto it(pnode->vRecvMsg.begin());
-                                for (; it != pnode->vRecvMsg.end(); ++it) {
-                                    if (!it->complete())
-                                        break;
-                                    nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
-                                }
-                                {
-                                    LOCK(pnode->cs_vProcessMsg);
-                                    pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
-                                    pnode->nProcessQueueSize += nSizeAdded;
-                                    pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
-                                }
-                                WakeMessageHandler();
-                            }
-                        }
-                        else if (nBytes == 0)
-                        {
-                            // socket closed gracefully
-                            if (!pnode->fDisconnect)
-                                LogPrint("net", "socket closed\n");
-                            pnode->CloseSocketDisconnect();
-                        }
-                        else if (nBytes < 0)
-                        {
-                            // error
-                            int nErr = WSAGetLastError();
-                            if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                            {
-                                if (!pnode->fDisconnect)
-                                    LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
-                                pnode->CloseSocketDisconnect();
-                            }
-                        }
-                    }
-                }
-            }
-
-            //
-            // Send
-            //
-            if (pnode->hSocket == INVALID_SOCKET)
+            auto it = mapNodesById.find((NodeId)events[i].data.u64);
+            if (it == mapNodesById.end())
+                continue;
+            CNode* pnode = it->second;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                pnode->fSocketRecvReady = true;
+            if (events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+                pnode->fSocketSendReady = true;
+            setNodesSocketPending.insert(pnode->id);
+        }
+        for (std::set<NodeId>::iterator it = setNodesSocketPending.begin(); it != setNodesSocketPending.end(); ) {
+            auto itNode = mapNodesById.find(*it);
+            if (itNode == mapNodesById.end()) {
+                setNodesSocketPending.erase(it++);
                 continue;
-            if (FD_ISSET(pnode->hSocket, &fdsetSend))
-            {
-                TRY_LOCK(pnode->cs_vSend, lockSend);
-                if (lockSend) {
-                    size_t nBytes = SocketSendData(pnode);
-                    if (nBytes) {
-                        RecordBytesSent(nBytes);
-                    }
-                }
             }
+            itNode->second->AddRef();
+            vNodesReady.push_back(itNode->second);
+            ++it;
+        }
+    }
+    for (int i = 0; i < nEvents; i++) {
+        if (events[i].data.u64 & LISTEN_SOCKET_TAG) {
+            size_t nIndex = events[i].data.u64 & ~LISTEN_SOCKET_TAG;
+            if (nIndex < vhListenSocket.size() && vhListenSocket[nIndex].socket != INVALID_SOCKET)
+                AcceptConnection(vhListenSocket[nIndex]);
+        }
+    }
 
-            //
-            // Inactivity checking
-            //
-            int64_t nTime = GetSystemTimeInSeconds();
-            if (nTime - pnode->nTimeConnected > 60)
-            {
-                if (pnode->nLastRecv == 0 || pnode->nLastSend == 0)
-                {
-                    LogPrint("net", "socket no message in first 60 seconds, %d %d from %d\n", pnode->nLastRecv != 0, pnode->nLastSend != 0, pnode->id);
-                    pnode->fDisconnect = true;
-                }
-                else if (nTime - pnode->nLastSend > TIMEOUT_INTERVAL)
-                {
-                    LogPrintf("socket sending timeout: %is\n", nTime - pnode->nLastSend);
-                    pnode->fDisconnect = true;
-                }
-                else if (nTime - pnode->nLastRecv > (pnode->nVersion > BIP0031_VERSION ? TIMEOUT_INTERVAL : 90*60))
-                {
-                    LogPrintf("socket receive timeout: %is\n", nTime - pnode->nLastRecv);
-                    pnode->fDisconnect = true;
-                }
-                else if (pnode->nPingNonceSent && pnode->nPingUsecStart + TIMEOUT_INTERVAL * 1000000 < GetTimeMicros())
-                {
-                    LogPrintf("ping timeout: %fs\n", 0.000001 * (GetTimeMicros() - pnode->nPingUsecStart));
-                    pnode->fDisconnect = true;
+    //
+    // Service each ready socket
+    //
+    bool fMoreWork = false;
+    BOOST_FOREACH(CNode* pnode, vNodesReady)
+    {
+        if (interruptNet)
+            break;
+
+        if (pnode->hSocket == INVALID_SOCKET) {
+            setNodesSocketPending.erase(pnode->id);
+            continue;
+        }
+
+        //
+        // Send
+        //
+        bool fSendPending = false;
+        {
+            TRY_LOCK(pnode->cs_vSend, lockSend);
+            if (!lockSend) {
+                // the message handler is sending, look again on the next round
+                fSendPending = true;
+            } else if (!pnode->vSendMsg.empty() && pnode->fSocketSendReady) {
+                size_t nBytes = SocketSendData(pnode);
+                if (nBytes) {
+                    RecordBytesSent(nBytes);
                 }
+                // anything left means the socket buffer is full, wait for the next edge
+                fSendPending = !pnode->vSendMsg.empty();
+                if (fSendPending)
+                    pnode->fSocketSendReady = false;
+            } else {
+                fSendPending = !pnode->vSendMsg.empty();
             }
         }
+
+        //
+        // Receive
+        //
+        if (pnode->hSocket != INVALID_SOCKET && pnode->fSocketRecvReady && !fSendPending && !pnode->fPauseRecv) {
+            if (SocketRecvData(pnode))
+                fMoreWork = true;
+            else
+                pnode->fSocketRecvReady = false;
+        }
+
+        if (pnode->hSocket == INVALID_SOCKET || !(pnode->fSocketRecvReady || (fSendPending && pnode->fSocketSendReady)))
+            setNodesSocketPending.erase(pnode->id);
+    }
+    ReleaseNodeVector(vNodesReady);
+
+    //
+    // Inactivity checking, not tied to socket events
+    //
+    int64_t nTime = GetSystemTimeInSeconds();
+    if (nTime != nLastInactivityCheck) {
+        nLastInactivityCheck = nTime;
+        std::vector<CNode*> vNodesCopy = CopyNodeVector();
+        BOOST_FOREACH(CNode* pnode, vNodesCopy)
+            InactivityCheck(pnode);
         ReleaseNodeVector(vNodesCopy);
     }
+
+    fSocketMoreWork = fMoreWork;
+}
+#endif
+
+void CConnman::ThreadSocketHandler()
+{
+    while (!interruptNet)
+    {
+        DisconnectNodes();
+        NotifyNumConnectionsChanged();
+#ifdef USE_EPOLL
+        SocketHandlerEpoll();
+#else
+        SocketHandlerSelect();
+#endif
+    }
 }
 
 void CConnman::WakeMessageHandler()
@@ -1955,6 +2145,87 @@ void CConnman::ThreadMessageHandler()
     }
 }
 
+void CConnman::ThreadMessageWorker(CMessageWorker* worker)
+{
+    while (!flagInterruptMsgProc)
+    {
+        CMessageTask task;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->cond.wait(lock, [this, worker] { return flagInterruptMsgProc || !worker->queue.empty(); });
+            if (flagInterruptMsgProc)
+                return;
+            task = std::move(worker->queue.front());
+            worker->queue.pop_front();
+        }
+        {
+            LOCK(cs_mapMsgHandlerStats);
+            mapMsgHandlerStats[task.strCommand].nQueued--;
+        }
+
+        int64_t nTimeStart = GetTimeMicros();
+        if (!task.pnode->fDisconnect)
+            task.func();
+        RecordMessageHandled(task.strCommand, task.nTimeReceived, nTimeStart);
+
+        // ProcessMessages stops handing out messages of a peer that is over the
+        // flood size in the worker queue, let it continue once we are below
+        size_t nQueueSize = task.pnode->nWorkerQueueSize.fetch_sub(task.nSize) - task.nSize;
+        if (nQueueSize <= nReceiveFloodSize && nQueueSize + task.nSize > nReceiveFloodSize)
+            WakeMessageHandler();
+        task.pnode->Release();
+    }
+}
+
+void CConnman::QueueMessageTask(CNode* pnode, const std::string& strCommand, int64_t nTimeReceived, size_t nSize, std::function<void()> func)
+{
+    assert(!vMessageWorkers.empty());
+    CMessageWorker* worker = vMessageWorkers[pnode->id % vMessageWorkers.size()].get();
+
+    {
+        LOCK(cs_mapMsgHandlerStats);
+        mapMsgHandlerStats[strCommand].nQueued++;
+    }
+    pnode->AddRef();
+    pnode->nWorkerQueueSize += nSize;
+
+    CMessageTask task;
+    task.pnode = pnode;
+    task.strCommand = strCommand;
+    task.nTimeReceived = nTimeReceived;
+    task.nSize = nSize;
+    task.func = std::move(func);
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queue.push_back(std::move(task));
+    }
+    worker->cond.notify_one();
+}
+
+void CConnman::RecordMessageHandled(const std::string& strCommand, int64_t nTimeReceived, int64_t nTimeStart)
+{
+    int64_t nTimeEnd = GetTimeMicros();
+    LOCK(cs_mapMsgHandlerStats);
+    CMessageHandlerStats& stats = mapMsgHandlerStats[strCommand];
+    stats.nProcessed++;
+    stats.nTotalLatencyMicros += nTimeEnd - nTimeReceived;
+    stats.nMaxLatencyMicros = std::max(stats.nMaxLatencyMicros, nTimeEnd - nTimeReceived);
+    stats.nTotalTimeMicros += nTimeEnd - nTimeStart;
+}
+
+void CConnman::GetMessageHandlerStats(std::map<std::string, CMessageHandlerStats>& mapStatsRet, std::vector<size_t>& vWorkerQueueRet) const
+{
+    {
+        LOCK(cs_mapMsgHandlerStats);
+        mapStatsRet = mapMsgHandlerStats;
+    }
+    vWorkerQueueRet.clear();
+    for (const auto& worker : vMessageWorkers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        vWorkerQueueRet.push_back(worker->queue.size());
+    }
+}
+
 
 
 
@@ -2050,6 +2321,20 @@ bool CConnman::BindListenPort(const CService &addrBind, std::string& strError, b
         return false;
     }
 
+#ifdef USE_EPOLL
+    // Level triggered, AcceptConnection takes one connection per wakeup
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_SOCKET_TAG | vhListenSocket.size();
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, hListenSocket, &event) != 0)
+    {
+        strError = strprintf("BindListenPort: Registering listening socket with epoll failed, error %s\n", NetworkErrorString(WSAGetLastError()));
+        LogPrintf("%s\n", strError);
+        CloseSocket(hListenSocket);
+        return false;
+    }
+#endif
+
     vhListenSocket.push_back(ListenSocket(hListenSocket, fWhitelisted));
 
     if (addrBind.IsRoutable() && fDiscover && !fWhitelisted)
@@ -2145,6 +2430,12 @@ CConnman::CConnman()
     nBestHeight = 0;
     clientInterface = NULL;
     flagInterruptMsgProc = false;
+    nPrevNodeCount = 0;
+#ifdef USE_EPOLL
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    fSocketMoreWork = false;
+    nLastInactivityCheck = 0;
+#endif
 }
 
 NodeId CConnman::GetNewNodeId()
@@ -2154,6 +2445,13 @@ NodeId CConnman::GetNewNodeId()
 
 bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options connOptions)
 {
+#ifdef USE_EPOLL
+    if (epollfd == -1) {
+        strNodeError = _("Failed to create the socket event queue");
+        return false;
+    }
+#endif
+
     nTotalBytesRecv = 0;
     nTotalBytesSent = 0;
     nMaxOutboundLimit = 0;
@@ -2170,6 +2468,10 @@ bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options c
     nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
     nReceiveFloodSize = connOptions.nReceiveFloodSize;
 
+    vMessageWorkers.clear();
+    for (int i = 0; i < connOptions.nMessageWorkers; i++)
+        vMessageWorkers.emplace_back(new CMessageWorker());
+
     SetBestHeight(connOptions.nBestHeight);
 
     clientInterface = connOptions.uiInterface;
@@ -2256,6 +2558,8 @@ bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options c
 
     // Process messages
     threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    for (const auto& worker : vMessageWorkers)
+        worker->thread = std::thread(&TraceThread<std::function<void()> >, "msgwork", std::function<void()>(std::bind(&CConnman::ThreadMessageWorker, this, worker.get())));
 
     // Dump network addresses
     scheduler.scheduleEvery(boost::bind(&CConnman::DumpData, this), DUMP_ADDRESSES_INTERVAL);
@@ -2293,6 +2597,10 @@ void CConnman::Interrupt()
         flagInterruptMsgProc = true;
     }
     condMsgProc.notify_all();
+    for (const auto& worker : vMessageWorkers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->cond.notify_all();
+    }
 
     interruptNet();
     InterruptSocks5(true);
@@ -2306,6 +2614,12 @@ void CConnman::Stop()
 {
     if (threadMessageHandler.joinable())
         threadMessageHandler.join();
+    for (const auto& worker : vMessageWorkers) {
+        if (worker->thread.joinable())
+            worker->thread.join();
+        // the nodes are deleted below regardless of their references
+        worker->queue.clear();
+    }
     if (threadMnbRequestConnections.joinable())
         threadMnbRequestConnections.join();
     if (threadOpenConnections.joinable())
@@ -2344,6 +2658,10 @@ void CConnman::Stop()
         DeleteNode(pnode);
     }
     vNodes.clear();
+#ifdef USE_EPOLL
+    mapNodesById.clear();
+    setNodesSocketPending.clear();
+#endif
     vNodesDisconnected.clear();
     vhListenSocket.clear();
     delete semOutbound;
@@ -2369,6 +2687,10 @@ CConnman::~CConnman()
 {
     Interrupt();
     Stop();
+#ifdef USE_EPOLL
+    if (epollfd != -1)
+        close(epollfd);
+#endif
 }
 
 size_t CConnman::GetAddressCount() const
@@ -2715,7 +3037,10 @@ CNode::CNode(NodeId idIn, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn
     nLocalServices = nLocalServicesIn;
     fPauseRecv = false;
     fPauseSend = false;
+    fSocketRecvReady = false;
+    fSocketSendReady = false;
     nProcessQueueSize = 0;
+    nWorkerQueueSize = 0;
 
     GetRandBytes((unsigned char*)&nLocalHostNonce, sizeof(nLocalHostNonce));
     nMyStartingHeight = nMyStartingHeightIn;
@@ -26,6 +26,7 @@
 #include <thread>
 #include <memory>
 #include <condition_variable>
+#include <unordered_map>
 
 #ifndef WIN32
 #include <arpa/inet.h>
@@ -85,6 +86,10 @@ static const bool DEFAULT_BLOCKSONLY = false;
 static const bool DEFAULT_FORCEDNSSEED = false;
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
+/** Default number of -msgworkers, threads handling messages that do not need the main message thread */
+static const int DEFAULT_MESSAGE_WORKERS = 2;
+/** Maximum number of -msgworkers */
+static const int MAX_MESSAGE_WORKERS = 16;
 
 static const ServiceFlags REQUIRED_SERVICES = NODE_NETWORK;
 
@@ -93,6 +98,19 @@ static const unsigned int DEFAULT_MISBEHAVING_BANTIME = 60 * 60 * 24;  // Defaul
 
 typedef int NodeId;
 
+/** Counters for one message type, see CConnman::RecordMessageHandled */
+struct CMessageHandlerStats
+{
+    uint64_t nProcessed = 0;
+    // Messages waiting in the worker queues
+    int nQueued = 0;
+    // Time from receipt until the handler returned
+    int64_t nTotalLatencyMicros = 0;
+    int64_t nMaxLatencyMicros = 0;
+    // Time spent in the handler
+    int64_t nTotalTimeMicros = 0;
+};
+
 struct AddedNodeInfo
 {
     std::string strAddedNode;
@@ -127,6 +145,7 @@ public:
         CClientUIInterface* uiInterface = nullptr;
         unsigned int nSendBufferMaxSize = 0;
         unsigned int nReceiveFloodSize = 0;
+        int nMessageWorkers = 0;
     };
     CConnman();
     ~CConnman();
@@ -387,6 +406,17 @@ public:
 
 
     unsigned int GetReceiveFloodSize() const;
+
+    /** Whether messages can be handed to the message worker threads */
+    bool HasMessageWorkers() const { return !vMessageWorkers.empty(); }
+    /**
+     * Run func on the message worker pnode is pinned to, so messages from one
+     * peer are handled in order. nSize is counted in pnode->nWorkerQueueSize
+     * until the handler has run.
+     */
+    void QueueMessageTask(CNode* pnode, const std::string& strCommand, int64_t nTimeReceived, size_t nSize, std::function<void()> func);
+    void RecordMessageHandled(const std::string& strCommand, int64_t nTimeReceived, int64_t nTimeStart);
+    void GetMessageHandlerStats(std::map<std::string, CMessageHandlerStats>& mapStatsRet, std::vector<size_t>& vWorkerQueueRet) const;
 private:
     struct ListenSocket {
         SOCKET socket;
@@ -399,7 +429,18 @@ private:
     void ProcessOneShot();
     void ThreadOpenConnections();
     void ThreadMessageHandler();
+    struct CMessageWorker;
+    void ThreadMessageWorker(CMessageWorker* worker);
     void AcceptConnection(const ListenSocket& hListenSocket);
+    void DisconnectNodes();
+    void NotifyNumConnectionsChanged();
+    void InactivityCheck(CNode *pnode);
+    bool SocketRecvData(CNode *pnode);
+    void SocketHandlerSelect();
+#ifdef USE_EPOLL
+    void SocketHandlerEpoll();
+#endif
+    void RegisterSocketEvents(CNode *pnode);
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
     void ThreadMnbRequestConnections();
@@ -475,6 +516,19 @@ private:
     std::list<CNode*> vNodesDisconnected;
     mutable CCriticalSection cs_vNodes;
     std::atomic<NodeId> nLastNodeId;
+    unsigned int nPrevNodeCount;
+
+#ifdef USE_EPOLL
+    /** Edge triggered readiness of all sockets, nodes are tagged with their id */
+    int epollfd;
+    /** Nodes by id for resolving epoll events, protected by cs_vNodes */
+    std::unordered_map<NodeId, CNode*> mapNodesById;
+    /** Nodes with readiness left to act on, used only by the SocketHandler thread */
+    std::set<NodeId> setNodesSocketPending;
+    /** Whether a pending node had more data to read than fit in one pass */
+    bool fSocketMoreWork;
+    int64_t nLastInactivityCheck;
+#endif
 
     /** Services this instance offers */
     ServiceFlags nLocalServices;
@@ -497,6 +551,30 @@ private:
     std::mutex mutexMsgProc;
     std::atomic<bool> flagInterruptMsgProc;
 
+    /** A message handler waiting to run on a message worker */
+    struct CMessageTask
+    {
+        CNode* pnode;
+        std::string strCommand;
+        int64_t nTimeReceived;
+        size_t nSize;
+        std::function<void()> func;
+    };
+
+    struct CMessageWorker
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::deque<CMessageTask> queue;
+        std::thread thread;
+    };
+
+    /** Peers are pinned to a worker by id */
+    std::vector<std::unique_ptr<CMessageWorker> > vMessageWorkers;
+
+    mutable CCriticalSection cs_mapMsgHandlerStats;
+    std::map<std::string, CMessageHandlerStats> mapMsgHandlerStats;
+
     CThreadInterrupt interruptNet;
 
     std::thread threadDNSAddressSeed;
@@ -675,6 +753,8 @@ public:
     CCriticalSection cs_vProcessMsg;
     std::list<CNetMessage> vProcessMsg;
     size_t nProcessQueueSize;
+    // Bytes of messages handed to a message worker and not handled yet
+    std::atomic<size_t> nWorkerQueueSize;
 
     std::deque<CInv> vRecvGetData;
     uint64_t nRecvBytes;
@@ -719,6 +799,9 @@ public:
 
     std::atomic_bool fPauseRecv;
     std::atomic_bool fPauseSend;
+    // Readiness of hSocket as last reported by epoll, used only by SocketHandler thread
+    bool fSocketRecvReady;
+    bool fSocketSendReady;
 protected:
 
     mapMsgCmdSize mapSendBytesPerMsgCmd;
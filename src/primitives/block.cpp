@@ -9,16 +9,106 @@
 #include "tinyformat.h"
 #include "utilstrencodings.h"
 #include "crypto/common.h"
+#include "crypto/phichox.h"
 
-uint256 CBlockHeader::GetHash() const
+#include <string.h>
+
+uint256 CBlockHeader::ComputeHash() const
 {
-    if(nTime >= 1645340400) {
-        return phiCHOX(BEGIN(nVersion), END(nNonce), hashPrevBlock.ToString(), nTime);
+    if(nTime >= PHICHOX_START_TIME) {
+        return phiCHOX(BEGIN(nVersion), END(nNonce), hashPrevBlock, nTime);
     } else {
         return Hash(BEGIN(nVersion), END(nNonce));
     }
 }
 
+CBlockHeader& CBlockHeader::operator=(const CBlockHeader& other)
+{
+    if (this == &other)
+        return *this;
+
+    nVersion = other.nVersion;
+    hashPrevBlock = other.hashPrevBlock;
+    hashMerkleRoot = other.hashMerkleRoot;
+    nTime = other.nTime;
+    nBits = other.nBits;
+    nNonce = other.nNonce;
+
+    // carry a cache along only once it is complete, the copy is not shared yet
+    if (other.nHashCacheState.load(std::memory_order_acquire) == HASH_CACHE_VALID) {
+        hashCached = other.hashCached;
+        memcpy(vchHashCachedHeader, other.vchHashCachedHeader, sizeof(vchHashCachedHeader));
+        nHashCacheState.store(HASH_CACHE_VALID, std::memory_order_release);
+    } else {
+        nHashCacheState.store(HASH_CACHE_EMPTY, std::memory_order_release);
+    }
+    return *this;
+}
+
+bool CBlockHeader::HasHashCache() const
+{
+    return nHashCacheState.load(std::memory_order_acquire) == HASH_CACHE_VALID &&
+           memcmp(vchHashCachedHeader, BEGIN(nVersion), sizeof(vchHashCachedHeader)) == 0;
+}
+
+void CBlockHeader::StoreHashCache(const uint256& hash) const
+{
+    // Only one thread fills the cache, the others keep the hash they computed.
+    // A valid cache is only replaced after a header field changed, which
+    // nobody else may be reading concurrently.
+    int nState = nHashCacheState.load(std::memory_order_acquire);
+    if (nState == HASH_CACHE_WRITING || !nHashCacheState.compare_exchange_strong(nState, HASH_CACHE_WRITING, std::memory_order_acquire))
+        return;
+    hashCached = hash;
+    memcpy(vchHashCachedHeader, BEGIN(nVersion), sizeof(vchHashCachedHeader));
+    nHashCacheState.store(HASH_CACHE_VALID, std::memory_order_release);
+}
+
+uint256 CBlockHeader::GetHash() const
+{
+    static_assert(sizeof(nVersion) + sizeof(hashPrevBlock) + sizeof(hashMerkleRoot) + sizeof(nTime) + sizeof(nBits) + sizeof(nNonce) == sizeof(vchHashCachedHeader),
+                  "header hash cache must cover the whole serialized header");
+
+    if (HasHashCache())
+        return hashCached;
+
+    uint256 hash = ComputeHash();
+    StoreHashCache(hash);
+    return hash;
+}
+
+void CBlockHeader::PrecomputeHashes(std::vector<CBlockHeader>::const_iterator first, std::vector<CBlockHeader>::const_iterator last)
+{
+    const size_t nHeaderSize = sizeof(vchHashCachedHeader);
+
+    std::vector<const CBlockHeader*> vBatch;
+    vBatch.reserve(last - first);
+    for (; first != last; ++first) {
+        const CBlockHeader& header = *first;
+        if (header.HasHashCache())
+            continue;
+        if (header.nTime >= PHICHOX_START_TIME)
+            vBatch.push_back(&header);
+        else
+            header.GetHash();
+    }
+    if (vBatch.empty())
+        return;
+
+    std::vector<unsigned char> vchHeaders(vBatch.size() * nHeaderSize);
+    std::vector<unsigned char> vchHashes(vBatch.size() * CPhiCHOX::OUTPUT_SIZE);
+    for (size_t i = 0; i < vBatch.size(); i++)
+        memcpy(&vchHeaders[i * nHeaderSize], BEGIN(vBatch[i]->nVersion), nHeaderSize);
+
+    PhiCHOXHeaders(vchHashes.data(), vchHeaders.data(), vBatch.size());
+
+    for (size_t i = 0; i < vBatch.size(); i++) {
+        uint256 hash;
+        memcpy(hash.begin(), &vchHashes[i * CPhiCHOX::OUTPUT_SIZE], CPhiCHOX::OUTPUT_SIZE);
+        vBatch[i]->StoreHashCache(hash);
+    }
+}
+
 std::string CBlock::ToString() const
 {
     std::stringstream s;
@@ -31,7 +121,7 @@ std::string CBlock::ToString() const
         vtx.size());
     for (unsigned int i = 0; i < vtx.size(); i++)
     {
-        s << "  " << vtx[i].ToString() << "\n";
+        s << "  " << vtx[i]->ToString() << "\n";
     }
     return s.str();
 }
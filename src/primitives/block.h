@@ -10,6 +10,11 @@
 #include "serialize.h"
 #include "uint256.h"
 
+#include <atomic>
+
+/** Headers with nTime at or after this are hashed with phiCHOX instead of double SHA-256 */
+static const uint32_t PHICHOX_START_TIME = 1645340400;
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -28,11 +33,35 @@ public:
     uint32_t nBits;
     uint32_t nNonce;
 
+private:
+    enum { HASH_CACHE_EMPTY, HASH_CACHE_WRITING, HASH_CACHE_VALID };
+
+    // memory only: the last computed header hash together with the header
+    // bytes it was computed over, so that any change to a header field
+    // invalidates it. The cache is filled by one thread at a time and
+    // published through nHashCacheState, so a header shared between threads
+    // can be hashed concurrently as long as none of them modifies it.
+    mutable uint256 hashCached;
+    mutable unsigned char vchHashCachedHeader[80];
+    mutable std::atomic<int> nHashCacheState;
+
+    bool HasHashCache() const;
+    void StoreHashCache(const uint256& hash) const;
+
+public:
     CBlockHeader()
     {
         SetNull();
     }
 
+    CBlockHeader(const CBlockHeader& other)
+    {
+        nHashCacheState = HASH_CACHE_EMPTY;
+        *this = other;
+    }
+
+    CBlockHeader& operator=(const CBlockHeader& other);
+
     ADD_SERIALIZE_METHODS;
 
     template <typename Stream, typename Operation>
@@ -54,6 +83,7 @@ public:
         nTime = 0;
         nBits = 0;
         nNonce = 0;
+        nHashCacheState = HASH_CACHE_EMPTY;
     }
 
     bool IsNull() const
@@ -61,8 +91,24 @@ public:
         return (nBits == 0);
     }
 
+    /** Return the header hash, reusing the cached value if no header field changed since it was computed */
     uint256 GetHash() const;
 
+    /** Compute the header hash without touching the cache (used by the miner, which changes nNonce on every call) */
+    uint256 ComputeHash() const;
+
+    /**
+     * Fill the hash caches of a run of headers at once. phiCHOX headers are
+     * hashed through the batch kernels, which is considerably cheaper per
+     * header than calling GetHash() on each of them. Headers whose cache is
+     * still valid are left alone.
+     */
+    static void PrecomputeHashes(std::vector<CBlockHeader>::const_iterator first, std::vector<CBlockHeader>::const_iterator last);
+    static void PrecomputeHashes(const std::vector<CBlockHeader>& headers)
+    {
+        PrecomputeHashes(headers.begin(), headers.end());
+    }
+
     int64_t GetBlockTime() const
     {
         return (int64_t)nTime;
@@ -74,7 +120,7 @@ class CBlock : public CBlockHeader
 {
 public:
     // network and disk
-    std::vector<CTransaction> vtx;
+    std::vector<CTransactionRef> vtx;
 
     // memory only
     mutable CTxOut txoutMasternode; // masternode payment
@@ -248,18 +248,12 @@ void CPrivateSendServer::ProcessMessage(CNode* pfrom, std::string& strCommand, C
 
         LogPrint("privatesend", "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
 
-        int nTxInIndex = 0;
-        int nTxInsCount = (int)vecTxIn.size();
-
-        BOOST_FOREACH(const CTxIn txin, vecTxIn) {
-            nTxInIndex++;
-            if(!AddScriptSig(txin)) {
-                LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
-                RelayStatus(STATUS_REJECTED, connman);
-                return;
-            }
-            LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
+        if(!AddScriptSigs(vecTxIn)) {
+            LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSigs() failed, session: %d\n", nSessionID);
+            RelayStatus(STATUS_REJECTED, connman);
+            return;
         }
+        LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSigs() %d success\n", vecTxIn.size());
         // all is good
         CheckPool(connman);
     }
@@ -269,6 +263,8 @@ void CPrivateSendServer::SetNull()
 {
     // MN side
     vecSessionCollaterals.clear();
+    mapSessionInputs.clear();
+    mapFinalTxInputs.clear();
 
     CPrivateSendBase::SetNull();
 }
@@ -308,6 +304,8 @@ void CPrivateSendServer::CreateFinalTransaction(CConnman& connman)
     LogPrint("privatesend", "CPrivateSendServer::CreateFinalTransaction -- FINALIZE TRANSACTIONS\n");
 
     CMutableTransaction txNew;
+    std::vector<CTxDSIn> vecTxDSIn;
+    vecTxDSIn.reserve(mapSessionInputs.size());
 
     // make our new transaction
     for(int i = 0; i < GetEntriesCount(); i++) {
@@ -315,12 +313,19 @@ void CPrivateSendServer::CreateFinalTransaction(CConnman& connman)
             txNew.vout.push_back(txout);
 
         BOOST_FOREACH(const CTxDSIn& txdsin, vecEntries[i].vecTxDSIn)
-            txNew.vin.push_back(txdsin);
+            vecTxDSIn.push_back(txdsin);
     }
 
-    sort(txNew.vin.begin(), txNew.vin.end(), CompareInputBIP69());
+    sort(vecTxDSIn.begin(), vecTxDSIn.end(), CompareInputBIP69());
     sort(txNew.vout.begin(), txNew.vout.end(), CompareOutputBIP69());
 
+    // remember where each input ended up, signatures are checked against this transaction
+    mapFinalTxInputs.clear();
+    BOOST_FOREACH(const CTxDSIn& txdsin, vecTxDSIn) {
+        mapFinalTxInputs.insert(std::make_pair(txdsin.prevout, std::make_pair(txNew.vin.size(), txdsin.prevPubKey)));
+        txNew.vin.push_back(txdsin);
+    }
+
     finalMutableTransaction = txNew;
     LogPrint("privatesend", "CPrivateSendServer::CreateFinalTransaction -- finalMutableTransaction=%s", txNew.ToString());
 
@@ -531,46 +536,45 @@ void CPrivateSendServer::CheckForCompleteQueue(CConnman& connman)
     }
 }
 
-// Check to make sure a given input matches an input in the pool and its scriptSig is valid
-bool CPrivateSendServer::IsInputScriptSigValid(const CTxIn& txin)
+// Check to make sure given inputs match unsigned inputs in the pool and their scriptSigs are valid
+bool CPrivateSendServer::IsInputScriptSigsValid(const std::vector<CTxIn>& vecTxIn)
 {
-    CMutableTransaction txNew;
-    txNew.vin.clear();
-    txNew.vout.clear();
-
-    int i = 0;
-    int nTxInIndex = -1;
-    CScript sigPubKey = CScript();
-
-    BOOST_FOREACH(CDarkSendEntry& entry, vecEntries) {
-
-        for (const auto& txout : entry.vecTxOut)
-            txNew.vout.push_back(txout);
-
-        BOOST_FOREACH(const CTxDSIn& txdsin, entry.vecTxDSIn) {
-            txNew.vin.push_back(txdsin);
-
-            if(txdsin.prevout == txin.prevout) {
-                nTxInIndex = i;
-                sigPubKey = txdsin.prevPubKey;
-            }
-            i++;
+    // Clients sign finalMutableTransaction itself. The sighash of an input never covers
+    // the other inputs' scriptSigs, so one copy with all new signatures in place serves
+    // the whole batch and matches the transaction committed later
+    CMutableTransaction txNew(finalMutableTransaction);
+    std::vector<const CScript*> vecPrevPubKeys;
+    std::vector<unsigned int> vecTxInIndex;
+
+    BOOST_FOREACH(const CTxIn& txin, vecTxIn) {
+        std::map<COutPoint, std::pair<unsigned int, CScript> >::const_iterator it = mapFinalTxInputs.find(txin.prevout);
+        if(it == mapFinalTxInputs.end() || txNew.vin[it->second.first].nSequence != txin.nSequence) {
+            LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigsValid -- Failed to find matching input in pool, %s\n", txin.ToString());
+            return false;
+        }
+        if(!txNew.vin[it->second.first].scriptSig.empty()) {
+            LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigsValid -- already signed, %s\n", txin.ToString());
+            return false;
         }
+        txNew.vin[it->second.first].scriptSig = txin.scriptSig;
+        vecTxInIndex.push_back(it->second.first);
+        vecPrevPubKeys.push_back(&it->second.second);
     }
 
-    if(nTxInIndex >= 0) { //might have to do this one input at a time?
-        txNew.vin[nTxInIndex].scriptSig = txin.scriptSig;
-        LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- verifying scriptSig %s\n", ScriptToAsmStr(txin.scriptSig).substr(0,24));
-        if(!VerifyScript(txNew.vin[nTxInIndex].scriptSig, sigPubKey, SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_STRICTENC, MutableTransactionSignatureChecker(&txNew, nTxInIndex))) {
-            LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- VerifyScript() failed on input %d\n", nTxInIndex);
+    // The scripts spent were stored with the entries, so verifying needs no cs_main.
+    // The script check threads are left to ConnectBlock, which serializes them with cs_main.
+    const CTransaction txSigned(txNew);
+    LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigsValid -- verifying %d scriptSigs\n", vecTxInIndex.size());
+    for(unsigned int i = 0; i < vecTxInIndex.size(); i++) {
+        // store the results in the signature cache, AcceptToMemoryPool finds them there in CommitFinalTransaction
+        CScriptCheck check(*vecPrevPubKeys[i], 0, txSigned, vecTxInIndex[i], SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_STRICTENC, true);
+        if(!check()) {
+            LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigsValid -- VerifyScript() failed\n");
             return false;
         }
-    } else {
-        LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- Failed to find matching input in pool, %s\n", txin.ToString());
-        return false;
     }
 
-    LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- Successfully validated input and scriptSig\n");
+    LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigsValid -- Successfully validated inputs and scriptSigs\n");
     return true;
 }
 
@@ -601,19 +605,17 @@ bool CPrivateSendServer::AddEntry(const CDarkSendEntry& entryNew, PoolMessage& n
         return false;
     }
 
-    BOOST_FOREACH(CTxIn txin, entryNew.vecTxDSIn) {
-        LogPrint("privatesend", "looking for txin -- %s\n", txin.ToString());
-        BOOST_FOREACH(const CDarkSendEntry& entry, vecEntries) {
-            BOOST_FOREACH(const CTxDSIn& txdsin, entry.vecTxDSIn) {
-                if(txdsin.prevout == txin.prevout) {
-                    LogPrint("privatesend", "CPrivateSendServer::AddEntry -- found in txin\n");
-                    nMessageIDRet = ERR_ALREADY_HAVE;
-                    return false;
-                }
-            }
+    BOOST_FOREACH(const CTxDSIn& txdsin, entryNew.vecTxDSIn) {
+        LogPrint("privatesend", "looking for txin -- %s\n", txdsin.ToString());
+        if(mapSessionInputs.count(txdsin.prevout)) {
+            LogPrint("privatesend", "CPrivateSendServer::AddEntry -- found in txin\n");
+            nMessageIDRet = ERR_ALREADY_HAVE;
+            return false;
         }
     }
 
+    BOOST_FOREACH(const CTxDSIn& txdsin, entryNew.vecTxDSIn)
+        mapSessionInputs.insert(std::make_pair(txdsin.prevout, GetEntriesCount()));
     vecEntries.push_back(entryNew);
 
     LogPrint("privatesend", "CPrivateSendServer::AddEntry -- adding entry\n");
@@ -623,41 +625,36 @@ bool CPrivateSendServer::AddEntry(const CDarkSendEntry& entryNew, PoolMessage& n
     return true;
 }
 
-bool CPrivateSendServer::AddScriptSig(const CTxIn& txinNew)
+bool CPrivateSendServer::AddScriptSigs(const std::vector<CTxIn>& vecTxIn)
 {
-    LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0,24));
-
-    BOOST_FOREACH(const CDarkSendEntry& entry, vecEntries) {
-        BOOST_FOREACH(const CTxDSIn& txdsin, entry.vecTxDSIn) {
-            if(txdsin.scriptSig == txinNew.scriptSig) {
-                LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- already exists\n");
-                return false;
-            }
-        }
-    }
-
-    if(!IsInputScriptSigValid(txinNew)) {
-        LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- Invalid scriptSig\n");
+    if(!IsInputScriptSigsValid(vecTxIn)) {
+        LogPrint("privatesend", "CPrivateSendServer::AddScriptSigs -- Invalid scriptSig\n");
         return false;
     }
 
-    LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- scriptSig=%s new\n", ScriptToAsmStr(txinNew.scriptSig).substr(0,24));
-
-    BOOST_FOREACH(CTxIn& txin, finalMutableTransaction.vin) {
-        if(txinNew.prevout == txin.prevout && txin.nSequence == txinNew.nSequence) {
-            txin.scriptSig = txinNew.scriptSig;
-            LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- adding to finalMutableTransaction, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0,24));
+    // find the entry of every input before changing anything, so that a batch is applied all or nothing
+    std::vector<int> vecEntryIndex;
+    std::set<COutPoint> setPrevouts;
+    BOOST_FOREACH(const CTxIn& txinNew, vecTxIn) {
+        std::map<COutPoint, int>::const_iterator it = mapSessionInputs.find(txinNew.prevout);
+        if(it == mapSessionInputs.end() || !vecEntries[it->second].CanAddScriptSig(txinNew) || !setPrevouts.insert(txinNew.prevout).second) {
+            LogPrintf("CPrivateSendServer::AddScriptSigs -- Couldn't set sig!\n");
+            return false;
         }
+        vecEntryIndex.push_back(it->second);
     }
-    for(int i = 0; i < GetEntriesCount(); i++) {
-        if(vecEntries[i].AddScriptSig(txinNew)) {
-            LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- adding to entries, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0,24));
-            return true;
-        }
+
+    for(unsigned int i = 0; i < vecTxIn.size(); i++) {
+        const CTxIn& txinNew = vecTxIn[i];
+        LogPrint("privatesend", "CPrivateSendServer::AddScriptSigs -- scriptSig=%s new\n", ScriptToAsmStr(txinNew.scriptSig).substr(0,24));
+
+        // the final transaction input was checked by IsInputScriptSigsValid
+        finalMutableTransaction.vin[mapFinalTxInputs[txinNew.prevout].first].scriptSig = txinNew.scriptSig;
+        bool fAdded = vecEntries[vecEntryIndex[i]].AddScriptSig(txinNew);
+        assert(fAdded);
     }
 
-    LogPrintf("CPrivateSendServer::AddScriptSig -- Couldn't set sig!\n" );
-    return false;
+    return true;
 }
 
 // Check to make sure everything is signed
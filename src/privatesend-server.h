@@ -24,10 +24,15 @@ private:
 
     bool fUnitTest;
 
+    // Inputs of all entries in the session, to the index of their entry
+    std::map<COutPoint, int> mapSessionInputs;
+    // Inputs of finalMutableTransaction, to their position and the script they spend
+    std::map<COutPoint, std::pair<unsigned int, CScript> > mapFinalTxInputs;
+
     /// Add a clients entry to the pool
     bool AddEntry(const CDarkSendEntry& entryNew, PoolMessage& nMessageIDRet);
-    /// Add signature to a txin
-    bool AddScriptSig(const CTxIn& txin);
+    /// Add signatures to txins, all or none of them
+    bool AddScriptSigs(const std::vector<CTxIn>& vecTxIn);
 
     /// Charge fees to bad actors (Charge clients a fee if they're abusive)
     void ChargeFees(CConnman& connman);
@@ -49,8 +54,8 @@ private:
 
     /// Check that all inputs are signed. (Are all inputs signed?)
     bool IsSignaturesComplete();
-    /// Check to make sure a given input matches an input in the pool and its scriptSig is valid
-    bool IsInputScriptSigValid(const CTxIn& txin);
+    /// Check to make sure given inputs match unsigned inputs in the pool and their scriptSigs are valid
+    bool IsInputScriptSigsValid(const std::vector<CTxIn>& vecTxIn);
     /// Are these outputs compatible with other client in the pool?
     bool IsOutputsCompatibleWithSessionDenom(const std::vector<CTxOut>& vecTxOut);
 
@@ -19,6 +19,16 @@
 
 #include <boost/lexical_cast.hpp>
 
+bool CDarkSendEntry::CanAddScriptSig(const CTxIn& txin) const
+{
+    BOOST_FOREACH(const CTxDSIn& txdsin, vecTxDSIn) {
+        if(txdsin.prevout == txin.prevout && txdsin.nSequence == txin.nSequence)
+            return !txdsin.fHasSig;
+    }
+
+    return false;
+}
+
 bool CDarkSendEntry::AddScriptSig(const CTxIn& txin)
 {
     BOOST_FOREACH(CTxDSIn& txdsin, vecTxDSIn) {
@@ -131,6 +131,7 @@ public:
         READWRITE(vecTxOut);
     }
 
+    bool CanAddScriptSig(const CTxIn& txin) const;
     bool AddScriptSig(const CTxIn& txin);
 };
 
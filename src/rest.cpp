@@ -218,6 +218,7 @@ static bool rest_block(HTTPRequest* req,
 
     CBlock block;
     CBlockIndex* pblockindex = NULL;
+    CDiskBlockPos pos;
     {
         LOCK(cs_main);
         if (mapBlockIndex.count(hash) == 0)
@@ -226,11 +227,13 @@ static bool rest_block(HTTPRequest* req,
         pblockindex = mapBlockIndex[hash];
         if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
-
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
-            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        pos = pblockindex->GetBlockPos();
     }
 
+    // Read the block without holding cs_main
+    if (!ReadBlockFromDisk(block, pos, Params().GetConsensus()) || block.GetHash() != hash)
+        return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+
     CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION);
     ssBlock << block;
 
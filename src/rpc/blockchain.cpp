@@ -9,6 +9,7 @@
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "coins.h"
+#include "coinsprefetch.h"
 #include "consensus/validation.h"
 #include "validation.h"
 #include "policy/policy.h"
@@ -105,8 +106,9 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     result.push_back(Pair("version", block.nVersion));
     result.push_back(Pair("merkleroot", block.hashMerkleRoot.GetHex()));
     UniValue txs(UniValue::VARR);
-    BOOST_FOREACH(const CTransaction&tx, block.vtx)
+    BOOST_FOREACH(const CTransactionRef& ptx, block.vtx)
     {
+        const CTransaction& tx = *ptx;
         if(txDetails)
         {
             UniValue objTx(UniValue::VOBJ);
@@ -522,8 +524,6 @@ UniValue getblock(const UniValue& params, bool fHelp)
             + HelpExampleRpc("getblock", "\"00000000000fd08c2fb661d2fcb0d49abb3a91e5f27082ce64feed3b4dede2e2\"")
         );
 
-    LOCK(cs_main);
-
     std::string strHash = params[0].get_str();
     uint256 hash(uint256S(strHash));
 
@@ -531,16 +531,23 @@ UniValue getblock(const UniValue& params, bool fHelp)
     if (params.size() > 1)
         fVerbose = params[1].get_bool();
 
-    if (mapBlockIndex.count(hash) == 0)
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
-
     CBlock block;
-    CBlockIndex* pblockindex = mapBlockIndex[hash];
+    CBlockIndex* pblockindex;
+    CDiskBlockPos pos;
+    {
+        LOCK(cs_main);
+        if (mapBlockIndex.count(hash) == 0)
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
 
-    if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
-        throw JSONRPCError(RPC_INTERNAL_ERROR, "Block not available (pruned data)");
+        pblockindex = mapBlockIndex[hash];
+
+        if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Block not available (pruned data)");
+        pos = pblockindex->GetBlockPos();
+    }
 
-    if(!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+    // Read the block without holding cs_main
+    if(!ReadBlockFromDisk(block, pos, Params().GetConsensus()) || block.GetHash() != hash)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Can't read block from disk");
 
     if (!fVerbose)
@@ -551,6 +558,7 @@ UniValue getblock(const UniValue& params, bool fHelp)
         return strHex;
     }
 
+    LOCK(cs_main);
     return blockToJSON(block, pblockindex);
 }
 
@@ -659,6 +667,80 @@ UniValue gettxoutsetinfo(const UniValue& params, bool fHelp)
     return ret;
 }
 
+UniValue getcoinscacheinfo(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() != 0)
+        throw runtime_error(
+            "getcoinscacheinfo\n"
+            "\nReturns details on the in-memory UTXO set and how it is written to the database.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"mode\": \"xxxx\",          (string) \"incremental\" or \"flush\", see -incrementalflush\n"
+            "  \"usage\": n,              (numeric) Memory used by the cache in bytes\n"
+            "  \"limit\": n,              (numeric) Memory the cache may use in bytes\n"
+            "  \"entries\": n,            (numeric) Number of coins in the cache\n"
+            "  \"syncqueue\": n,          (numeric) Coins modified since they were last written (an upper bound)\n"
+            "  \"hits\": n,               (numeric) Lookups served by the cache\n"
+            "  \"misses\": n,             (numeric) Lookups that read from the database\n"
+            "  \"hitrate\": x.xxx,        (numeric) Share of lookups served by the cache\n"
+            "  \"flushes\": n,            (numeric) Number of complete writes\n"
+            "  \"flushtime\": x.xxx,      (numeric) Average time of a complete write in milliseconds\n"
+            "  \"lastflushtime\": x.xxx,  (numeric) Time of the last complete write in milliseconds\n"
+            "  \"chunks\": n,             (numeric) Number of chunks written in between\n"
+            "  \"chunktime\": x.xxx,      (numeric) Average time of a chunk in milliseconds\n"
+            "  \"lastchunktime\": x.xxx,  (numeric) Time of the last chunk in milliseconds\n"
+            "  \"evicted\": n,            (numeric) Unmodified coins dropped to stay within the limit\n"
+            "  \"evicttime\": x.xxx,      (numeric) Total time spent evicting in milliseconds\n"
+            "  \"prefetch\": {            (json object, only with -utxoprefetch) Coins read ahead of ConnectBlock\n"
+            "    \"queued\": n,           (numeric) Outpoints queued for reading\n"
+            "    \"fetched\": n,          (numeric) Coins read by the prefetch threads\n"
+            "    \"hits\": n,             (numeric) Lookups served by a prefetched coin\n"
+            "    \"waits\": n,            (numeric) Of the hits, those that waited for the read\n"
+            "    \"misses\": n,           (numeric) Lookups that read the coin themselves\n"
+            "    \"discarded\": n         (numeric) Prefetched coins dropped without a lookup\n"
+            "  }\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getcoinscacheinfo", "")
+            + HelpExampleRpc("getcoinscacheinfo", "")
+        );
+
+    LOCK(cs_main);
+
+    uint64_t nHits, nMisses;
+    pcoinsTip->GetLookupStats(nHits, nMisses);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("mode", fIncrementalFlush ? "incremental" : "flush"));
+    ret.push_back(Pair("usage", (int64_t)pcoinsTip->DynamicMemoryUsage()));
+    ret.push_back(Pair("limit", (int64_t)nCoinCacheUsage));
+    ret.push_back(Pair("entries", (int64_t)pcoinsTip->GetCacheSize()));
+    ret.push_back(Pair("syncqueue", (int64_t)pcoinsTip->GetSyncQueueSize()));
+    ret.push_back(Pair("hits", (int64_t)nHits));
+    ret.push_back(Pair("misses", (int64_t)nMisses));
+    ret.push_back(Pair("hitrate", nHits + nMisses ? (double)nHits / (nHits + nMisses) : 0.0));
+    ret.push_back(Pair("flushes", (int64_t)coinsFlushStats.nFlushes));
+    ret.push_back(Pair("flushtime", coinsFlushStats.nFlushes ? 0.001 * coinsFlushStats.nFlushMicros / coinsFlushStats.nFlushes : 0.0));
+    ret.push_back(Pair("lastflushtime", 0.001 * coinsFlushStats.nLastFlushMicros));
+    ret.push_back(Pair("chunks", (int64_t)coinsFlushStats.nChunks));
+    ret.push_back(Pair("chunktime", coinsFlushStats.nChunks ? 0.001 * coinsFlushStats.nChunkMicros / coinsFlushStats.nChunks : 0.0));
+    ret.push_back(Pair("lastchunktime", 0.001 * coinsFlushStats.nLastChunkMicros));
+    ret.push_back(Pair("evicted", (int64_t)coinsFlushStats.nEvicted));
+    ret.push_back(Pair("evicttime", 0.001 * coinsFlushStats.nEvictMicros));
+    if (pcoinsprefetch) {
+        CCoinsPrefetchStats stats = pcoinsprefetch->GetStats();
+        UniValue prefetch(UniValue::VOBJ);
+        prefetch.push_back(Pair("queued", (int64_t)stats.nQueued));
+        prefetch.push_back(Pair("fetched", (int64_t)stats.nFetched));
+        prefetch.push_back(Pair("hits", (int64_t)stats.nHits));
+        prefetch.push_back(Pair("waits", (int64_t)stats.nWaits));
+        prefetch.push_back(Pair("misses", (int64_t)stats.nMisses));
+        prefetch.push_back(Pair("discarded", (int64_t)stats.nDiscarded));
+        ret.push_back(Pair("prefetch", prefetch));
+    }
+    return ret;
+}
+
 UniValue gettxout(const UniValue& params, bool fHelp)
 {
     if (fHelp || params.size() < 2 || params.size() > 3)
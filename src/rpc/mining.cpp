@@ -173,11 +173,17 @@ UniValue generate(const UniValue& params, bool fHelp)
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (!CheckProofOfWork(pblock->GetHash(), pblock->nBits, Params().GetConsensus())) {
+        CNonceScanner scanner(*pblock);
+        arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+        uint256 hash;
+        uint32_t nNonceStart = pblock->nNonce;
+        while (!scanner.Scan(pblock->nNonce, MINER_SCAN_BATCH_SIZE, hashTarget, hash)) {
             // Yes, there is a chance every nonce could fail to satisfy the -regtest
             // target -- 1 in 2^(2^32). That ain't gonna happen.
-            ++pblock->nNonce;
         }
+        UpdateHashesPerSec(pblock->nNonce - nNonceStart + 1);
+        if (!CheckProofOfWork(pblock->GetHash(), pblock->nBits, Params().GetConsensus()))
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Generated block does not satisfy its proof-of-work target");
         if (!ProcessNewBlock(Params(), pblock, true, NULL, NULL))
             throw JSONRPCError(RPC_INTERNAL_ERROR, "ProcessNewBlock, block not accepted");
         ++nHeight;
@@ -247,11 +253,21 @@ UniValue getmininginfo(const UniValue& params, bool fHelp)
             "  \"difficulty\": xxx.xxxxx    (numeric) The current difficulty\n"
             "  \"errors\": \"...\"          (string) Current errors\n"
             "  \"genproclimit\": n          (numeric) The processor limit for generation. -1 ichox generation. (see getgenerate or setgenerate calls)\n"
+            "  \"hashespersec\": n          (numeric) The hashes per second of the internal miner and the generate call\n"
             "  \"networkhashps\": n         (numeric) An estimate of the number of hashes per second the network is generating to maintain the current difficulty\n"
             "  \"pooledtx\": n              (numeric) The size of the mem pool\n"
             "  \"testnet\": true|false      (boolean) If using testnet or not\n"
             "  \"chain\": \"xxxx\",         (string) current network name as defined in BIP70 (main, test, regtest)\n"
             "  \"generate\": true|false     (boolean) If the generation is on or off (see getgenerate or setgenerate calls)\n"
+            "  \"templates\": {             (json object) Block templates made by getblocktemplate and the miner\n"
+            "    \"built\": n,              (numeric) Templates selected from the whole mempool\n"
+            "    \"updated\": n,            (numeric) Templates extended with the transactions that arrived since the previous one\n"
+            "    \"lastupdated\": true|false, (boolean) Whether the last template was updated rather than built\n"
+            "    \"lastselect\": x.xxx,     (numeric) Time the last template took to select transactions, in milliseconds\n"
+            "    \"lastpayments\": x.xxx,   (numeric) ... to add the masternode and superblock payments\n"
+            "    \"lastvalidity\": x.xxx,   (numeric) ... to test the validity of the block\n"
+            "    \"lasttotal\": x.xxx       (numeric) ... in total\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getmininginfo", "")
@@ -268,11 +284,23 @@ UniValue getmininginfo(const UniValue& params, bool fHelp)
     obj.push_back(Pair("difficulty",       (double)GetDifficulty()));
     obj.push_back(Pair("errors",           GetWarnings("statusbar")));
     obj.push_back(Pair("genproclimit",     (int)GetArg("-genproclimit", DEFAULT_GENERATE_THREADS)));
+    obj.push_back(Pair("hashespersec",     GetHashesPerSec()));
     obj.push_back(Pair("networkhashps",    getnetworkhashps(params, false)));
     obj.push_back(Pair("pooledtx",         (uint64_t)mempool.size()));
     obj.push_back(Pair("testnet",          Params().TestnetToBeDeprecatedFieldRPC()));
     obj.push_back(Pair("chain",            Params().NetworkIDString()));
     obj.push_back(Pair("generate",         getgenerate(params, false)));
+
+    CBlockTemplateStats templateStats = GetBlockTemplateStats();
+    UniValue templates(UniValue::VOBJ);
+    templates.push_back(Pair("built",        (uint64_t)templateStats.nBuilds));
+    templates.push_back(Pair("updated",      (uint64_t)templateStats.nUpdates));
+    templates.push_back(Pair("lastupdated",  templateStats.fLastUpdated));
+    templates.push_back(Pair("lastselect",   0.001 * templateStats.nLastSelectMicros));
+    templates.push_back(Pair("lastpayments", 0.001 * templateStats.nLastPaymentsMicros));
+    templates.push_back(Pair("lastvalidity", 0.001 * templateStats.nLastValidityMicros));
+    templates.push_back(Pair("lasttotal",    0.001 * templateStats.nLastTotalMicros));
+    obj.push_back(Pair("templates",        templates));
     return obj;
 }
 
@@ -515,6 +543,8 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
 //            throw JSONRPCError(RPC_CLIENT_IN_INITIAL_DOWNLOAD, "Chainox Core is syncing with network...");
 
     static unsigned int nTransactionsUpdatedLast;
+    // Only the coinbase, served for a new tip until the template built in the background is ready
+    static bool fTemplateEmpty;
 
     if (!lpval.isNull())
     {
@@ -538,6 +568,9 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
             nTransactionsUpdatedLastLP = nTransactionsUpdatedLast;
         }
 
+        // Miners working on the empty template get the full one as soon as it is ready
+        bool fWaitFullTemplate = fTemplateEmpty && pblocktemplatePrebuilder;
+
         // Release the wallet and main lock while waiting
         LEAVE_CRITICAL_SECTION(cs_main);
         {
@@ -546,6 +579,8 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
             boost::unique_lock<boost::mutex> lock(csBestBlock);
             while (chainActive.Tip()->GetBlockHash() == hashWatchedChain && IsRPCRunning())
             {
+                if (fWaitFullTemplate && pblocktemplatePrebuilder->HaveTemplate(chainActive.Tip()))
+                    break;
                 if (!cvBlockChange.timed_wait(lock, checktxtime))
                 {
                     // Timeout: Check transactions for update
@@ -566,11 +601,17 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
     static CBlockIndex* pindexPrev;
     static int64_t nStart;
     static CBlockTemplate* pblocktemplate;
-    if (pindexPrev != chainActive.Tip() ||
-        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5))
+    // Keep serving the empty template while the full one is still being built for the same tip
+    bool fAwaitingFull = fTemplateEmpty && pindexPrev == chainActive.Tip() &&
+                         !pblocktemplatePrebuilder->HaveTemplate(pindexPrev) && pblocktemplatePrebuilder->IsBuilding(pindexPrev);
+    if (!fAwaitingFull && (pindexPrev != chainActive.Tip() || fTemplateEmpty ||
+        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5)))
     {
+        bool fNewTip = pindexPrev != chainActive.Tip();
+
         // Clear pindexPrev so future calls make a new block, despite any failures from here on
         pindexPrev = NULL;
+        fTemplateEmpty = false;
 
         // Store the chainActive.Tip() used before CreateNewBlock, to avoid races
         nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
@@ -584,7 +625,19 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
             pblocktemplate = NULL;
         }
         CScript scriptDummy = CScript() << OP_TRUE;
-        pblocktemplate = CreateNewBlock(Params(), scriptDummy);
+        if (pblocktemplatePrebuilder) {
+            // Built in the background as soon as the tip changed, with the same dummy script
+            pblocktemplate = pblocktemplatePrebuilder->TakeTemplate(pindexPrevNew);
+            if (!pblocktemplate && fNewTip) {
+                // The tip notification may not have reached the prebuilder yet,
+                // so ask for the template here rather than build it in place
+                pblocktemplatePrebuilder->Request(pindexPrevNew);
+                pblocktemplate = CreateEmptyBlock(Params(), scriptDummy);
+                fTemplateEmpty = true;
+            }
+        }
+        if (!pblocktemplate)
+            pblocktemplate = CreateNewBlock(Params(), scriptDummy);
         if (!pblocktemplate)
             throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
 
@@ -603,7 +656,8 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
     UniValue transactions(UniValue::VARR);
     map<uint256, int64_t> setTxIndex;
     int i = 0;
-    BOOST_FOREACH (const CTransaction& tx, pblock->vtx) {
+    BOOST_FOREACH (const CTransactionRef& ptx, pblock->vtx) {
+        const CTransaction& tx = *ptx;
         uint256 txHash = tx.GetHash();
         setTxIndex[txHash] = i++;
 
@@ -702,7 +756,7 @@ UniValue getblocktemplate(const UniValue& params, bool fHelp)
     result.push_back(Pair("previousblockhash", pblock->hashPrevBlock.GetHex()));
     result.push_back(Pair("transactions", transactions));
     result.push_back(Pair("coinbaseaux", aux));
-    result.push_back(Pair("coinbasevalue", (int64_t)pblock->vtx[0].GetValueOut()));
+    result.push_back(Pair("coinbasevalue", (int64_t)pblock->vtx[0]->GetValueOut()));
     result.push_back(Pair("longpollid", chainActive.Tip()->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast)));
     result.push_back(Pair("target", hashTarget.GetHex()));
     result.push_back(Pair("mintime", (int64_t)pindexPrev->GetMedianTimePast()+1));
@@ -589,6 +589,134 @@ bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     return a.second.time < b.second.time;
 }
 
+/** Upper bound for the "limit" of the paginated address index calls */
+static const int MAX_ADDRESS_PAGE_SIZE = 10000;
+
+/**
+ * Read the "limit" and "cursor" pagination options. Returns false if no
+ * limit was given, in which case the call returns all results at once.
+ */
+bool getAddressPageFromParams(const UniValue& params, size_t &limit, std::string &cursor)
+{
+    if (!params[0].isObject())
+        return false;
+
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
+    if (limitValue.isNull())
+        return false;
+    int nLimit = limitValue.get_int();
+    if (nLimit <= 0 || nLimit > MAX_ADDRESS_PAGE_SIZE)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Limit is expected to be between 1 and %d", MAX_ADDRESS_PAGE_SIZE));
+    limit = nLimit;
+
+    UniValue cursorValue = find_value(params[0].get_obj(), "cursor");
+    cursor = cursorValue.isNull() ? "" : cursorValue.get_str();
+    return true;
+}
+
+/** A cursor is the hex encoded index key the next page starts at */
+template <typename Key>
+std::string encodeAddressCursor(const Key& key)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << key;
+    return HexStr(ss.begin(), ss.end());
+}
+
+/** Decode a cursor, returning the position of its address among the requested ones */
+template <typename Key>
+size_t decodeAddressCursor(const std::string& cursor, const std::vector<std::pair<uint160, int> > &addresses, Key& key)
+{
+    if (!IsHex(cursor))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    std::vector<unsigned char> data(ParseHex(cursor));
+    CDataStream ss(data, SER_DISK, CLIENT_VERSION);
+    try {
+        ss >> key;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    for (size_t i = 0; i < addresses.size(); i++)
+        if (addresses[i].first == key.hashBytes && addresses[i].second == (int)key.type)
+            return i;
+    throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor does not belong to the requested addresses");
+}
+
+/**
+ * Read one page of address index entries, walking the addresses in the
+ * order given and continuing from cursor if it is not empty. Sets next to
+ * the cursor of the following page, or to an empty string on the last one.
+ */
+void getAddressIndexPage(const std::vector<std::pair<uint160, int> > &addresses, int start, int end,
+                         size_t limit, const std::string &cursor,
+                         std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, std::string &next)
+{
+    size_t i = 0;
+    CAddressIndexKey key(addresses[0].second, addresses[0].first, start, 0, uint256(), 0, false);
+    if (!cursor.empty())
+        i = decodeAddressCursor(cursor, addresses, key);
+
+    next.clear();
+    while (true) {
+        CAddressIndexKey nextKey;
+        bool fMore = false;
+        if (!GetAddressIndexPage(key, end, limit - addressIndex.size(), addressIndex, nextKey, fMore)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        if (fMore) {
+            next = encodeAddressCursor(nextKey);
+            return;
+        }
+        if (++i == addresses.size())
+            return;
+        key = CAddressIndexKey(addresses[i].second, addresses[i].first, start, 0, uint256(), 0, false);
+        if (addressIndex.size() >= limit) {
+            next = encodeAddressCursor(key);
+            return;
+        }
+    }
+}
+
+/** Like getAddressIndexPage, for unspent outputs */
+void getAddressUnspentPage(const std::vector<std::pair<uint160, int> > &addresses,
+                           size_t limit, const std::string &cursor,
+                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs, std::string &next)
+{
+    size_t i = 0;
+    CAddressUnspentKey key(addresses[0].second, addresses[0].first, uint256(), 0);
+    if (!cursor.empty())
+        i = decodeAddressCursor(cursor, addresses, key);
+
+    next.clear();
+    while (true) {
+        CAddressUnspentKey nextKey;
+        bool fMore = false;
+        if (!GetAddressUnspentPage(key, limit - unspentOutputs.size(), unspentOutputs, nextKey, fMore)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        if (fMore) {
+            next = encodeAddressCursor(nextKey);
+            return;
+        }
+        if (++i == addresses.size())
+            return;
+        key = CAddressUnspentKey(addresses[i].second, addresses[i].first, uint256(), 0);
+        if (unspentOutputs.size() >= limit) {
+            next = encodeAddressCursor(key);
+            return;
+        }
+    }
+}
+
+/** Wrap one page of results together with the cursor of the next page */
+UniValue addressPageResult(const std::string &name, const UniValue &values, const std::string &next)
+{
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair(name, values));
+    result.push_back(Pair("cursor", next.empty() ? NullUniValue : UniValue(next)));
+    return result;
+}
+
 UniValue getaddressmempool(const UniValue& params, bool fHelp)
 {
     if (fHelp || params.size() != 1)
@@ -673,6 +801,8 @@ UniValue getaddressutxos(const UniValue& params, bool fHelp)
             "      \"address\"  (string) The base58check encoded address\n"
             "      ,...\n"
             "    ]\n"
+            "  \"limit\" (number, optional) Return at most this many outputs (up to " + strprintf("%d", MAX_ADDRESS_PAGE_SIZE) + ") and a cursor for the rest\n"
+            "  \"cursor\" (string, optional) The cursor returned with the previous page\n"
             "}\n"
             "\nResult\n"
             "[\n"
@@ -685,8 +815,14 @@ UniValue getaddressutxos(const UniValue& params, bool fHelp)
             "    \"height\"  (number) The block height\n"
             "  }\n"
             "]\n"
+            "\nWith a limit, the result is an object instead:\n"
+            "{\n"
+            "  \"utxos\"  (array) The outputs as above, by address and then by txid rather than by height\n"
+            "  \"cursor\"  (string) The cursor of the next page, or null on the last one\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+            + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
             + HelpExampleRpc("getaddressutxos", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
@@ -698,13 +834,20 @@ UniValue getaddressutxos(const UniValue& params, bool fHelp)
 
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    size_t limit = 0;
+    std::string cursor, next;
+    bool fPaged = getAddressPageFromParams(params, limit, cursor);
+    if (fPaged) {
+        getAddressUnspentPage(addresses, limit, cursor, unspentOutputs, next);
+    } else {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
         }
-    }
 
-    std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
+        std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
+    }
 
     UniValue result(UniValue::VARR);
 
@@ -724,6 +867,8 @@ UniValue getaddressutxos(const UniValue& params, bool fHelp)
         result.push_back(output);
     }
 
+    if (fPaged)
+        return addressPageResult("utxos", result, next);
     return result;
 }
 
@@ -742,6 +887,9 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
             "    ]\n"
             "  \"start\" (number) The start block height\n"
             "  \"end\" (number) The end block height\n"
+            "  \"limit\" (number, optional) Return about this many deltas (up to " + strprintf("%d", MAX_ADDRESS_PAGE_SIZE) + ") and a cursor for the rest;\n"
+            "            a page is only cut between transactions\n"
+            "  \"cursor\" (string, optional) The cursor returned with the previous page\n"
             "}\n"
             "\nResult:\n"
             "[\n"
@@ -754,8 +902,14 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
             "    \"address\"  (string) The base58check encoded address\n"
             "  }\n"
             "]\n"
+            "\nWith a limit, the result is an object instead:\n"
+            "{\n"
+            "  \"deltas\"  (array) The deltas as above, by address and then by height\n"
+            "  \"cursor\"  (string) The cursor of the next page, or null on the last one\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+            + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
             + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
@@ -782,14 +936,21 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
 
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    size_t limit = 0;
+    std::string cursor, next;
+    bool fPaged = getAddressPageFromParams(params, limit, cursor);
+    if (fPaged) {
+        getAddressIndexPage(addresses, start, end, limit, cursor, addressIndex, next);
+    } else {
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (start > 0 && end > 0) {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+            } else {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
             }
         }
     }
@@ -812,6 +973,8 @@ UniValue getaddressdeltas(const UniValue& params, bool fHelp)
         result.push_back(delta);
     }
 
+    if (fPaged)
+        return addressPageResult("deltas", result, next);
     return result;
 }
 
@@ -833,6 +996,8 @@ UniValue getaddressbalance(const UniValue& params, bool fHelp)
             "{\n"
             "  \"balance\"  (string) The current balance in duffs\n"
             "  \"received\"  (string) The total number of duffs received (including change)\n"
+            "  \"txcount\"  (number) The number of transactions involving the address, summed over all addresses\n"
+            "  \"lastheight\"  (number) The height of the last block with a transaction involving any of the addresses\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressbalance", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
@@ -845,27 +1010,27 @@ UniValue getaddressbalance(const UniValue& params, bool fHelp)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-        }
-    }
-
     CAmount balance = 0;
     CAmount received = 0;
+    int64_t txCount = 0;
+    int lastHeight = 0;
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        if (it->second > 0) {
-            received += it->second;
+    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+        CAddressSummaryValue summary;
+        if (!GetAddressSummary((*it).first, (*it).second, summary)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
         }
-        balance += it->second;
+        balance += summary.balance;
+        received += summary.received;
+        txCount += summary.txCount;
+        lastHeight = std::max(lastHeight, summary.lastHeight);
     }
 
     UniValue result(UniValue::VOBJ);
     result.push_back(Pair("balance", balance));
     result.push_back(Pair("received", received));
+    result.push_back(Pair("txcount", txCount));
+    result.push_back(Pair("lastheight", lastHeight));
 
     return result;
 
@@ -886,14 +1051,23 @@ UniValue getaddresstxids(const UniValue& params, bool fHelp)
             "    ]\n"
             "  \"start\" (number) The start block height\n"
             "  \"end\" (number) The end block height\n"
+            "  \"limit\" (number, optional) Return about this many index entries' txids (up to " + strprintf("%d", MAX_ADDRESS_PAGE_SIZE) + ") and a cursor for the rest\n"
+            "  \"cursor\" (string, optional) The cursor returned with the previous page\n"
             "}\n"
             "\nResult:\n"
             "[\n"
             "  \"transactionid\"  (string) The transaction id\n"
             "  ,...\n"
             "]\n"
+            "\nWith a limit, the result is an object instead:\n"
+            "{\n"
+            "  \"txids\"  (array) The txids as above, by address and then by height; a txid\n"
+            "           only shows up again on a later page for another of the addresses\n"
+            "  \"cursor\"  (string) The cursor of the next page, or null on the last one\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}'")
+            + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"], \"limit\": 1000}'")
             + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
@@ -916,6 +1090,22 @@ UniValue getaddresstxids(const UniValue& params, bool fHelp)
 
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
+    size_t limit = 0;
+    std::string cursor, next;
+    if (getAddressPageFromParams(params, limit, cursor)) {
+        getAddressIndexPage(addresses, start, end, limit, cursor, addressIndex, next);
+
+        // Pages end on transaction boundaries, so deduplicating within the
+        // page is enough for any one address
+        std::set<uint256> seen;
+        UniValue txids(UniValue::VARR);
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
+            if (seen.insert(it->first.txhash).second)
+                txids.push_back(it->first.txhash.GetHex());
+        }
+        return addressPageResult("txids", txids, next);
+    }
+
     for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
         if (start > 0 && end > 0) {
             if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
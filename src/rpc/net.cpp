@@ -368,6 +368,59 @@ UniValue getnettotals(const UniValue& params, bool fHelp)
     return obj;
 }
 
+UniValue getmessagehandlerinfo(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() > 0)
+        throw runtime_error(
+            "getmessagehandlerinfo\n"
+            "\nReturns queue depth and latency of the p2p message handlers, by message type.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"workers\": [ n, ... ],       (array) Messages waiting for each message worker thread (see -msgworkers)\n"
+            "  \"handlers\":\n"
+            "  {\n"
+            "    \"command\": {               (object) Message type\n"
+            "      \"queued\": n,             (numeric) Messages waiting for a message worker\n"
+            "      \"processed\": n,          (numeric) Messages handled\n"
+            "      \"avglatency\": n,         (numeric) Average milliseconds from receipt until handled\n"
+            "      \"maxlatency\": n,         (numeric) Maximum milliseconds from receipt until handled\n"
+            "      \"avgtime\": n             (numeric) Average milliseconds spent in the handler\n"
+            "    }, ...\n"
+            "  }\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getmessagehandlerinfo", "")
+            + HelpExampleRpc("getmessagehandlerinfo", "")
+       );
+    if(!g_connman)
+        throw JSONRPCError(RPC_CLIENT_P2P_DISABLED, "Error: Peer-to-peer functionality missing or disabled");
+
+    std::map<std::string, CMessageHandlerStats> mapStats;
+    std::vector<size_t> vWorkerQueue;
+    g_connman->GetMessageHandlerStats(mapStats, vWorkerQueue);
+
+    UniValue obj(UniValue::VOBJ);
+    UniValue workers(UniValue::VARR);
+    BOOST_FOREACH(size_t nQueue, vWorkerQueue)
+        workers.push_back((uint64_t)nQueue);
+    obj.push_back(Pair("workers", workers));
+
+    UniValue handlers(UniValue::VOBJ);
+    for (const auto& item : mapStats)
+    {
+        const CMessageHandlerStats& stats = item.second;
+        UniValue handler(UniValue::VOBJ);
+        handler.push_back(Pair("queued", stats.nQueued));
+        handler.push_back(Pair("processed", stats.nProcessed));
+        handler.push_back(Pair("avglatency", stats.nProcessed ? 0.001 * stats.nTotalLatencyMicros / stats.nProcessed : 0.0));
+        handler.push_back(Pair("maxlatency", 0.001 * stats.nMaxLatencyMicros));
+        handler.push_back(Pair("avgtime", stats.nProcessed ? 0.001 * stats.nTotalTimeMicros / stats.nProcessed : 0.0));
+        handlers.push_back(Pair(item.first, handler));
+    }
+    obj.push_back(Pair("handlers", handlers));
+    return obj;
+}
+
 static UniValue GetNetworksInfo()
 {
     UniValue networks(UniValue::VARR);
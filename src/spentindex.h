@@ -331,6 +331,39 @@ struct CAddressIndexIteratorKey {
     }
 };
 
+/** Running totals over all address index entries of one address */
+struct CAddressSummaryValue {
+    CAmount balance;
+    CAmount received;
+    int64_t txCount;
+    int lastHeight;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(balance);
+        READWRITE(received);
+        READWRITE(txCount);
+        READWRITE(lastHeight);
+    }
+
+    CAddressSummaryValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+        txCount = 0;
+        lastHeight = 0;
+    }
+
+    bool IsNull() const {
+        return (txCount == 0);
+    }
+};
+
 struct CAddressIndexIteratorHeightKey {
     unsigned int type;
     uint160 hashBytes;
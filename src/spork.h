@@ -98,6 +98,8 @@ public:
 class CSporkManager
 {
 private:
+    // Protects mapSporksActive, mapSporks is written while also holding cs_main
+    CCriticalSection cs;
     std::vector<unsigned char> vchSig;
     std::string strMasterPrivKey;
     std::map<int, CSporkMessage> mapSporksActive;
@@ -0,0 +1,86 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockimport.h"
+#include "chainparams.h"
+#include "clientversion.h"
+#include "random.h"
+#include "streams.h"
+
+#include "test/test_chainox.h"
+
+#include <stdio.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockimport_tests, BasicTestingSetup)
+
+static CBlock ImportTestBlock(int nTxs)
+{
+    CBlock block;
+    block.nVersion = 42;
+    block.hashPrevBlock = GetRandHash();
+    for (int i = 0; i < nTxs; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout.hash = GetRandHash();
+        tx.vin[0].prevout.n = i;
+        tx.vout.resize(1);
+        tx.vout[0].nValue = i;
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+    return block;
+}
+
+// Append a block as it is stored in block files, with the size given in front of it
+static void WriteImportTestBlock(CDataStream& ss, const CBlock& block, unsigned int nSize)
+{
+    ss.write((const char*)Params().MessageStart(), MESSAGE_START_SIZE);
+    ss << nSize << block;
+}
+
+BOOST_AUTO_TEST_CASE(block_import_pipeline)
+{
+    std::vector<CBlock> vBlocks;
+    for (int i = 0; i < 50; i++)
+        vBlocks.push_back(ImportTestBlock(1 + i % 7));
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    std::vector<unsigned int> vPos;
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        unsigned int nSize = ::GetSerializeSize(vBlocks[i], SER_DISK, CLIENT_VERSION);
+        if (i == 10) {
+            // junk between blocks is skipped
+            ss << (unsigned char)0x17 << (unsigned char)0x42;
+        }
+        vPos.push_back(ss.size() + MESSAGE_START_SIZE + sizeof(nSize));
+        // a size reaching into the next block still gets the block, and the next one
+        WriteImportTestBlock(ss, vBlocks[i], i == 20 ? nSize + 10 : nSize);
+    }
+    // preallocated file space
+    std::vector<char> vZeroes(1000, 0);
+    ss.write(vZeroes.data(), vZeroes.size());
+
+    FILE* file = tmpfile();
+    BOOST_REQUIRE(file != NULL);
+    BOOST_REQUIRE(fwrite(&ss[0], 1, ss.size(), file) == ss.size());
+    rewind(file);
+
+    CBlockImportPipeline pipeline(file, Params().MessageStart(), 3);
+    CImportedBlock imported;
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        BOOST_REQUIRE(pipeline.Next(imported));
+        BOOST_REQUIRE(imported.pblock);
+        BOOST_CHECK(imported.pblock->GetHash() == vBlocks[i].GetHash());
+        BOOST_CHECK_EQUAL(imported.pblock->vtx.size(), vBlocks[i].vtx.size());
+        BOOST_CHECK_EQUAL(imported.nPos, vPos[i]);
+    }
+    BOOST_CHECK(!pipeline.Next(imported));
+
+    CBlockImportStats stats = pipeline.GetStats();
+    BOOST_CHECK_EQUAL(stats.nParsed, vBlocks.size());
+    BOOST_CHECK_EQUAL(stats.nParseFailures, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,11 +2,15 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "chainparams.h"
 #include "coins.h"
+#include "miner.h"
+#include "pow.h"
 #include "random.h"
 #include "script/standard.h"
 #include "uint256.h"
 #include "undo.h"
+#include "txdb.h"
 #include "utilstrencodings.h"
 #include "test/test_chainox.h"
 #include "validation.h"
@@ -70,6 +74,12 @@ public:
             hashBestBlock_ = hashBlock;
         return true;
     }
+
+    bool BatchWritePartial(CCoinsMap& mapCoins, const uint256& hashBlock) override
+    {
+        // Not consistent with hashBlock yet
+        return BatchWrite(mapCoins, uint256());
+    }
 };
 
 class CCoinsViewCacheTest : public CCoinsViewCache
@@ -860,4 +870,174 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_sync_evict)
+{
+    CCoinsViewTest base;
+    CCoinsViewCacheTest cache(&base);
+    std::vector<COutPoint> vOutpoints;
+    for (int i = 0; i < 100; i++) {
+        COutPoint outpoint(GetRandHash(), i);
+        cache.AddCoin(outpoint, Coin(CTxOut(i + 1, CScript() << OP_TRUE), 1, false), false);
+        vOutpoints.push_back(outpoint);
+    }
+    uint256 hashBlock = GetRandHash();
+    cache.SetBestBlock(hashBlock);
+
+    // The coins modified first are written as a chunk and stay cached, the
+    // base view is not consistent yet
+    BOOST_CHECK_EQUAL(cache.GetSyncQueueSize(), 100U);
+    BOOST_CHECK(cache.SyncChunk(30));
+    BOOST_CHECK_EQUAL(cache.GetSyncQueueSize(), 70U);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 100U);
+    BOOST_CHECK(base.GetBestBlock().IsNull());
+    for (size_t i = 0; i < vOutpoints.size(); i++) {
+        Coin coin;
+        BOOST_CHECK_EQUAL(base.GetCoin(vOutpoints[i], coin), i < 30);
+        if (i < 30) {
+            BOOST_CHECK_EQUAL(coin.out.nValue, (CAmount)i + 1);
+            BOOST_CHECK_EQUAL(cache.map()[vOutpoints[i]].flags, 0);
+        }
+    }
+
+    // A written coin modified again is queued again, one modified twice is
+    // queued once
+    BOOST_CHECK(cache.SpendCoin(vOutpoints[0]));
+    cache.AddCoin(vOutpoints[0], Coin(CTxOut(1, CScript() << OP_TRUE), 1, false), true);
+    BOOST_CHECK_EQUAL(cache.GetSyncQueueSize(), 71U);
+
+    // The rest, including a coin spent in between, go with the sync
+    BOOST_CHECK(cache.SpendCoin(vOutpoints[99]));
+    BOOST_CHECK(cache.Sync(30));
+    BOOST_CHECK(base.GetBestBlock() == hashBlock);
+    BOOST_CHECK_EQUAL(cache.GetSyncQueueSize(), 0U);
+    for (size_t i = 0; i < vOutpoints.size(); i++) {
+        Coin coin;
+        base.GetCoin(vOutpoints[i], coin);
+        BOOST_CHECK_EQUAL(coin.IsSpent(), i == 99);
+        if (i < 99)
+            BOOST_CHECK_EQUAL(cache.map()[vOutpoints[i]].flags, 0);
+    }
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 99U);
+    cache.SelfTest();
+
+    // A coin looked up since gets a second chance
+    uint64_t nHits, nMisses;
+    cache.GetLookupStats(nHits, nMisses);
+    BOOST_CHECK(!cache.AccessCoin(vOutpoints[0]).IsSpent());
+    uint64_t nHitsAfter, nMissesAfter;
+    cache.GetLookupStats(nHitsAfter, nMissesAfter);
+    BOOST_CHECK_EQUAL(nHitsAfter, nHits + 1);
+    BOOST_CHECK_EQUAL(nMissesAfter, nMisses);
+    BOOST_CHECK_EQUAL(cache.Evict(cache.DynamicMemoryUsage() - 1), 1U);
+    BOOST_CHECK(cache.HaveCoinInCache(vOutpoints[0]));
+    cache.SelfTest();
+
+    // Modified coins are never evicted
+    BOOST_CHECK(cache.SpendCoin(vOutpoints[1]));
+    cache.Evict(0);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 1U);
+    cache.SelfTest();
+    BOOST_CHECK(cache.Sync(30));
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+    Coin coin;
+    base.GetCoin(vOutpoints[1], coin);
+    BOOST_CHECK(coin.IsSpent());
+    cache.SelfTest();
+
+    // A chunk that leaves no modified coins behind makes the base view
+    // consistent without a sync
+    uint256 hashBlockNext = GetRandHash();
+    cache.SetBestBlock(hashBlockNext);
+    cache.AddCoin(vOutpoints[1], Coin(CTxOut(2, CScript() << OP_TRUE), 2, false), true);
+    BOOST_CHECK(cache.SyncChunk(30));
+    BOOST_CHECK_EQUAL(cache.GetSyncQueueSize(), 0U);
+    BOOST_CHECK(base.GetBestBlock() == hashBlockNext);
+    BOOST_CHECK(base.GetCoin(vOutpoints[1], coin));
+    cache.SelfTest();
+}
+
+
+// A few regtest blocks on top of genesis, the replay test only needs the tip,
+// its parent and its grandparent.
+struct ReplayBlocksSetup : public TestingSetup {
+    std::vector<uint256> vCoinbases;
+
+    ReplayBlocksSetup() : TestingSetup(CBaseChainParams::REGTEST)
+    {
+        CScript scriptPubKey = CScript() << OP_TRUE;
+        for (int i = 0; i < 3; i++) {
+            CBlockTemplate *pblocktemplate = CreateNewBlock(Params(), scriptPubKey);
+            CBlock& block = pblocktemplate->block;
+            block.vtx.resize(1);
+            unsigned int extraNonce = 0;
+            IncrementExtraNonce(&block, chainActive.Tip(), extraNonce);
+            while (!CheckProofOfWork(block.GetHash(), block.nBits, Params().GetConsensus())) ++block.nNonce;
+            BOOST_CHECK(ProcessNewBlock(Params(), &block, true, NULL, NULL));
+            vCoinbases.push_back(block.vtx[0]->GetHash());
+            delete pblocktemplate;
+        }
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(ccoins_replay_blocks, ReplayBlocksSetup)
+{
+    FlushStateToDisk();
+    CBlockIndex* pindexTip;
+    {
+        LOCK(cs_main);
+        pindexTip = chainActive.Tip();
+    }
+    BOOST_CHECK_EQUAL(pindexTip->nHeight, 3);
+    const uint256 hashTip = pindexTip->GetBlockHash();
+    const uint256 hashPrev = pindexTip->pprev->GetBlockHash();
+    const uint256 hashPrev2 = pindexTip->pprev->pprev->GetBlockHash();
+    const COutPoint outTip(vCoinbases[2], 0);
+    const COutPoint outPrev(vCoinbases[1], 0);
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashTip);
+    BOOST_CHECK(pcoinsdbview->GetHeadBlocks().empty());
+    BOOST_CHECK(pcoinsdbview->HaveCoin(outTip));
+
+    // A write from the state at the tip's grandparent to the tip that was
+    // interrupted before the tip's coinbase got in
+    CCoinsMap mapEmpty;
+    BOOST_CHECK(pcoinsdbview->BatchWrite(mapEmpty, hashPrev2));
+    CCoinsMap mapPartial;
+    mapPartial[outTip].flags = CCoinsCacheEntry::DIRTY;
+    BOOST_CHECK(pcoinsdbview->BatchWritePartial(mapPartial, hashTip));
+    BOOST_CHECK(pcoinsdbview->GetBestBlock().IsNull());
+    BOOST_CHECK(!pcoinsdbview->HaveCoin(outTip));
+    std::vector<uint256> vHeads = pcoinsdbview->GetHeadBlocks();
+    BOOST_CHECK_EQUAL(vHeads.size(), 2U);
+    BOOST_CHECK(vHeads[0] == hashTip && vHeads[1] == hashPrev2);
+
+    // Further partial writes keep the last consistent state
+    BOOST_CHECK(pcoinsdbview->BatchWritePartial(mapEmpty, hashTip));
+    vHeads = pcoinsdbview->GetHeadBlocks();
+    BOOST_CHECK_EQUAL(vHeads.size(), 2U);
+    BOOST_CHECK(vHeads[0] == hashTip && vHeads[1] == hashPrev2);
+
+    // Replaying rolls forward to the tip
+    BOOST_CHECK(ReplayBlocks(Params(), pcoinsdbview));
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashTip);
+    BOOST_CHECK(pcoinsdbview->GetHeadBlocks().empty());
+    BOOST_CHECK(pcoinsdbview->HaveCoin(outTip));
+    BOOST_CHECK(pcoinsdbview->HaveCoin(outPrev));
+
+    // A write from the tip back to its parent, interrupted before the tip's
+    // coinbase got out: replaying rolls back
+    BOOST_CHECK(pcoinsdbview->BatchWritePartial(mapEmpty, hashPrev));
+    vHeads = pcoinsdbview->GetHeadBlocks();
+    BOOST_CHECK_EQUAL(vHeads.size(), 2U);
+    BOOST_CHECK(vHeads[0] == hashPrev && vHeads[1] == hashTip);
+    BOOST_CHECK(ReplayBlocks(Params(), pcoinsdbview));
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashPrev);
+    BOOST_CHECK(pcoinsdbview->GetHeadBlocks().empty());
+    BOOST_CHECK(!pcoinsdbview->HaveCoin(outTip));
+    BOOST_CHECK(pcoinsdbview->HaveCoin(outPrev));
+
+    // A consistent database is left alone
+    BOOST_CHECK(ReplayBlocks(Params(), pcoinsdbview));
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashPrev);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinsprefetch.h"
+#include "random.h"
+#include "utiltime.h"
+
+#include "test/test_chainox.h"
+
+#include <map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+//! Read-only while the prefetch threads run, like the coins database between writes
+class CCoinsViewPrefetchTest : public CCoinsView
+{
+public:
+    std::map<COutPoint, Coin> mapCoins;
+
+    bool GetCoin(const COutPoint& outpoint, Coin& coin) const override
+    {
+        std::map<COutPoint, Coin>::const_iterator it = mapCoins.find(outpoint);
+        if (it == mapCoins.end())
+            return false;
+        coin = it->second;
+        return true;
+    }
+
+    bool BatchWrite(CCoinsMap& mapCoinsIn, const uint256& hashBlock) override
+    {
+        for (CCoinsMap::iterator it = mapCoinsIn.begin(); it != mapCoinsIn.end(); it = mapCoinsIn.erase(it)) {
+            if (it->second.coin.IsSpent())
+                mapCoins.erase(it->first);
+            else
+                mapCoins[it->first] = it->second.coin;
+        }
+        return true;
+    }
+};
+
+void WaitForPrefetch(const CCoinsViewPrefetch& view, uint64_t nRead)
+{
+    for (int i = 0; i < 1000; i++) {
+        CCoinsPrefetchStats stats = view.GetStats();
+        if (stats.nFetched + stats.nDiscarded >= nRead)
+            return;
+        MilliSleep(10);
+    }
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(coinsprefetch_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(coinsprefetch_lookups)
+{
+    CCoinsViewPrefetchTest base;
+    std::vector<COutPoint> vOutpoints;
+    for (int i = 0; i < 100; i++) {
+        COutPoint outpoint(GetRandHash(), i);
+        base.mapCoins[outpoint] = Coin(CTxOut(i + 1, CScript()), i, false);
+        vOutpoints.push_back(outpoint);
+    }
+    // not in the database
+    COutPoint outpointMissing(GetRandHash(), 0);
+    vOutpoints.push_back(outpointMissing);
+
+    CCoinsViewPrefetch view(&base, 4);
+    view.Prefetch(vOutpoints);
+    view.Prefetch(vOutpoints);
+    WaitForPrefetch(view, vOutpoints.size());
+    CCoinsPrefetchStats stats = view.GetStats();
+    BOOST_CHECK_EQUAL(stats.nQueued, vOutpoints.size());
+    BOOST_CHECK_EQUAL(stats.nFetched, vOutpoints.size());
+
+    for (int i = 0; i < 100; i++) {
+        Coin coin;
+        BOOST_CHECK(view.GetCoin(vOutpoints[i], coin));
+        BOOST_CHECK_EQUAL(coin.out.nValue, i + 1);
+        BOOST_CHECK_EQUAL(coin.nHeight, (unsigned int)i);
+    }
+    Coin coin;
+    BOOST_CHECK(!view.GetCoin(outpointMissing, coin));
+    stats = view.GetStats();
+    BOOST_CHECK_EQUAL(stats.nHits, vOutpoints.size());
+    BOOST_CHECK_EQUAL(stats.nMisses, 0U);
+
+    // each prefetched coin serves one lookup, the next one reads it again
+    BOOST_CHECK(view.GetCoin(vOutpoints[0], coin));
+    BOOST_CHECK_EQUAL(view.GetStats().nMisses, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(coinsprefetch_write)
+{
+    CCoinsViewPrefetchTest base;
+    COutPoint outpoint(GetRandHash(), 0);
+    base.mapCoins[outpoint] = Coin(CTxOut(1, CScript()), 1, false);
+
+    CCoinsViewPrefetch view(&base, 2);
+    view.Prefetch(std::vector<COutPoint>(1, outpoint));
+    WaitForPrefetch(view, 1);
+    BOOST_CHECK(view.HaveCoin(outpoint));
+
+    // Spending the coin outdates the prefetched one
+    CCoinsViewCache cache(&view);
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(view.GetStats().nHits, 1U);
+    BOOST_CHECK(!view.HaveCoin(outpoint));
+    Coin coin;
+    BOOST_CHECK(!view.GetCoin(outpoint, coin));
+
+    // Discarded ones are not looked up anymore
+    COutPoint outpoint2(GetRandHash(), 0);
+    base.mapCoins[outpoint2] = Coin(CTxOut(2, CScript()), 1, false);
+    view.Prefetch(std::vector<COutPoint>(1, outpoint2));
+    WaitForPrefetch(view, 2);
+    view.Discard(std::vector<COutPoint>(1, outpoint2));
+    CCoinsPrefetchStats stats = view.GetStats();
+    BOOST_CHECK(view.GetCoin(outpoint2, coin));
+    BOOST_CHECK_EQUAL(view.GetStats().nMisses, stats.nMisses + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,12 +3,19 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "hash.h"
+#include "crypto/phichox.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "streams.h"
 #include "utilstrencodings.h"
+#include "version.h"
 #include "test/test_chainox.h"
 
 #include <vector>
 
+#include <boost/foreach.hpp>
 #include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
 
 using namespace std;
 
@@ -85,4 +92,199 @@ BOOST_AUTO_TEST_CASE(siphash)
     }*/
 }
 
+BOOST_AUTO_TEST_CASE(blockheader_hash_cache)
+{
+    CBlockHeader header;
+    header.nVersion = 1;
+    header.hashPrevBlock = uint256S("00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+    header.hashMerkleRoot = uint256S("e0028eb9648db56b1ac77cf090b99048a8007e2bb64b68f092c03c7f56a662c7");
+    header.nTime = 1646118000;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = 42;
+
+    // Cached and uncached paths agree, and repeated calls are stable
+    uint256 hash = header.GetHash();
+    BOOST_CHECK(hash == header.ComputeHash());
+    BOOST_CHECK(hash == header.GetHash());
+
+    // Every header field takes part in cache invalidation
+    header.nNonce++;
+    BOOST_CHECK(header.GetHash() != hash);
+    BOOST_CHECK(header.GetHash() == header.ComputeHash());
+    header.nNonce--;
+    BOOST_CHECK(header.GetHash() == hash);
+
+    header.hashMerkleRoot = uint256S("01");
+    BOOST_CHECK(header.GetHash() == header.ComputeHash());
+    header.nTime = 1644451200;
+    BOOST_CHECK(header.GetHash() == header.ComputeHash());
+
+    // Copies carry a still-valid cache along
+    CBlockHeader copy = header;
+    BOOST_CHECK(copy.GetHash() == header.ComputeHash());
+    copy.nBits = 0x1d00ffff;
+    BOOST_CHECK(copy.GetHash() != header.GetHash());
+
+    // phiCHOX selects its branch from the last hex digit of hashPrevBlock,
+    // which is the low nibble of its first byte
+    for (int i = 0; i < 64; i++) {
+        uint256 hashPrev = GetRandHash();
+        BOOST_CHECK_EQUAL(hashPrev.ToString().back(), "0123456789abcdef"[*hashPrev.begin() & 0x0f]);
+    }
+}
+
+static void HashSharedBlock(const CBlock* pblock, uint256* phash)
+{
+    for (int i = 0; i < 100; i++)
+        *phash = pblock->GetHash();
+}
+
+BOOST_AUTO_TEST_CASE(blockheader_hash_cache_threads)
+{
+    // One block hashed by several threads at once, as blocks handed to the
+    // validation interface queues are
+    CBlock block;
+    block.nVersion = 1;
+    block.hashPrevBlock = uint256S("00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+    block.nTime = 1646118000;
+    block.nBits = 0x1e0ffff0;
+    const uint256 hash = block.ComputeHash();
+
+    std::vector<uint256> vHashes(4);
+    boost::thread_group threads;
+    for (size_t i = 0; i < vHashes.size(); i++)
+        threads.create_thread(boost::bind(&HashSharedBlock, &block, &vHashes[i]));
+    threads.join_all();
+
+    BOOST_FOREACH(const uint256& hashThread, vHashes)
+        BOOST_CHECK(hashThread == hash);
+    BOOST_CHECK(block.GetHash() == hash);
+}
+
+BOOST_AUTO_TEST_CASE(blockheader_precompute_hashes)
+{
+    // A run that mixes all phiCHOX phases and branches with pre-phiCHOX
+    // headers, and is not a multiple of the batch kernels' lane count
+    static const uint32_t times[] = {1600000000, 1645340400, 1644451200 + 86400, 1646118000, 1700000000};
+    std::vector<CBlockHeader> headers(37);
+    for (size_t i = 0; i < headers.size(); i++) {
+        headers[i].nVersion = 0x20000000;
+        headers[i].hashPrevBlock = GetRandHash();
+        headers[i].hashMerkleRoot = GetRandHash();
+        headers[i].nTime = times[i % 5];
+        headers[i].nBits = 0x1e0ffff0;
+        headers[i].nNonce = i;
+    }
+
+    CBlockHeader::PrecomputeHashes(headers);
+    for (const CBlockHeader& header : headers)
+        BOOST_CHECK(header.GetHash() == header.ComputeHash());
+}
+
+
+BOOST_AUTO_TEST_CASE(phichox_batch_same_phase)
+{
+    // Runs of headers on the same branch, so that every group of four goes
+    // through the multi-lane kernels (Phase3x4 for phase 3) when the CPU has
+    // them, checked against the scalar hasher one header at a time
+    std::vector<std::pair<uint32_t, int> > branches;
+    branches.push_back(std::make_pair(1600000000, 0));
+    for (int nNibble = 0; nNibble < 16; nNibble++)
+        branches.push_back(std::make_pair(1645340400, nNibble));
+    branches.push_back(std::make_pair(1646118000, 0));
+    branches.push_back(std::make_pair(1700000000, 7));
+
+    for (size_t b = 0; b < branches.size(); b++) {
+        std::vector<CBlockHeader> headers(9);
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        for (size_t i = 0; i < headers.size(); i++) {
+            headers[i].nVersion = 0x20000000;
+            headers[i].hashPrevBlock = GetRandHash();
+            *headers[i].hashPrevBlock.begin() = (*headers[i].hashPrevBlock.begin() & 0xf0) | branches[b].second;
+            headers[i].hashMerkleRoot = GetRandHash();
+            headers[i].nTime = branches[b].first;
+            headers[i].nBits = 0x1e0ffff0;
+            headers[i].nNonce = insecure_rand();
+            ss << headers[i];
+        }
+        BOOST_CHECK_EQUAL(ss.size(), 80 * headers.size());
+
+        std::vector<unsigned char> vBatch(32 * headers.size());
+        PhiCHOXHeaders(vBatch.data(), (const unsigned char*)ss.data(), headers.size());
+        for (size_t i = 0; i < headers.size(); i++) {
+            uint256 hashScalar;
+            CPhiCHOX(headers[i].nTime, *headers[i].hashPrevBlock.begin()).Write((const unsigned char*)ss.data() + 80 * i, 80).Finalize(hashScalar.begin());
+            BOOST_CHECK(uint256(std::vector<unsigned char>(vBatch.begin() + 32 * i, vBatch.begin() + 32 * (i + 1))) == hashScalar);
+            // Block hashes only switched to phiCHOX at 1645340400
+            if (headers[i].nTime >= 1645340400)
+                BOOST_CHECK(headers[i].ComputeHash() == hashScalar);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(phichox_known_answers)
+{
+    // Computed with the original phiCHOX in hash.h: the pre-fork chain, all
+    // sixteen selector digits of the second era and the final chain
+    static const struct {
+        uint32_t nTime;
+        unsigned char nNibble;
+        const char* hash;
+    } vectors[] = {
+        {1600000000, 0xa, "99d2b7d152d3865ff4ce791d4d5545ca2ba3bb54e4de17b5d2d21dc0383dd731"},
+        {1645340400, 0x0, "35819d9fcb4e9e94195db06c7ab1aee2028c9b6f112cfbc93b3c516549bb9f9d"},
+        {1645340400, 0x1, "413bf6c31df8c286787fb9c9a33da143ab30bbd644024064c3ab456bfec02927"},
+        {1645340400, 0x2, "3ed8f172a5421d56d813d81ebc6b0ae46d011b140869e27d115b6596cae3e8ed"},
+        {1645340400, 0x3, "a3ca810208d5917238c93fb16f72f161ae23a3219dde4a03eb0de2e4719321c5"},
+        {1645340400, 0x4, "245b8acc65fc19b1210789d05b54219e5e5bdf405979446e66dcacc717a058b1"},
+        {1645340400, 0x5, "1b65bba6da719511d5c1697edd9d249761a3b7a41c1675679755cdebf87b6c44"},
+        {1645340400, 0x6, "c13cc5289a64462b9fe455540777a70d8bb22e480c8516a82d36562940702404"},
+        {1645340400, 0x7, "3b8059fcb749187ceb2142abe9848cd6ab420f28f9c37cb141f214494d610acb"},
+        {1645340400, 0x8, "ee069763308cf779e0a4473238f202e8db81702cb1eefa6c38af0b19eb554d38"},
+        {1645340400, 0x9, "e822def761ab92d11cb8ac8be29b93e65861429dba6ecab89d0f1dde0f7d9cf6"},
+        {1645340400, 0xa, "3ade573ae06cfa32c9a436aed62e178727e451f9679643e8190cba18492efa57"},
+        {1645340400, 0xb, "2897997944bad98b7d76e530fcd4c50c18d1e70b71c4e3d5440b9c64b862ea02"},
+        {1645340400, 0xc, "f952a5511ad24f1f2791bfde33ebc8fd9895220b7169a4a153391c12da5bb293"},
+        {1645340400, 0xd, "4029705f0c64614bd9a0eab23291cd1f22f7c7e50a784b7b3de81074f405c1d8"},
+        {1645340400, 0xe, "902d22ab46fc6af91074191033819ee03ce31ddcc58f2989e30025c5c66460de"},
+        {1645340400, 0xf, "7176302c2584ff22801e10b509c6d73a06fa5a44ea83284d8dca5cc10f543a57"},
+        {1646118000, 0x3, "a67a5e87668b6bb12c18884710f53daf04c4adb0c509816f94091ac28723eb2a"},
+        {1700000000, 0xc, "e81ca5bcfbdc3baf6fde657fefdb2aadc28fa185b92dbe8e4987016fa782478e"}
+    };
+    static const size_t nVectors = sizeof(vectors) / sizeof(vectors[0]);
+
+    // Each header is written four times in a row, so the batch goes through
+    // the multi-lane kernels as well
+    std::vector<CBlockHeader> headers;
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    for (size_t i = 0; i < nVectors; i++) {
+        CBlockHeader header;
+        header.nVersion = 0x20000000;
+        header.hashPrevBlock = uint256S(std::string("000000000007b2f1c3a4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f708192") + "0123456789abcdef"[vectors[i].nNibble]);
+        header.hashMerkleRoot = uint256S("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+        header.nTime = vectors[i].nTime;
+        header.nBits = 0x1e0ffff0;
+        header.nNonce = 42;
+        BOOST_CHECK_EQUAL(*header.hashPrevBlock.begin() & 0x0f, vectors[i].nNibble);
+        for (int j = 0; j < 4; j++) {
+            headers.push_back(header);
+            ss << header;
+        }
+    }
+
+    std::vector<unsigned char> vBatch(32 * headers.size());
+    PhiCHOXHeaders(vBatch.data(), (const unsigned char*)ss.data(), headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        const uint256 expected = uint256S(vectors[i / 4].hash);
+        uint256 hashScalar;
+        CPhiCHOX(headers[i].nTime, *headers[i].hashPrevBlock.begin()).Write((const unsigned char*)ss.data() + 80 * i, 80).Finalize(hashScalar.begin());
+        BOOST_CHECK_EQUAL(hashScalar.ToString(), expected.ToString());
+        BOOST_CHECK_EQUAL(uint256(std::vector<unsigned char>(vBatch.begin() + 32 * i, vBatch.begin() + 32 * (i + 1))).ToString(), expected.ToString());
+        // Block hashes only switched to phiCHOX at 1645340400
+        if (headers[i].nTime >= 1645340400)
+            BOOST_CHECK_EQUAL(headers[i].ComputeHash().ToString(), expected.ToString());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 // Copyright (c) 2014-2017 The Dash Core developers
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "blockfilereader.h"
 #include "chainparams.h"
 #include "validation.h"
 #include "net.h"
@@ -79,4 +80,59 @@ BOOST_AUTO_TEST_CASE(test_combiner_all)
     Test.disconnect(&ReturnTrue);
     BOOST_CHECK(Test());
 }
+
+BOOST_AUTO_TEST_CASE(read_raw_block)
+{
+    const CChainParams& chainparams = Params();
+    CBlockIndex* pindex = chainActive.Genesis();
+    BOOST_REQUIRE(pindex != NULL);
+
+    CBlock block;
+    BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()));
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << block;
+
+    // The raw bytes are what goes out in a block message
+    std::vector<unsigned char> vchBlock;
+    BOOST_REQUIRE(ReadRawBlockFromDisk(vchBlock, pindex->GetBlockPos(), chainparams.MessageStart()));
+    BOOST_CHECK(std::vector<unsigned char>(ss.begin(), ss.end()) == vchBlock);
+
+    // Wrong network magic
+    CMessageHeader::MessageStartChars messageStart;
+    memcpy(messageStart, chainparams.MessageStart(), MESSAGE_START_SIZE);
+    messageStart[0] ^= 0xff;
+    BOOST_CHECK(!ReadRawBlockFromDisk(vchBlock, pindex->GetBlockPos(), messageStart));
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader)
+{
+    const CChainParams& chainparams = Params();
+    CBlockIndex* pindex = chainActive.Genesis();
+    BOOST_REQUIRE(pindex != NULL);
+    CDiskBlockPos pos = pindex->GetBlockPos();
+
+    // A block read from disk is decoded once and kept
+    blockFileReader.Clear();
+    CBlock block;
+    BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()));
+    std::shared_ptr<const CBlock> pblock = blockFileReader.GetBlock(pos);
+    BOOST_REQUIRE(pblock);
+    BOOST_CHECK(pblock->GetHash() == pindex->GetBlockHash());
+
+    CBlock blockCached;
+    BOOST_REQUIRE(ReadBlockFromDisk(blockCached, pindex, chainparams.GetConsensus()));
+    BOOST_CHECK(blockCached.GetHash() == block.GetHash());
+    BOOST_CHECK(blockCached.vtx[0] == pblock->vtx[0]);
+
+    // Forgetting the file drops its blocks, which are read again from disk
+    blockFileReader.Forget(pos.nFile);
+    BOOST_CHECK(!blockFileReader.GetBlock(pos));
+    BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()));
+    BOOST_CHECK(block.GetHash() == pindex->GetBlockHash());
+
+    // Files that don't exist can't be read
+    BOOST_CHECK(!blockFileReader.GetFile(CDiskBlockPos(pos.nFile + 1000, 8)));
+    BOOST_CHECK(!ReadBlockFromDisk(block, CDiskBlockPos(pos.nFile + 1000, 8), chainparams.GetConsensus()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -443,7 +443,7 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     pool.addUnchecked(tx5.GetHash(), entry.Fee(1000LL).FromTx(tx5, &pool));
     pool.addUnchecked(tx7.GetHash(), entry.Fee(9000LL).FromTx(tx7, &pool));
 
-    std::vector<CTransaction> vtx;
+    std::vector<CTransactionRef> vtx;
     std::list<CTransaction> conflicts;
     SetMockTime(42);
     SetMockTime(42 + CTxMemPool::ROLLING_FEE_HALFLIFE);
@@ -473,4 +473,31 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     SetMockTime(0);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolSharedTxTest)
+{
+    CTxMemPool pool(CFeeRate(0));
+    LockPoints lp;
+
+    CMutableTransaction mtx;
+    mtx.vin.resize(1);
+    mtx.vin[0].scriptSig = CScript() << OP_11;
+    mtx.vout.resize(1);
+    mtx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    mtx.vout[0].nValue = 10 * COIN;
+    CTransactionRef ptx = MakeTransactionRef(mtx);
+
+    // The entry and lookups hand out the same transaction instead of copies
+    pool.addUnchecked(ptx->GetHash(), CTxMemPoolEntry(ptx, 1000, 0, 0.0, 1, true, 0, false, 1, lp));
+    BOOST_CHECK(pool.get(ptx->GetHash()) == ptx);
+    BOOST_CHECK(pool.mapTx.find(ptx->GetHash())->GetSharedTx() == ptx);
+    BOOST_CHECK(!pool.get(uint256S("01")));
+
+    std::vector<CTransactionRef> vtx(1, ptx);
+    std::list<CTransaction> conflicts;
+    pool.removeForBlock(vtx, 1, conflicts);
+    BOOST_CHECK_EQUAL(pool.size(), 0);
+    BOOST_CHECK(!pool.get(ptx->GetHash()));
+    BOOST_CHECK_EQUAL(ptx.use_count(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
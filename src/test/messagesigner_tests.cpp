@@ -0,0 +1,61 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "messagesigner.h"
+
+#include "test/test_chainox.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(messagesigner_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(messagesigner_verify_cached)
+{
+    CKey key, keyOther;
+    key.MakeNewKey(true);
+    keyOther.MakeNewKey(true);
+    std::string strMessage = "messagesigner_verify_cached";
+    std::string strError;
+
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(CMessageSigner::SignMessage(strMessage, vchSig, key));
+
+    // the second check is answered by the cache and must give the same result
+    for (int i = 0; i < 2; i++) {
+        BOOST_CHECK(CMessageSigner::VerifyMessage(key.GetPubKey(), vchSig, strMessage, strError));
+        BOOST_CHECK(!CMessageSigner::VerifyMessage(keyOther.GetPubKey(), vchSig, strMessage, strError));
+        BOOST_CHECK(!CMessageSigner::VerifyMessage(key.GetPubKey(), vchSig, strMessage + "x", strError));
+    }
+
+    std::vector<unsigned char> vchSigBad(vchSig);
+    vchSigBad[10] ^= 1;
+    BOOST_CHECK(!CMessageSigner::VerifyMessage(key.GetPubKey(), vchSigBad, strMessage, strError));
+}
+
+BOOST_AUTO_TEST_CASE(messagesigner_batch)
+{
+    std::vector<CKey> vKeys(10);
+    std::vector<std::vector<unsigned char> > vSigs(vKeys.size());
+    for (size_t i = 0; i < vKeys.size(); i++) {
+        vKeys[i].MakeNewKey(true);
+        BOOST_CHECK(CMessageSigner::SignMessage(strprintf("messagesigner_batch %d", i), vSigs[i], vKeys[i]));
+    }
+
+    // every other signature is checked against the wrong key
+    CSignatureBatch batch;
+    for (size_t i = 0; i < vKeys.size(); i++) {
+        batch.AddMessage(vKeys[i % 2 ? 0 : i].GetPubKey(), vSigs[i], strprintf("messagesigner_batch %d", i));
+    }
+    BOOST_CHECK_EQUAL(batch.size(), vKeys.size());
+    batch.Verify();
+    BOOST_CHECK_EQUAL(batch.size(), 0U);
+
+    std::string strError;
+    for (size_t i = 0; i < vKeys.size(); i++) {
+        bool fValid = CMessageSigner::VerifyMessage(vKeys[i % 2 ? 0 : i].GetPubKey(), vSigs[i], strprintf("messagesigner_batch %d", i), strError);
+        BOOST_CHECK_EQUAL(fValid, i % 2 == 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,10 +7,12 @@
 #include "consensus/consensus.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "key.h"
 #include "validation.h"
 #include "masternode-payments.h"
 #include "miner.h"
 #include "pubkey.h"
+#include "script/sign.h"
 #include "script/standard.h"
 #include "txmempool.h"
 #include "uint256.h"
@@ -104,17 +106,17 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
         CBlock *pblock = &pblocktemplate->block; // pointer for convenience
         pblock->nVersion = 1;
         pblock->nTime = chainActive.Tip()->GetMedianTimePast()+1;
-        CMutableTransaction txCoinbase(pblock->vtx[0]);
+        CMutableTransaction txCoinbase(*pblock->vtx[0]);
         txCoinbase.nVersion = 1;
         txCoinbase.vin[0].scriptSig = CScript();
         txCoinbase.vin[0].scriptSig.push_back(blockinfo[i].extranonce);
         txCoinbase.vin[0].scriptSig.push_back(chainActive.Height());
         txCoinbase.vout[0].scriptPubKey = CScript();
-        pblock->vtx[0] = CTransaction(txCoinbase);
+        pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
         if (txFirst.size() == 0)
             baseheight = chainActive.Height();
         if (txFirst.size() < 4)
-            txFirst.push_back(new CTransaction(pblock->vtx[0]));
+            txFirst.push_back(new CTransaction(*pblock->vtx[0]));
         pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
         pblock->nNonce = blockinfo[i].nonce;
         BOOST_CHECK(ProcessNewBlock(chainparams, pblock, true, NULL, NULL));
@@ -388,4 +390,175 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+// Spend the output of a P2PK coinbase to OP_TRUE, leaving nFee
+static CMutableTransaction SpendCoinbase(const CTransaction& txCoinbase, const CKey& key, CAmount nFee)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(txCoinbase.GetHash(), 0);
+    tx.vout.resize(1);
+    tx.vout[0].nValue = txCoinbase.vout[0].nValue - nFee;
+    tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(txCoinbase.vout[0].scriptPubKey, tx, 0, SIGHASH_ALL);
+    BOOST_CHECK(key.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    tx.vin[0].scriptSig << vchSig;
+    return tx;
+}
+
+BOOST_FIXTURE_TEST_CASE(CreateNewBlock_packages, TestChain100Setup)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    TestMemPoolEntryHelper entry;
+    std::list<CTransaction> removed;
+    CBlockTemplate *pblocktemplate;
+
+    // Mature the first three coinbases
+    std::vector<CMutableTransaction> noTxns;
+    for (int i = 0; i < 2; i++)
+        CreateAndProcessBlock(noTxns, scriptPubKey);
+
+    LOCK(cs_main);
+    CBlockTemplateStats stats = GetBlockTemplateStats();
+    BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, scriptPubKey));
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 1);
+    delete pblocktemplate;
+    BOOST_CHECK_EQUAL(GetBlockTemplateStats().nBuilds, stats.nBuilds + 1);
+
+    // A parent paying little goes in ahead of a better paying transaction
+    // for the sake of its child
+    CMutableTransaction txParent = SpendCoinbase(coinbaseTxns[0], coinbaseKey, 1000);
+    CMutableTransaction txChild;
+    txChild.vin.resize(1);
+    txChild.vin[0].prevout = COutPoint(txParent.GetHash(), 0);
+    txChild.vout.resize(1);
+    txChild.vout[0].nValue = txParent.vout[0].nValue - 200000;
+    txChild.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    CMutableTransaction txMiddle = SpendCoinbase(coinbaseTxns[1], coinbaseKey, 50000);
+    mempool.addUnchecked(txParent.GetHash(), entry.Fee(1000).FromTx(txParent));
+    mempool.addUnchecked(txMiddle.GetHash(), entry.Fee(50000).FromTx(txMiddle));
+    mempool.addUnchecked(txChild.GetHash(), entry.Fee(200000).FromTx(txChild));
+
+    // The template for the same tip is only updated with them
+    BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, scriptPubKey));
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 4);
+    BOOST_CHECK(pblocktemplate->block.vtx[1]->GetHash() == txParent.GetHash());
+    BOOST_CHECK(pblocktemplate->block.vtx[2]->GetHash() == txChild.GetHash());
+    BOOST_CHECK(pblocktemplate->block.vtx[3]->GetHash() == txMiddle.GetHash());
+    BOOST_CHECK_EQUAL(pblocktemplate->vTxFees[0], -251000);
+    delete pblocktemplate;
+    stats = GetBlockTemplateStats();
+    BOOST_CHECK(stats.fLastUpdated);
+
+    CMutableTransaction txLate = SpendCoinbase(coinbaseTxns[2], coinbaseKey, 20000);
+    mempool.addUnchecked(txLate.GetHash(), entry.Fee(20000).FromTx(txLate));
+    BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, scriptPubKey));
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 5);
+    BOOST_CHECK(pblocktemplate->block.vtx[4]->GetHash() == txLate.GetHash());
+    delete pblocktemplate;
+    BOOST_CHECK_EQUAL(GetBlockTemplateStats().nUpdates, stats.nUpdates + 1);
+
+    // Taking a transaction of the template out of the mempool makes the next one built from scratch
+    mempool.remove(txMiddle, removed, true);
+    BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, scriptPubKey));
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 4);
+    BOOST_CHECK(pblocktemplate->block.vtx[1]->GetHash() == txParent.GetHash());
+    BOOST_CHECK(pblocktemplate->block.vtx[2]->GetHash() == txChild.GetHash());
+    BOOST_CHECK(pblocktemplate->block.vtx[3]->GetHash() == txLate.GetHash());
+    delete pblocktemplate;
+    stats = GetBlockTemplateStats();
+    BOOST_CHECK(!stats.fLastUpdated);
+
+    // So does a new tip
+    CreateAndProcessBlock(noTxns, scriptPubKey);
+    BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, scriptPubKey));
+    BOOST_CHECK(pblocktemplate->block.hashPrevBlock == chainActive.Tip()->GetBlockHash());
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 4);
+    delete pblocktemplate;
+    BOOST_CHECK(!GetBlockTemplateStats().fLastUpdated);
+
+    mempool.clear();
+}
+
+BOOST_FIXTURE_TEST_CASE(CreateEmptyBlock_prebuilt, TestChain100Setup)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    TestMemPoolEntryHelper entry;
+
+    std::vector<CMutableTransaction> noTxns;
+    CreateAndProcessBlock(noTxns, scriptPubKey);
+    CMutableTransaction tx = SpendCoinbase(coinbaseTxns[0], coinbaseKey, 10000);
+    mempool.addUnchecked(tx.GetHash(), entry.Fee(10000).FromTx(tx));
+
+    // Only the coinbase, paying out the subsidy
+    CBlockIndex* pindexTip = chainActive.Tip();
+    std::unique_ptr<CBlockTemplate> pblocktemplate(CreateEmptyBlock(chainparams, scriptPubKey));
+    BOOST_REQUIRE(pblocktemplate);
+    BOOST_CHECK(pblocktemplate->block.hashPrevBlock == pindexTip->GetBlockHash());
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 1);
+    BOOST_CHECK_EQUAL(pblocktemplate->vTxFees[0], 0);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx[0]->GetValueOut(),
+                      GetBlockSubsidy(pindexTip->nBits, pindexTip->nHeight, chainparams.GetConsensus()));
+
+    // The full template is built in the background once the tip is announced
+    CBlockTemplatePrebuilder prebuilder(chainparams, scriptPubKey);
+    RegisterValidationInterface(&prebuilder);
+    GetMainSignals().UpdatedBlockTip(pindexTip, NULL, false);
+    for (int i = 0; i < 1000 && !prebuilder.HaveTemplate(pindexTip); i++)
+        MilliSleep(10);
+    UnregisterValidationInterface(&prebuilder);
+    BOOST_CHECK(!prebuilder.IsBuilding(pindexTip));
+    pblocktemplate.reset(prebuilder.TakeTemplate(pindexTip));
+    BOOST_REQUIRE(pblocktemplate);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 2);
+    BOOST_CHECK(pblocktemplate->block.vtx[1]->GetHash() == tx.GetHash());
+    // it is handed over only once
+    BOOST_CHECK(!prebuilder.TakeTemplate(pindexTip));
+
+    mempool.clear();
+}
+
+BOOST_AUTO_TEST_CASE(NonceScanner)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = uint256S("00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+    header.hashMerkleRoot = uint256S("e0028eb9648db56b1ac77cf090b99048a8007e2bb64b68f092c03c7f56a662c7");
+    header.nBits = 0x207fffff;
+
+    // Double SHA-256, each phiCHOX era, and a few phiCHOX selector digits
+    const uint32_t times[] = {1600000000, PHICHOX_START_TIME, 1645400000, 1646118000};
+    for (unsigned int t = 0; t < sizeof(times) / sizeof(times[0]); t++) {
+        for (unsigned char nDigit = 0; nDigit < 16; nDigit += 5) {
+            header.nTime = times[t];
+            *header.hashPrevBlock.begin() = (*header.hashPrevBlock.begin() & 0xf0) | nDigit;
+            header.nNonce = 1000;
+
+            // Without a reachable target every nonce in the range is tried,
+            // and each one hashes exactly like CBlockHeader::ComputeHash()
+            CNonceScanner scanner(header);
+            uint32_t nNonce = header.nNonce;
+            uint256 hash;
+            BOOST_CHECK(!scanner.Scan(nNonce, 8, arith_uint256(), hash));
+            BOOST_CHECK_EQUAL(nNonce, header.nNonce + 8);
+            header.nNonce += 7;
+            BOOST_CHECK(hash == header.ComputeHash());
+
+            // The first nonce meeting an easy target is the one found by brute force
+            arith_uint256 hashTarget = arith_uint256().SetCompact(header.nBits);
+            header.nNonce = 1000;
+            while (UintToArith256(header.ComputeHash()) > hashTarget)
+                header.nNonce++;
+            nNonce = 1000;
+            BOOST_CHECK(scanner.Scan(nNonce, 0x10000, hashTarget, hash));
+            BOOST_CHECK_EQUAL(nNonce, header.nNonce);
+            BOOST_CHECK(hash == header.GetHash());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
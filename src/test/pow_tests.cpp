@@ -7,6 +7,7 @@
 #include "pow.h"
 #include "random.h"
 #include "util.h"
+#include "validation.h"
 #include "test/test_chainox.h"
 
 #include <boost/test/unit_test.hpp>
@@ -190,4 +191,32 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CheckBlockHeadersPoW_test)
+{
+    const Consensus::Params& params = Params(CBaseChainParams::REGTEST).GetConsensus();
+
+    // A chain of valid regtest headers, longer than one header check batch
+    // and not a multiple of it
+    std::vector<CBlockHeader> headers(37);
+    for (size_t i = 0; i < headers.size(); i++) {
+        headers[i].nVersion = 0x20000000;
+        headers[i].hashPrevBlock = i ? headers[i - 1].GetHash() : GetRandHash();
+        headers[i].hashMerkleRoot = GetRandHash();
+        headers[i].nTime = 1646118000 + i * params.nPowTargetSpacing;
+        headers[i].nBits = 0x207fffff;
+        while (!CheckProofOfWork(headers[i].GetHash(), headers[i].nBits, params))
+            headers[i].nNonce++;
+    }
+    BOOST_CHECK(CheckBlockHeadersPoW(headers, params));
+    for (const CBlockHeader& header : headers)
+        BOOST_CHECK(header.GetHash() == header.ComputeHash());
+
+    // One bad header anywhere fails the whole run
+    CBlockHeader& bad = headers[GetRand(headers.size())];
+    while (CheckProofOfWork(bad.GetHash(), bad.nBits, params))
+        bad.nNonce++;
+    BOOST_CHECK(!CheckBlockHeadersPoW(headers, params));
+    BOOST_CHECK(CheckBlockHeadersPoW(std::vector<CBlockHeader>(), params));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+// Copyright (c) 2014-2017 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "consensus/validation.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "utiltime.h"
+#include "validationinterface.h"
+
+#include "test/test_chainox.h"
+
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+
+namespace
+{
+class CNotificationRecorder : public CValidationInterface
+{
+public:
+    boost::mutex mutex;
+    std::vector<uint256> vTxs;
+    //! Transactions in the block they were signalled with
+    std::vector<size_t> vBlockTxs;
+    boost::thread::id idSync;
+    boost::thread::id idChecked;
+    int nChecked;
+
+    CNotificationRecorder() : nChecked(0) {}
+
+protected:
+    void SyncTransaction(const CTransaction& tx, const CBlock* pblock) override
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        vTxs.push_back(tx.GetHash());
+        vBlockTxs.push_back(pblock ? pblock->vtx.size() : 0);
+        idSync = boost::this_thread::get_id();
+    }
+
+    void BlockChecked(const CBlock& block, const CValidationState& state) override
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        nChecked++;
+        idChecked = boost::this_thread::get_id();
+    }
+};
+
+class CRegisteringSubscriber : public CValidationInterface
+{
+public:
+    CNotificationRecorder other;
+
+protected:
+    void SyncTransaction(const CTransaction& tx, const CBlock* pblock) override
+    {
+        // give the signalling thread time to start waiting for the queues
+        MilliSleep(100);
+        RegisterValidationInterfaceAsync(&other, "test-other");
+        UnregisterValidationInterface(&other);
+    }
+};
+
+CMutableTransaction RecorderTestTx()
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(GetRandHash(), 0);
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 1;
+    return tx;
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(validationinterface_queue)
+{
+    CNotificationRecorder recorder;
+    RegisterValidationInterfaceAsync(&recorder, "test");
+
+    std::vector<uint256> vExpected;
+    std::unique_ptr<CBlock> pblock(new CBlock());
+    pblock->hashPrevBlock = GetRandHash();
+    for (int i = 0; i < 3; i++)
+        pblock->vtx.push_back(MakeTransactionRef(RecorderTestTx()));
+    for (int i = 0; i < 3; i++) {
+        GetMainSignals().SyncTransaction(*pblock->vtx[i], pblock.get());
+        vExpected.push_back(pblock->vtx[i]->GetHash());
+    }
+    // What is queued doesn't refer to the signalled block anymore
+    pblock.reset();
+    CMutableTransaction tx = RecorderTestTx();
+    GetMainSignals().SyncTransaction(tx, NULL);
+    vExpected.push_back(tx.GetHash());
+
+    // Answered in place
+    CValidationState state;
+    GetMainSignals().BlockChecked(CBlock(), state);
+    {
+        boost::unique_lock<boost::mutex> lock(recorder.mutex);
+        BOOST_CHECK_EQUAL(recorder.nChecked, 1);
+        BOOST_CHECK(recorder.idChecked == boost::this_thread::get_id());
+    }
+
+    SyncWithValidationInterfaceQueue();
+    {
+        boost::unique_lock<boost::mutex> lock(recorder.mutex);
+        BOOST_CHECK(recorder.vTxs == vExpected);
+        BOOST_REQUIRE_EQUAL(recorder.vBlockTxs.size(), 4U);
+        BOOST_CHECK_EQUAL(recorder.vBlockTxs[0], 3U);
+        BOOST_CHECK_EQUAL(recorder.vBlockTxs[2], 3U);
+        BOOST_CHECK_EQUAL(recorder.vBlockTxs[3], 0U);
+        BOOST_CHECK(recorder.idSync != boost::this_thread::get_id());
+    }
+
+    // Unregistering delivers what is left first
+    for (int i = 0; i < 100; i++) {
+        tx = RecorderTestTx();
+        GetMainSignals().SyncTransaction(tx, NULL);
+        vExpected.push_back(tx.GetHash());
+    }
+    UnregisterValidationInterface(&recorder);
+    BOOST_CHECK(recorder.vTxs == vExpected);
+    GetMainSignals().SyncTransaction(RecorderTestTx(), NULL);
+    BOOST_CHECK_EQUAL(recorder.vTxs.size(), vExpected.size());
+}
+
+BOOST_AUTO_TEST_CASE(validationinterface_queue_register_from_delivery)
+{
+    // Waiting for the queues doesn't keep subscribers from (un)registering
+    // interfaces on their delivery threads
+    CRegisteringSubscriber subscriber;
+    RegisterValidationInterfaceAsync(&subscriber, "test");
+    GetMainSignals().SyncTransaction(RecorderTestTx(), NULL);
+    SyncWithValidationInterfaceQueue();
+    LimitValidationInterfaceQueue();
+    UnregisterValidationInterface(&subscriber);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
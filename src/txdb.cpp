@@ -12,6 +12,7 @@
 #include "ui_interface.h"
 #include "init.h"
 
+#include <set>
 #include <stdint.h>
 
 #include <boost/thread.hpp>
@@ -26,9 +27,11 @@ static const char DB_ADDRESSINDEX = 'a';
 static const char DB_ADDRESSUNSPENTINDEX = 'u';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_SPENTINDEX = 'p';
+static const char DB_ADDRESSSUMMARY = 'A';
 static const char DB_BLOCK_INDEX = 'b';
 
 static const char DB_BEST_BLOCK = 'B';
+static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
@@ -76,10 +79,35 @@ uint256 CCoinsViewDB::GetBestBlock() const {
     return hashBestChain;
 }
 
-bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
+    std::vector<uint256> vhashHeadBlocks;
+    if (!db.Read(DB_HEAD_BLOCKS, vhashHeadBlocks)) {
+        return std::vector<uint256>();
+    }
+    return vhashHeadBlocks;
+}
+
+bool CCoinsViewDB::WriteCoins(CCoinsMap &mapCoins, const uint256 &hashBlock, bool fConsistent) {
     CDBBatch batch(db);
     size_t count = 0;
     size_t changed = 0;
+    size_t nBatchSize = (size_t)GetArg("-dbbatchsize", nDefaultDbBatchSize);
+
+    if (!hashBlock.IsNull()) {
+        uint256 hashOldTip = GetBestBlock();
+        if (hashOldTip.IsNull()) {
+            // Earlier partial writes left the database in transition from
+            // its last consistent state already
+            std::vector<uint256> vhashOldHeads = GetHeadBlocks();
+            if (vhashOldHeads.size() == 2)
+                hashOldTip = vhashOldHeads[1];
+        }
+        // In the first batch, mark the database as being in the middle of a
+        // transition from the old tip to hashBlock.
+        batch.Erase(DB_BEST_BLOCK);
+        batch.Write(DB_HEAD_BLOCKS, std::vector<uint256>{hashBlock, hashOldTip});
+    }
+
     for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
             CoinEntry entry(&it->first);
@@ -92,15 +120,33 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
         count++;
         CCoinsMap::iterator itOld = it++;
         mapCoins.erase(itOld);
+        if (batch.SizeEstimate() > nBatchSize) {
+            LogPrint("coindb", "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
+            if (!db.WriteBatch(batch))
+                return false;
+            batch.Clear();
+        }
     }
-    if (!hashBlock.IsNull())
+
+    // In the last batch, mark the database as consistent with hashBlock again.
+    if (!hashBlock.IsNull() && fConsistent) {
+        batch.Erase(DB_HEAD_BLOCKS);
         batch.Write(DB_BEST_BLOCK, hashBlock);
+    }
 
     bool ret = db.WriteBatch(batch);
-    LogPrint("coindb", "Committed %u changed transaction outputs (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
+    LogPrint("coindb", "Committed %u changed transaction outputs (out of %u) to coin database%s...\n", (unsigned int)changed, (unsigned int)count, fConsistent ? "" : " (partial)");
     return ret;
 }
 
+bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    return WriteCoins(mapCoins, hashBlock, true);
+}
+
+bool CCoinsViewDB::BatchWritePartial(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    return WriteCoins(mapCoins, hashBlock, false);
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
@@ -260,17 +306,152 @@ bool CBlockTreeDB::ReadAddressUnspentIndex(uint160 addressHash, int type,
     return true;
 }
 
+namespace {
+
+/** What one block's address index entries add to (or take from) an address summary */
+struct CAddressSummaryDelta
+{
+    CAmount balance;
+    CAmount received;
+    std::set<uint256> txids;
+    int height;
+
+    CAddressSummaryDelta() : balance(0), received(0), height(0) {}
+};
+
+typedef std::map<std::pair<unsigned int, uint160>, CAddressSummaryDelta> AddressSummaryDeltaMap;
+
+void GetAddressSummaryDeltas(const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect, AddressSummaryDeltaMap& deltas)
+{
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        CAddressSummaryDelta& delta = deltas[std::make_pair(it->first.type, it->first.hashBytes)];
+        delta.balance += it->second;
+        if (it->second > 0)
+            delta.received += it->second;
+        delta.txids.insert(it->first.txhash);
+        delta.height = it->first.blockHeight;
+    }
+}
+
+}
+
 bool CBlockTreeDB::WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
     CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
+    // Only entries not already stored count towards the summaries, so writing
+    // a block's entries again (replay after a crash, reconnects) changes nothing
+    std::vector<std::pair<CAddressIndexKey, CAmount> > vectNew;
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        if (!Exists(make_pair(DB_ADDRESSINDEX, it->first)))
+            vectNew.push_back(*it);
         batch.Write(make_pair(DB_ADDRESSINDEX, it->first), it->second);
+    }
+
+    // Keep the summaries in the same batch, so they can never disagree with the entries
+    AddressSummaryDeltaMap deltas;
+    GetAddressSummaryDeltas(vectNew, deltas);
+    for (AddressSummaryDeltaMap::const_iterator it = deltas.begin(); it != deltas.end(); it++) {
+        CAddressSummaryValue summary;
+        if (!ReadAddressSummary(it->first.second, it->first.first, summary))
+            return false;
+        summary.balance += it->second.balance;
+        summary.received += it->second.received;
+        summary.txCount += it->second.txids.size();
+        summary.lastHeight = std::max(summary.lastHeight, it->second.height);
+        batch.Write(make_pair(DB_ADDRESSSUMMARY, CAddressIndexIteratorKey(it->first.first, it->first.second)), summary);
+    }
     return WriteBatch(batch);
 }
 
 bool CBlockTreeDB::EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
     CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
+    // Likewise only entries still stored are taken from the summaries
+    std::vector<std::pair<CAddressIndexKey, CAmount> > vectErased;
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        if (Exists(make_pair(DB_ADDRESSINDEX, it->first)))
+            vectErased.push_back(*it);
         batch.Erase(make_pair(DB_ADDRESSINDEX, it->first));
+    }
+
+    AddressSummaryDeltaMap deltas;
+    GetAddressSummaryDeltas(vectErased, deltas);
+    for (AddressSummaryDeltaMap::const_iterator it = deltas.begin(); it != deltas.end(); it++) {
+        CAddressIndexIteratorKey key(it->first.first, it->first.second);
+        CAddressSummaryValue summary;
+        if (!ReadAddressSummary(key.hashBytes, key.type, summary))
+            return false;
+        summary.balance -= it->second.balance;
+        summary.received -= it->second.received;
+        summary.txCount -= it->second.txids.size();
+        if (summary.txCount <= 0) {
+            batch.Erase(make_pair(DB_ADDRESSSUMMARY, key));
+            continue;
+        }
+
+        // The new last height is that of the entry just before the erased
+        // block's ones; keys sort by address, then by height
+        summary.lastHeight = 0;
+        boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(key.type, key.hashBytes, it->second.height)));
+        if (pcursor->Valid())
+            pcursor->Prev();
+        else
+            pcursor->SeekToLast();
+        std::pair<char,CAddressIndexKey> prevKey;
+        if (pcursor->Valid() && pcursor->GetKey(prevKey) && prevKey.first == DB_ADDRESSINDEX &&
+            prevKey.second.type == key.type && prevKey.second.hashBytes == key.hashBytes) {
+            summary.lastHeight = prevKey.second.blockHeight;
+        }
+        batch.Write(make_pair(DB_ADDRESSSUMMARY, key), summary);
+    }
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadAddressSummary(uint160 addressHash, int type, CAddressSummaryValue &summary) {
+    summary.SetNull();
+    if (!Exists(make_pair(DB_ADDRESSSUMMARY, CAddressIndexIteratorKey(type, addressHash))))
+        return true;
+    return Read(make_pair(DB_ADDRESSSUMMARY, CAddressIndexIteratorKey(type, addressHash)), summary);
+}
+
+bool CBlockTreeDB::BuildAddressSummaryIndex() {
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey()));
+
+    // Entries sort by address, then height and position in the block, so
+    // each address and each of its transactions is one contiguous run
+    CDBBatch batch(*this);
+    CAddressIndexKey last;
+    CAddressSummaryValue summary;
+    size_t nAddresses = 0;
+    while (true) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressIndexKey> key;
+        bool fValid = pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX;
+        if (!summary.IsNull() && (!fValid || key.second.type != last.type || key.second.hashBytes != last.hashBytes)) {
+            batch.Write(make_pair(DB_ADDRESSSUMMARY, CAddressIndexIteratorKey(last.type, last.hashBytes)), summary);
+            summary.SetNull();
+            if (++nAddresses % 10000 == 0) {
+                if (!WriteBatch(batch))
+                    return false;
+                batch.Clear();
+            }
+        }
+        if (!fValid)
+            break;
+
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address index value");
+        summary.balance += nValue;
+        if (nValue > 0)
+            summary.received += nValue;
+        if (summary.IsNull() || key.second.blockHeight != last.blockHeight || key.second.txindex != last.txindex)
+            summary.txCount++;
+        summary.lastHeight = key.second.blockHeight;
+        last = key.second;
+        pcursor->Next();
+    }
+    LogPrintf("%s: summarized %u addresses\n", __func__, nAddresses);
     return WriteBatch(batch);
 }
 
@@ -308,6 +489,82 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type,
     return true;
 }
 
+/**
+ * Read the address index entries of start's address from start on, up to
+ * height end if end > 0. After nLimit entries the page is closed at the next
+ * transaction boundary, and next is set to the first entry of the following
+ * page. Memory use is bounded by nLimit rather than by the address' history.
+ */
+bool CBlockTreeDB::ReadAddressIndexPage(const CAddressIndexKey &start, int end, size_t nLimit,
+                                        std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                                        CAddressIndexKey &next, bool &fMore) {
+
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(make_pair(DB_ADDRESSINDEX, start));
+
+    fMore = false;
+    size_t nRead = 0;
+    CAddressIndexKey last;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX || key.second.type != start.type ||
+            key.second.hashBytes != start.hashBytes || (end > 0 && key.second.blockHeight > end)) {
+            break;
+        }
+        if (nRead > 0 && nRead >= nLimit &&
+            (key.second.blockHeight != last.blockHeight || key.second.txindex != last.txindex)) {
+            next = key.second;
+            fMore = true;
+            break;
+        }
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address index value");
+        addressIndex.push_back(make_pair(key.second, nValue));
+        last = key.second;
+        nRead++;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+/** Like ReadAddressIndexPage, for the unspent outputs of start's address */
+bool CBlockTreeDB::ReadAddressUnspentIndexPage(const CAddressUnspentKey &start, size_t nLimit,
+                                               std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs,
+                                               CAddressUnspentKey &next, bool &fMore) {
+
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(make_pair(DB_ADDRESSUNSPENTINDEX, start));
+
+    fMore = false;
+    size_t nRead = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressUnspentKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUNSPENTINDEX || key.second.type != start.type ||
+            key.second.hashBytes != start.hashBytes) {
+            break;
+        }
+        if (nRead >= nLimit) {
+            next = key.second;
+            fMore = true;
+            break;
+        }
+        CAddressUnspentValue nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address unspent value");
+        unspentOutputs.push_back(make_pair(key.second, nValue));
+        nRead++;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
 bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
     CDBBatch batch(*this);
     batch.Write(make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
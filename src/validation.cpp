@@ -8,9 +8,12 @@
 
 #include "alert.h"
 #include "arith_uint256.h"
+#include "blockfilereader.h"
+#include "blockimport.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "checkqueue.h"
+#include "coinsprefetch.h"
 #include "consensus/consensus.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
@@ -81,6 +84,7 @@ unsigned int nBytesPerSigOp = DEFAULT_BYTES_PER_SIGOP;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
+bool fIncrementalFlush = DEFAULT_INCREMENTAL_FLUSH;
 uint64_t nPruneTarget = 0;
 bool fAlerts = DEFAULT_ALERTS;
 bool fEnableReplacement = DEFAULT_ENABLE_REPLACEMENT;
@@ -185,7 +189,9 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 }
 
 CCoinsViewDB *pcoinsdbview = NULL;
+CCoinsViewPrefetch *pcoinsprefetch = NULL;
 CCoinsViewCache *pcoinsTip = NULL;
+CCoinsFlushStats coinsFlushStats;
 CBlockTreeDB *pblocktree = NULL;
 
 enum FlushStateMode {
@@ -551,11 +557,12 @@ std::string FormatStateMessage(const CValidationState &state)
         state.GetRejectCode());
 }
 
-bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState &state, const CTransaction &tx, bool fLimitFree,
+bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState &state, const CTransactionRef &ptx, bool fLimitFree,
                               bool* pfMissingInputs, bool fOverrideMempoolLimit, bool fRejectAbsurdFee,
                               std::vector<COutPoint>& coins_to_uncache, bool fDryRun)
 {
     AssertLockHeld(cs_main);
+    const CTransaction& tx = *ptx;
     if (pfMissingInputs)
         *pfMissingInputs = false;
 
@@ -742,7 +749,7 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState &state, const C
             }
         }
 
-        CTxMemPoolEntry entry(tx, nFees, GetTime(), dPriority, chainActive.Height(), pool.HasNoInputsOf(tx), inChainInputValue, fSpendsCoinbase, nSigOps, lp);
+        CTxMemPoolEntry entry(ptx, nFees, GetTime(), dPriority, chainActive.Height(), pool.HasNoInputsOf(tx), inChainInputValue, fSpendsCoinbase, nSigOps, lp);
         unsigned int nSize = entry.GetTxSize();
 
         // Check that the transaction doesn't have an excessive number of
@@ -1016,13 +1023,13 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState &state, const C
     return true;
 }
 
-bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransaction &tx, bool fLimitFree,
+bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
                         bool* pfMissingInputs, bool fOverrideMempoolLimit, bool fRejectAbsurdFee, bool fDryRun)
 {
     std::vector<COutPoint> coins_to_uncache;
     bool res = AcceptToMemoryPoolWorker(pool, state, tx, fLimitFree, pfMissingInputs, fOverrideMempoolLimit, fRejectAbsurdFee, coins_to_uncache, fDryRun);
     if (!res || fDryRun) {
-        if(!res) LogPrint("mempool", "%s: %s %s\n", __func__, tx.GetHash().ToString(), state.GetRejectReason());
+        if(!res) LogPrint("mempool", "%s: %s %s\n", __func__, tx->GetHash().ToString(), state.GetRejectReason());
         BOOST_FOREACH(const COutPoint& hashTx, coins_to_uncache)
             pcoinsTip->Uncache(hashTx);
     }
@@ -1032,6 +1039,12 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
     return res;
 }
 
+bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransaction &tx, bool fLimitFree,
+                        bool* pfMissingInputs, bool fOverrideMempoolLimit, bool fRejectAbsurdFee, bool fDryRun)
+{
+    return AcceptToMemoryPool(pool, state, MakeTransactionRef(tx), fLimitFree, pfMissingInputs, fOverrideMempoolLimit, fRejectAbsurdFee, fDryRun);
+}
+
 bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &hashes)
 {
     if (!fTimestampIndex)
@@ -1069,6 +1082,43 @@ bool GetAddressIndex(uint160 addressHash, int type,
     return true;
 }
 
+bool GetAddressIndexPage(const CAddressIndexKey &start, int end, size_t nLimit,
+                         std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                         CAddressIndexKey &next, bool &fMore)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pblocktree->ReadAddressIndexPage(start, end, nLimit, addressIndex, next, fMore))
+        return error("unable to get txids for address");
+
+    return true;
+}
+
+bool GetAddressUnspentPage(const CAddressUnspentKey &start, size_t nLimit,
+                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs,
+                           CAddressUnspentKey &next, bool &fMore)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pblocktree->ReadAddressUnspentIndexPage(start, nLimit, unspentOutputs, next, fMore))
+        return error("unable to get txids for address");
+
+    return true;
+}
+
+bool GetAddressSummary(uint160 addressHash, int type, CAddressSummaryValue &summary)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pblocktree->ReadAddressSummary(addressHash, type, summary))
+        return error("unable to get summary for address");
+
+    return true;
+}
+
 bool GetAddressUnspent(uint160 addressHash, int type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs)
 {
@@ -1081,29 +1131,86 @@ bool GetAddressUnspent(uint160 addressHash, int type,
     return true;
 }
 
+/** Transactions read through the txindex start with this much of the rest of their block */
+static const unsigned int TXINDEX_READ_SIZE = 16 * 1024;
+
+/** Size of the block stored at pos, from the start and size WriteBlockToDisk put in front of it */
+static bool ReadBlockSize(const CBlockFileHandle& file, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart, unsigned int& nSizeRet)
+{
+    if (pos.nPos < 8)
+        return error("%s: Invalid block position %s", __func__, pos.ToString());
+
+    unsigned char header[8];
+    if (!file.Read((char*)header, sizeof(header), pos.nPos - 8))
+        return error("%s: Read failed at %s", __func__, pos.ToString());
+    if (memcmp(header, messageStart, MESSAGE_START_SIZE) != 0)
+        return error("%s: Block magic mismatch at %s", __func__, pos.ToString());
+    nSizeRet = ReadLE32(header + MESSAGE_START_SIZE);
+    if (nSizeRet > MaxBlockSize(true))
+        return error("%s: Block size %u too large at %s", __func__, nSizeRet, pos.ToString());
+    return true;
+}
+
 /** Return transaction in tx, and if it was found inside a block, its hash is placed in hashBlock */
 bool GetTransaction(const uint256 &hash, CTransaction &txOut, const Consensus::Params& consensusParams, uint256 &hashBlock, bool fAllowSlow)
 {
     CBlockIndex *pindexSlow = NULL;
 
-    LOCK(cs_main);
-
     if (mempool.lookup(hash, txOut))
     {
         return true;
     }
 
     if (fTxIndex) {
+        // the index and the block files are read without cs_main
         CDiskTxPos postx;
         if (pblocktree->ReadTxIndex(hash, postx)) {
-            CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-            if (file.IsNull())
+            std::shared_ptr<const CBlock> pblock = blockFileReader.GetBlock(postx);
+            if (pblock) {
+                BOOST_FOREACH(const CTransactionRef& ptx, pblock->vtx) {
+                    if (ptx->GetHash() == hash) {
+                        txOut = *ptx;
+                        hashBlock = pblock->GetHash();
+                        return true;
+                    }
+                }
+                return error("%s: txid not in block", __func__);
+            }
+
+            std::shared_ptr<const CBlockFileHandle> file = blockFileReader.GetFile(postx);
+            if (!file)
                 return error("%s: OpenBlockFile failed", __func__);
+            unsigned int nBlockSize;
+            if (!ReadBlockSize(*file, postx, Params().MessageStart(), nBlockSize))
+                return false;
+            unsigned int nTxPos = ::GetSerializeSize(CBlockHeader(), SER_DISK, CLIENT_VERSION) + postx.nTxOffset;
+            if (nTxPos >= nBlockSize)
+                return error("%s: Invalid transaction offset", __func__);
+
             CBlockHeader header;
+            CDataStream ss(SER_DISK, CLIENT_VERSION);
             try {
-                file >> header;
-                fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
-                file >> txOut;
+                ss.resize(nTxPos - postx.nTxOffset);
+                if (!file->Read(&ss[0], ss.size(), postx.nPos))
+                    return error("%s: Read failed", __func__);
+                ss >> header;
+
+                // most transactions are small, read the rest of the block only when needed
+                unsigned int nReadSize = std::min(nBlockSize - nTxPos, TXINDEX_READ_SIZE);
+                while (true) {
+                    ss.clear();
+                    ss.resize(nReadSize);
+                    if (!file->Read(&ss[0], nReadSize, postx.nPos + nTxPos))
+                        return error("%s: Read failed", __func__);
+                    try {
+                        ss >> txOut;
+                        break;
+                    } catch (const std::ios_base::failure& e) {
+                        if (nReadSize == nBlockSize - nTxPos)
+                            throw;
+                        nReadSize = nBlockSize - nTxPos;
+                    }
+                }
             } catch (const std::exception& e) {
                 return error("%s: Deserialize or I/O error - %s", __func__, e.what());
             }
@@ -1118,6 +1225,7 @@ bool GetTransaction(const uint256 &hash, CTransaction &txOut, const Consensus::P
     }
 
     if (fAllowSlow) { // use coin database to locate block that contains transaction, and scan it
+        LOCK(cs_main);
         const Coin& coin = AccessByTxid(*pcoinsTip, hash);
         if (!coin.IsSpent()) pindexSlow = chainActive[coin.nHeight];
     }
@@ -1125,7 +1233,8 @@ bool GetTransaction(const uint256 &hash, CTransaction &txOut, const Consensus::P
     if (pindexSlow) {
         CBlock block;
         if (ReadBlockFromDisk(block, pindexSlow, consensusParams)) {
-            BOOST_FOREACH(const CTransaction &tx, block.vtx) {
+            BOOST_FOREACH(const CTransactionRef& ptx, block.vtx) {
+                const CTransaction& tx = *ptx;
                 if (tx.GetHash() == hash) {
                     txOut = tx;
                     hashBlock = pindexSlow->GetBlockHash();
@@ -1173,23 +1282,39 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
+    // Blocks that were read before have passed the checks below already
+    std::shared_ptr<const CBlock> pblock = blockFileReader.GetBlock(pos);
+    if (pblock) {
+        block = *pblock;
+        return true;
+    }
+
+    std::shared_ptr<const CBlockFileHandle> file = blockFileReader.GetFile(pos);
+    if (!file)
         return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
 
-    // Read block
+    // Read the whole block at once and decode it from memory
+    unsigned int nSize;
+    if (!ReadBlockSize(*file, pos, Params().MessageStart(), nSize))
+        return false;
+    std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
     try {
-        filein >> block;
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss.resize(nSize);
+        if (nSize > 0 && !file->Read(&ss[0], nSize, pos.nPos))
+            return error("%s: Read failed at %s", __func__, pos.ToString());
+        ss >> *pblockNew;
     }
     catch (const std::exception& e) {
         return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
     }
 
     // Check the header
-    if (!CheckProofOfWork(block.GetHash(), block.nBits, consensusParams))
+    if (!CheckProofOfWork(pblockNew->GetHash(), pblockNew->nBits, consensusParams))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
 
+    blockFileReader.AddBlock(pos, pblockNew);
+    block = *pblockNew;
     return true;
 }
 
@@ -1203,6 +1328,22 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    std::shared_ptr<const CBlockFileHandle> file = blockFileReader.GetFile(pos);
+    if (!file)
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    unsigned int nSize;
+    if (!ReadBlockSize(*file, pos, messageStart, nSize))
+        return false;
+    block.resize(nSize);
+    if (nSize > 0 && !file->Read((char*)block.data(), nSize, pos.nPos))
+        return error("%s: Read failed at %s", __func__, pos.ToString());
+
+    return true;
+}
+
 double ConvertBitsToDouble(unsigned int nBits)
 {
     int nShift = (nBits >> 24) & 0xff;
@@ -1644,14 +1785,19 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
             return DISCONNECT_FAILED; // adding output for transaction without known metadata
         }
     }
-    view.AddCoin(out, std::move(undo), undo.fCoinBase);
+    // The potential_overwrite parameter to AddCoin is only allowed to be false if we know for
+    // sure that the coin did not already exist in the cache. As we have queried for that above
+    // using HaveCoin, we don't need to guess. When fClean is false, a coin already existed and
+    // it is an overwrite.
+    view.AddCoin(out, std::move(undo), !fClean);
 
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
- *  When UNCLEAN or FAILED is returned, view is left in an indeterminate state. */
-static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& state, const CBlockIndex* pindex, CCoinsViewCache& view)
+ *  When UNCLEAN or FAILED is returned, view is left in an indeterminate state.
+ *  fUpdateIndexes is false for disconnects into a scratch view, which must leave the address index alone. */
+static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& state, const CBlockIndex* pindex, CCoinsViewCache& view, bool fUpdateIndexes = true)
 {
     assert(pindex->GetBlockHash() == view.GetBestBlock());
 
@@ -1679,7 +1825,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
 
     // undo transactions in reverse order
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
-        const CTransaction &tx = block.vtx[i];
+        const CTransaction &tx = *block.vtx[i];
         uint256 hash = tx.GetHash();
         bool is_coinbase = tx.IsCoinBase();
 
@@ -1784,7 +1930,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
-    if (fAddressIndex) {
+    if (fAddressIndex && fUpdateIndexes) {
         if (!pblocktree->EraseAddressIndex(addressIndex)) {
             AbortNode(state, "Failed to delete address index");
             return DISCONNECT_FAILED;
@@ -1798,6 +1944,101 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
+/** Apply the effects of a block on the utxo cache, ignoring that it may already have been applied. */
+static bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs, const CChainParams& params)
+{
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex, params.GetConsensus())) {
+        return error("ReplayBlock(): ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
+    }
+
+    BOOST_FOREACH(const CTransactionRef& tx, block.vtx) {
+        if (!tx->IsCoinBase()) {
+            BOOST_FOREACH(const CTxIn &txin, tx->vin) {
+                inputs.SpendCoin(txin.prevout);
+            }
+        }
+        // Every addition may be an overwrite.
+        const uint256& txid = tx->GetHash();
+        for (size_t i = 0; i < tx->vout.size(); ++i)
+            inputs.AddCoin(COutPoint(txid, i), Coin(tx->vout[i], pindex->nHeight, tx->IsCoinBase()), true);
+    }
+    return true;
+}
+
+/**
+ * Bring a coins database that was written partially, by a crash during a
+ * flush or while incremental flushing was ahead of its consistent state,
+ * to the state of the newest block whose coins it may hold.
+ */
+bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
+{
+    LOCK(cs_main);
+
+    CCoinsViewCache cache(view);
+
+    std::vector<uint256> hashHeads = view->GetHeadBlocks();
+    if (hashHeads.empty()) return true; // We're already in a consistent state.
+    if (hashHeads.size() != 2) return error("ReplayBlocks(): unknown inconsistent state");
+
+    uiInterface.ShowProgress(_("Replaying blocks..."), 0);
+    LogPrintf("Replaying blocks\n");
+
+    CBlockIndex* pindexOld = NULL;  // Last consistent state of the coins database.
+    CBlockIndex* pindexNew;         // Newest block whose coins may have been written.
+    CBlockIndex* pindexFork = NULL; // Latest block common to both.
+
+    if (mapBlockIndex.count(hashHeads[0]) == 0) {
+        return error("ReplayBlocks(): reorganization to unknown block requested");
+    }
+    pindexNew = mapBlockIndex[hashHeads[0]];
+
+    if (!hashHeads[1].IsNull()) { // The old tip is allowed to be 0, indicating it's the first flush.
+        if (mapBlockIndex.count(hashHeads[1]) == 0) {
+            return error("ReplayBlocks(): reorganization from unknown block requested");
+        }
+        pindexOld = mapBlockIndex[hashHeads[1]];
+        pindexFork = LastCommonAncestor(pindexOld, pindexNew);
+        assert(pindexFork != NULL);
+    }
+
+    // Rollback along the old branch.
+    while (pindexOld != pindexFork) {
+        if (pindexOld->nHeight > 0) { // Never disconnect the genesis block.
+            CBlock block;
+            if (!ReadBlockFromDisk(block, pindexOld, params.GetConsensus())) {
+                return error("RollbackBlock(): ReadBlockFromDisk() failed at %d, hash=%s", pindexOld->nHeight, pindexOld->GetBlockHash().ToString());
+            }
+            LogPrintf("Rolling back %s (%i)\n", pindexOld->GetBlockHash().ToString(), pindexOld->nHeight);
+            CValidationState state;
+            cache.SetBestBlock(pindexOld->GetBlockHash());
+            DisconnectResult res = DisconnectBlock(block, state, pindexOld, cache);
+            if (res == DISCONNECT_FAILED) {
+                return error("RollbackBlock(): DisconnectBlock failed at %d, hash=%s", pindexOld->nHeight, pindexOld->GetBlockHash().ToString());
+            }
+            // If DISCONNECT_UNCLEAN is returned, it means a non-existing UTXO was deleted, or an existing UTXO was
+            // overwritten. It corresponds to cases where the block-to-be-disconnect never had all its operations
+            // applied to the UTXO set. However, as both writing a UTXO and deleting a UTXO are idempotent operations,
+            // the result is still a version of the UTXO set with the effects of that block undone.
+        }
+        pindexOld = pindexOld->pprev;
+    }
+
+    // Roll forward from the forking point to the new tip.
+    int nForkHeight = pindexFork ? pindexFork->nHeight : 0;
+    for (int nHeight = nForkHeight + 1; nHeight <= pindexNew->nHeight; ++nHeight) {
+        const CBlockIndex* pindex = pindexNew->GetAncestor(nHeight);
+        LogPrintf("Rolling forward %s (%i)\n", pindex->GetBlockHash().ToString(), nHeight);
+        if (!RollforwardBlock(pindex, cache, params)) return false;
+    }
+
+    cache.SetBestBlock(pindexNew->GetBlockHash());
+    if (!cache.Flush())
+        return error("ReplayBlocks(): failed to write to coin database");
+    uiInterface.ShowProgress("", 100);
+    return true;
+}
+
 void static FlushBlockFile(bool fFinalize = false)
 {
     LOCK(cs_LastBlockFile);
@@ -1830,6 +2071,71 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+/**
+ * Closure representing the proof-of-work check of a run of block headers.
+ * Hashing fills the headers' hash caches, so AcceptBlockHeader finds the
+ * hash already computed once it runs under cs_main.
+ */
+class CHeaderCheck
+{
+private:
+    std::vector<CBlockHeader>::const_iterator first;
+    std::vector<CBlockHeader>::const_iterator last;
+    const Consensus::Params* params;
+
+public:
+    CHeaderCheck() : params(NULL) {}
+    CHeaderCheck(std::vector<CBlockHeader>::const_iterator firstIn, std::vector<CBlockHeader>::const_iterator lastIn, const Consensus::Params& paramsIn) :
+        first(firstIn), last(lastIn), params(&paramsIn) {}
+
+    bool operator()()
+    {
+        CBlockHeader::PrecomputeHashes(first, last);
+        for (std::vector<CBlockHeader>::const_iterator it = first; it != last; ++it)
+            if (!CheckProofOfWork(it->GetHash(), it->nBits, *params))
+                return false;
+        return true;
+    }
+
+    void swap(CHeaderCheck& check)
+    {
+        std::swap(first, check.first);
+        std::swap(last, check.last);
+        std::swap(params, check.params);
+    }
+};
+
+/** Headers per CHeaderCheck; a multiple of the phiCHOX batch kernels' lane count */
+static const unsigned int HEADER_CHECK_BATCH_SIZE = 16;
+
+static CCheckQueue<CHeaderCheck> headercheckqueue(8);
+/** Serializes masters of headercheckqueue, which supports one at a time */
+static CCriticalSection cs_headercheckqueue;
+
+void ThreadHeaderCheck() {
+    RenameThread("chainox-headerch");
+    headercheckqueue.Thread();
+}
+
+bool CheckBlockHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams)
+{
+    int64_t nTimeStart = GetTimeMicros();
+
+    LOCK(cs_headercheckqueue);
+    CCheckQueueControl<CHeaderCheck> control(&headercheckqueue);
+    std::vector<CHeaderCheck> vChecks;
+    vChecks.reserve((headers.size() + HEADER_CHECK_BATCH_SIZE - 1) / HEADER_CHECK_BATCH_SIZE);
+    for (size_t i = 0; i < headers.size(); i += HEADER_CHECK_BATCH_SIZE) {
+        std::vector<CBlockHeader>::const_iterator first = headers.begin() + i;
+        vChecks.push_back(CHeaderCheck(first, first + std::min<size_t>(HEADER_CHECK_BATCH_SIZE, headers.size() - i), consensusParams));
+    }
+    control.Add(vChecks);
+    bool fOk = control.Wait();
+
+    LogPrint("bench", "    - Check %u headers: %.2fms\n", headers.size(), 0.001 * (GetTimeMicros() - nTimeStart));
+    return fOk;
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -1995,7 +2301,8 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     fEnforceBIP30 = fEnforceBIP30 && (!pindexBIP34height || !(pindexBIP34height->GetBlockHash() == chainparams.GetConsensus().BIP34Hash));
 
     if (fEnforceBIP30) {
-        BOOST_FOREACH(const CTransaction& tx, block.vtx) {
+        BOOST_FOREACH(const CTransactionRef& ptx, block.vtx) {
+            const CTransaction& tx = *ptx;
             for (size_t o = 0; o < tx.vout.size(); o++) {
                 if (view.HaveCoin(COutPoint(tx.GetHash(), o))) {
                     return state.DoS(100, error("ConnectBlock(): tried to overwrite transaction"),
@@ -2053,7 +2360,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
-        const CTransaction &tx = block.vtx[i];
+        const CTransaction &tx = *block.vtx[i];
         const uint256 txhash = tx.GetHash();
 
         nInputs += tx.vin.size();
@@ -2194,7 +2501,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 //        return state.DoS(0, error("ConnectBlock(CHOX): %s", strError), REJECT_INVALID, "bad-cb-amount");
 //    }
 
-    if (!IsBlockPayeeValid(block.vtx[0], pindex->nHeight, blockReward)) {
+    if (!IsBlockPayeeValid(*block.vtx[0], pindex->nHeight, blockReward)) {
         mapRejectedBlocks.insert(make_pair(block.GetHash(), GetTime()));
         return state.DoS(0, error("ConnectBlock(CHOX): couldn't find masternode or superblock payments"),
                                 REJECT_INVALID, "bad-cb-payee");
@@ -2259,7 +2566,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     // Watch for changes to the previous coinbase transaction.
     static uint256 hashPrevBestCoinBase;
     GetMainSignals().UpdatedTransaction(hashPrevBestCoinBase);
-    hashPrevBestCoinBase = block.vtx[0].GetHash();
+    hashPrevBestCoinBase = block.vtx[0]->GetHash();
 
     int64_t nTime6 = GetTimeMicros(); nTimeCallbacks += nTime6 - nTime5;
     LogPrint("bench", "    - Callbacks: %.2fms [%.2fs]\n", 0.001 * (nTime6 - nTime5), nTimeCallbacks * 0.000001);
@@ -2306,7 +2613,8 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
         nLastSetChain = nNow;
     }
     int64_t nMempoolSizeMax = GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
-    int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() * DB_PEAK_USAGE_FACTOR;
+    // Chunked writes don't build a second copy of the cache for the database batch
+    int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() * (fIncrementalFlush ? 1 : DB_PEAK_USAGE_FACTOR);
     int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
     // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
     bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
@@ -2318,8 +2626,29 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
     bool fPeriodicFlush = mode == FLUSH_STATE_PERIODIC && nNow > nLastFlush + (int64_t)DATABASE_FLUSH_INTERVAL * 1000000;
     // Combine all conditions that result in a full cache flush.
     bool fDoFullFlush = (mode == FLUSH_STATE_ALWAYS) || fCacheLarge || fCacheCritical || fPeriodicFlush || fFlushForPrune;
-    // Write blocks and block index to disk.
-    if (fDoFullFlush || fPeriodicWrite) {
+    // Write a chunk of the modified coins in between.
+    bool fDoChunk = false;
+    if (fIncrementalFlush) {
+        // A large cache is trimmed by evicting unmodified coins, not by writing and dropping all of it.
+        if (fCacheLarge || fCacheCritical) {
+            int64_t nEvictStart = GetTimeMicros();
+            coinsFlushStats.nEvicted += pcoinsTip->Evict(nCoinCacheUsage * 9 / 10);
+            coinsFlushStats.nEvictMicros += GetTimeMicros() - nEvictStart;
+        }
+        // Mostly modified coins left, they have to be written before they can go as well.
+        bool fStillCritical = (fCacheLarge || fCacheCritical) && pcoinsTip->DynamicMemoryUsage() > (size_t)nCoinCacheUsage;
+        fDoFullFlush = (mode == FLUSH_STATE_ALWAYS) || fStillCritical || fPeriodicFlush || fPeriodicWrite || fFlushForPrune;
+        // Write a chunk once a chunk's worth of coins is modified, or once in a
+        // while however few there are. Chunks sync the block index too, so
+        // they are at least COINS_CHUNK_MIN_INTERVAL apart.
+        size_t nModified = pcoinsTip->GetSyncQueueSize();
+        fDoChunk = !fDoFullFlush && (mode == FLUSH_STATE_IF_NEEDED || mode == FLUSH_STATE_PERIODIC) && nModified > 0 &&
+                   nNow > nLastWrite + (int64_t)COINS_CHUNK_MIN_INTERVAL * 1000000 &&
+                   (nModified >= COINS_SYNC_CHUNK_SIZE || nNow > nLastWrite + (int64_t)COINS_CHUNK_MAX_INTERVAL * 1000000);
+    }
+    // Write blocks and block index to disk. A chunk of coins needs them as
+    // well, to replay the blocks up to the tip it was written at after a crash.
+    if (fDoFullFlush || fPeriodicWrite || fDoChunk) {
         // Depend on nMinDiskSpace to ensure we can write block index
         if (!CheckDiskSpace(0))
             return state.Error("out of disk space");
@@ -2343,9 +2672,6 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
                 return AbortNode(state, "Files to write to block index database");
             }
         }
-        // Finally remove any pruned files
-        if (fFlushForPrune)
-            UnlinkPrunedFiles(setFilesToPrune);
         nLastWrite = nNow;
     }
     // Flush best chain related state. This can only be done if the blocks / block index write was also done.
@@ -2358,10 +2684,36 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode) {
         if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
             return state.Error("out of disk space");
         // Flush the chainstate (which may refer to block index entries).
-        if (!pcoinsTip->Flush())
+        int64_t nFlushStart = GetTimeMicros();
+        if (fIncrementalFlush ? !pcoinsTip->Sync(COINS_SYNC_CHUNK_SIZE) : !pcoinsTip->Flush())
             return AbortNode(state, "Failed to write to coin database");
+        int64_t nFlushTime = GetTimeMicros() - nFlushStart;
+        coinsFlushStats.nFlushes++;
+        coinsFlushStats.nFlushMicros += nFlushTime;
+        coinsFlushStats.nLastFlushMicros = nFlushTime;
+        LogPrint("coindb", "Wrote coins cache (%s) in %.2fms\n", fIncrementalFlush ? "sync" : "flush", nFlushTime * 0.001);
         nLastFlush = nNow;
-    }
+        if (fIncrementalFlush && (fCacheLarge || fCacheCritical)) {
+            int64_t nEvictStart = GetTimeMicros();
+            coinsFlushStats.nEvicted += pcoinsTip->Evict(nCoinCacheUsage * 9 / 10);
+            coinsFlushStats.nEvictMicros += GetTimeMicros() - nEvictStart;
+        }
+    } else if (fDoChunk) {
+        // Write modified coins a chunk at a time between blocks, so that they
+        // can be evicted and the next sync has little left to do. The coins
+        // database is ahead of its consistent state until a chunk leaves no
+        // modified coins behind, or until that sync.
+        int64_t nChunkStart = GetTimeMicros();
+        if (!pcoinsTip->SyncChunk(COINS_SYNC_CHUNK_SIZE))
+            return AbortNode(state, "Failed to write to coin database");
+        int64_t nChunkTime = GetTimeMicros() - nChunkStart;
+        coinsFlushStats.nChunks++;
+        coinsFlushStats.nChunkMicros += nChunkTime;
+        coinsFlushStats.nLastChunkMicros = nChunkTime;
+    }
+    // Remove pruned files once the coins no longer need their blocks for a replay
+    if (fFlushForPrune)
+        UnlinkPrunedFiles(setFilesToPrune);
     if (fDoFullFlush || ((mode == FLUSH_STATE_ALWAYS || mode == FLUSH_STATE_PERIODIC) && nNow > nLastSetChain + (int64_t)DATABASE_WRITE_INTERVAL * 1000000)) {
         // Update best block in wallet (so we can detect restored wallets).
         GetMainSignals().SetBestChain(chainActive.GetLocator());
@@ -2446,6 +2798,11 @@ bool static DisconnectTip(CValidationState& state, const Consensus::Params& cons
 {
     CBlockIndex *pindexDelete = chainActive.Tip();
     assert(pindexDelete);
+    // Coins written in chunks may be ahead of the last consistent state of
+    // the coins database. Replaying after a crash only goes forward from
+    // there, so make it consistent before going backwards.
+    if (!pcoinsdbview->GetHeadBlocks().empty() && !FlushStateToDisk(state, FLUSH_STATE_ALWAYS))
+        return false;
     // Read block from disk.
     CBlock block;
     if (!ReadBlockFromDisk(block, pindexDelete, consensusParams))
@@ -2464,11 +2821,12 @@ bool static DisconnectTip(CValidationState& state, const Consensus::Params& cons
         return false;
     // Resurrect mempool transactions from the disconnected block.
     std::vector<uint256> vHashUpdate;
-    BOOST_FOREACH(const CTransaction &tx, block.vtx) {
+    BOOST_FOREACH(const CTransactionRef& ptx, block.vtx) {
+        const CTransaction& tx = *ptx;
         // ignore validation errors in resurrected transactions
         list<CTransaction> removed;
         CValidationState stateDummy;
-        if (tx.IsCoinBase() || !AcceptToMemoryPool(mempool, stateDummy, tx, false, NULL, true)) {
+        if (tx.IsCoinBase() || !AcceptToMemoryPool(mempool, stateDummy, ptx, false, NULL, true)) {
             mempool.remove(tx, removed, true);
         } else if (mempool.exists(tx.GetHash())) {
             vHashUpdate.push_back(tx.GetHash());
@@ -2484,12 +2842,63 @@ bool static DisconnectTip(CValidationState& state, const Consensus::Params& cons
     UpdateTip(pindexDelete->pprev);
     // Let wallets know transactions went from 1-confirmed to
     // 0-confirmed or conflicted:
-    BOOST_FOREACH(const CTransaction &tx, block.vtx) {
+    BOOST_FOREACH(const CTransactionRef& ptx, block.vtx) {
+        const CTransaction& tx = *ptx;
         GetMainSignals().SyncTransaction(tx, NULL);
     }
     return true;
 }
 
+/** The outpoints a block spends that are not created in the block itself */
+static std::vector<COutPoint> GetBlockInputs(const CBlock& block)
+{
+    std::set<uint256> setBlockTxids;
+    BOOST_FOREACH(const CTransactionRef& tx, block.vtx)
+        setBlockTxids.insert(tx->GetHash());
+    std::vector<COutPoint> vOutpoints;
+    for (size_t i = 1; i < block.vtx.size(); i++) {
+        BOOST_FOREACH(const CTxIn& txin, block.vtx[i]->vin) {
+            if (!setBlockTxids.count(txin.prevout.hash))
+                vOutpoints.push_back(txin.prevout);
+        }
+    }
+    return vOutpoints;
+}
+
+/**
+ * Have the coins a block spends read from the coins database while the block
+ * waits for ConnectBlock, leaving out those pcoinsTip holds already.
+ */
+static void PrefetchBlockInputs(const CBlock& block)
+{
+    AssertLockHeld(cs_main);
+    if (!pcoinsprefetch)
+        return;
+    std::vector<COutPoint> vToFetch;
+    BOOST_FOREACH(const COutPoint& outpoint, GetBlockInputs(block)) {
+        if (!pcoinsTip->HaveCoinInCache(outpoint))
+            vToFetch.push_back(outpoint);
+    }
+    pcoinsprefetch->Prefetch(vToFetch);
+}
+
+/** Same for a block about to be connected, reading it from disk unless pblock is given */
+static void PrefetchBlockInputs(const CBlockIndex* pindex, const CBlock* pblock, const Consensus::Params& consensusParams)
+{
+    AssertLockHeld(cs_main);
+    if (!pcoinsprefetch)
+        return;
+    CBlock block;
+    if (!pblock) {
+        // ConnectTip finds the block in the decoded block cache then, and
+        // reports if it can't be read
+        if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !ReadBlockFromDisk(block, pindex, consensusParams))
+            return;
+        pblock = &block;
+    }
+    PrefetchBlockInputs(*pblock);
+}
+
 static int64_t nTimeReadFromDisk = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
@@ -2517,6 +2926,9 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     LogPrint("bench", "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * 0.001, nTimeReadFromDisk * 0.000001);
     {
         CCoinsViewCache view(pcoinsTip);
+        CCoinsPrefetchStats prefetchStart;
+        if (pcoinsprefetch)
+            prefetchStart = pcoinsprefetch->GetStats();
         bool rv = ConnectBlock(*pblock, state, pindexNew, view);
         GetMainSignals().BlockChecked(*pblock, state);
 /*
@@ -2528,6 +2940,14 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
 */
         nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2;
         LogPrint("bench", "  - Connect total: %.2fms [%.2fs]\n", (nTime3 - nTime2) * 0.001, nTimeConnectTotal * 0.000001);
+        if (pcoinsprefetch) {
+            // Coins read for outpoints the cache held by then are of no use anymore
+            pcoinsprefetch->Discard(GetBlockInputs(*pblock));
+            CCoinsPrefetchStats prefetch = pcoinsprefetch->GetStats();
+            LogPrint("bench", "    - Inputs: %u prefetched (%u waited for), %u read [%u hits, %u misses, %u discarded, %.2fs reading]\n",
+                prefetch.nHits - prefetchStart.nHits, prefetch.nWaits - prefetchStart.nWaits, prefetch.nMisses - prefetchStart.nMisses,
+                prefetch.nHits, prefetch.nMisses, prefetch.nDiscarded, prefetch.nFetchMicros * 0.000001);
+        }
         assert(view.Flush());
     }
     int64_t nTime4 = GetTimeMicros(); nTimeFlush += nTime4 - nTime3;
@@ -2548,7 +2968,8 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
         GetMainSignals().SyncTransaction(tx, NULL);
     }
     // ... and about transactions that got confirmed:
-    BOOST_FOREACH(const CTransaction &tx, pblock->vtx) {
+    BOOST_FOREACH(const CTransactionRef& ptx, pblock->vtx) {
+        const CTransaction& tx = *ptx;
         GetMainSignals().SyncTransaction(tx, pblock);
     }
 
@@ -2577,27 +2998,31 @@ bool DisconnectBlocks(int blocks)
 
 void ReprocessBlocks(int nBlocks)
 {
-    LOCK(cs_main);
+    {
+        LOCK(cs_main);
 
-    std::map<uint256, int64_t>::iterator it = mapRejectedBlocks.begin();
-    while(it != mapRejectedBlocks.end()){
-        //use a window twice as large as is usual for the nBlocks we want to reset
-        if((*it).second  > GetTime() - (nBlocks*60*5)) {
-            BlockMap::iterator mi = mapBlockIndex.find((*it).first);
-            if (mi != mapBlockIndex.end() && (*mi).second) {
+        std::map<uint256, int64_t>::iterator it = mapRejectedBlocks.begin();
+        while(it != mapRejectedBlocks.end()){
+            //use a window twice as large as is usual for the nBlocks we want to reset
+            if((*it).second  > GetTime() - (nBlocks*60*5)) {
+                BlockMap::iterator mi = mapBlockIndex.find((*it).first);
+                if (mi != mapBlockIndex.end() && (*mi).second) {
 
-                CBlockIndex* pindex = (*mi).second;
-                LogPrintf("ReprocessBlocks -- %s\n", (*it).first.ToString());
+                    CBlockIndex* pindex = (*mi).second;
+                    LogPrintf("ReprocessBlocks -- %s\n", (*it).first.ToString());
 
-                CValidationState state;
-                ReconsiderBlock(state, pindex);
+                    CValidationState state;
+                    ReconsiderBlock(state, pindex);
+                }
             }
+            ++it;
         }
-        ++it;
-    }
 
-    DisconnectBlocks(nBlocks);
+        DisconnectBlocks(nBlocks);
+    }
 
+    // Not under cs_main: ActivateBestChain waits for the notification queues
+    // DisconnectBlocks filled, and their subscribers take cs_main themselves.
     CValidationState state;
     ActivateBestChain(state, Params());
 }
@@ -2709,6 +3134,14 @@ static bool ActivateBestChainStep(CValidationState& state, const CChainParams& c
 
         // Connect new blocks.
         BOOST_REVERSE_FOREACH(CBlockIndex *pindexConnect, vpindexToConnect) {
+            // Have the coins spent by this block and the next one read while
+            // this one connects
+            if (pindexConnect == vpindexToConnect.back())
+                PrefetchBlockInputs(pindexConnect, pindexConnect == pindexMostWork ? pblock : NULL, chainparams.GetConsensus());
+            if (pindexConnect != pindexMostWork) {
+                CBlockIndex* pindexNext = pindexMostWork->GetAncestor(pindexConnect->nHeight + 1);
+                PrefetchBlockInputs(pindexNext, pindexNext == pindexMostWork ? pblock : NULL, chainparams.GetConsensus());
+            }
             if (!ConnectTip(state, chainparams, pindexConnect, pindexConnect == pindexMostWork ? pblock : NULL)) {
                 if (state.IsInvalid()) {
                     // The block violates a consensus rule.
@@ -2783,6 +3216,9 @@ bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams,
         if (ShutdownRequested())
             break;
 
+        // Don't let the notifications for subscribers on their own threads pile up
+        LimitValidationInterfaceQueue();
+
         const CBlockIndex *pindexFork;
         bool fInitialDownload;
         {
@@ -2807,6 +3243,9 @@ bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams,
             pindexNewTip = chainActive.Tip();
             pindexFork = chainActive.FindFork(pindexOldTip);
             fInitialDownload = IsInitialBlockDownload();
+
+            // Update global DIP0001 activation status, before the subscribers that may be delivered later hear of the tip
+            fDIP0001ActiveAtTip = (VersionBitsState(pindexNewTip, chainparams.GetConsensus(), Consensus::DEPLOYMENT_DIP0001, versionbitscache) == THRESHOLD_ACTIVE);
         }
         // When we reach this point, we switched to a new tip (stored in pindexNewTip).
 
@@ -3124,11 +3563,11 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
                          REJECT_INVALID, "bad-blk-length");
 
     // First transaction must be coinbase, the rest must not be
-    if (block.vtx.empty() || !block.vtx[0].IsCoinBase())
+    if (block.vtx.empty() || !block.vtx[0]->IsCoinBase())
         return state.DoS(100, error("CheckBlock(): first tx is not coinbase"),
                          REJECT_INVALID, "bad-cb-missing");
     for (unsigned int i = 1; i < block.vtx.size(); i++)
-        if (block.vtx[i].IsCoinBase())
+        if (block.vtx[i]->IsCoinBase())
             return state.DoS(100, error("CheckBlock(): more than one coinbase"),
                              REJECT_INVALID, "bad-cb-multiple");
 
@@ -3139,7 +3578,8 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
         // We should never accept block which conflicts with completed transaction lock,
         // that's why this is in CheckBlock unlike coinbase payee/amount.
         // Require other nodes to comply, send them some data in case they are missing it.
-        BOOST_FOREACH(const CTransaction& tx, block.vtx) {
+        BOOST_FOREACH(const CTransactionRef& ptx, block.vtx) {
+            const CTransaction& tx = *ptx;
             // skip coinbase, it has no inputs
             if (tx.IsCoinBase()) continue;
             // LOOK FOR TRANSACTION LOCK IN OUR MAP OF OUTPOINTS
@@ -3163,16 +3603,16 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
     // END CHOX
 
     // Check transactions
-    BOOST_FOREACH(const CTransaction& tx, block.vtx)
-        if (!CheckTransaction(tx, state))
+    BOOST_FOREACH(const CTransactionRef& tx, block.vtx)
+        if (!CheckTransaction(*tx, state))
             return error("CheckBlock(): CheckTransaction of %s failed with %s",
-                tx.GetHash().ToString(),
+                tx->GetHash().ToString(),
                 FormatStateMessage(state));
 
     unsigned int nSigOps = 0;
-    BOOST_FOREACH(const CTransaction& tx, block.vtx)
+    BOOST_FOREACH(const CTransactionRef& tx, block.vtx)
     {
-        nSigOps += GetLegacySigOpCount(tx);
+        nSigOps += GetLegacySigOpCount(*tx);
     }
     // sigops limits (relaxed)
     if (nSigOps > MaxBlockSigOps(true))
@@ -3268,7 +3708,8 @@ bool ContextualCheckBlock(const CBlock& block, CValidationState& state, CBlockIn
     // Check that all transactions are finalized and not over-sized
     // Also count sigops
     unsigned int nSigOps = 0;
-    BOOST_FOREACH(const CTransaction& tx, block.vtx) {
+    BOOST_FOREACH(const CTransactionRef& ptx, block.vtx) {
+        const CTransaction& tx = *ptx;
         if (!IsFinalTx(tx, nHeight, nLockTimeCutoff)) {
             return state.DoS(10, error("%s: contains a non-final transaction", __func__), REJECT_INVALID, "bad-txns-nonfinal");
         }
@@ -3288,8 +3729,8 @@ bool ContextualCheckBlock(const CBlock& block, CValidationState& state, CBlockIn
     if (block.nVersion >= 2 && IsSuperMajority(2, pindexPrev, consensusParams.nMajorityEnforceBlockUpgrade, consensusParams))
     {
         CScript expect = CScript() << nHeight;
-        if (block.vtx[0].vin[0].scriptSig.size() < expect.size() ||
-            !std::equal(expect.begin(), expect.end(), block.vtx[0].vin[0].scriptSig.begin())) {
+        if (block.vtx[0]->vin[0].scriptSig.size() < expect.size() ||
+            !std::equal(expect.begin(), expect.end(), block.vtx[0]->vin[0].scriptSig.begin())) {
             return state.DoS(100, error("%s: block height mismatch in coinbase", __func__), REJECT_INVALID, "bad-cb-height");
         }
     }
@@ -3435,6 +3876,10 @@ static bool AcceptBlock(const CBlock& block, CValidationState& state, const CCha
     if (fCheckForPruning)
         FlushStateToDisk(state, FLUSH_STATE_NONE); // we just allocated more disk space for block files
 
+    // A block extending the tip is connected next
+    if (pindex->pprev == chainActive.Tip())
+        PrefetchBlockInputs(block);
+
     return true;
 }
 
@@ -3555,6 +4000,7 @@ void UnlinkPrunedFiles(std::set<int>& setFilesToPrune)
 {
     for (set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         CDiskBlockPos pos(*it, 0);
+        blockFileReader.Forget(*it);
         boost::filesystem::remove(GetBlockPosFilename(pos, "blk"));
         boost::filesystem::remove(GetBlockPosFilename(pos, "rev"));
         LogPrintf("Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
@@ -3774,6 +4220,18 @@ bool static LoadBlockIndexDB()
     pblocktree->ReadFlag("addressindex", fAddressIndex);
     LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
 
+    // Address indexes from before the per-address summaries get them built once
+    if (fAddressIndex) {
+        bool fAddressSummary = false;
+        pblocktree->ReadFlag("addresssummary", fAddressSummary);
+        if (!fAddressSummary) {
+            LogPrintf("%s: building address summaries, this may take a while...\n", __func__);
+            if (!pblocktree->BuildAddressSummaryIndex())
+                return error("%s: failed to build address summaries", __func__);
+            pblocktree->WriteFlag("addresssummary", true);
+        }
+    }
+
     // Check whether we have a timestamp index
     pblocktree->ReadFlag("timestampindex", fTimestampIndex);
     LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
@@ -3782,6 +4240,10 @@ bool static LoadBlockIndexDB()
     pblocktree->ReadFlag("spentindex", fSpentIndex);
     LogPrintf("%s: spent index %s\n", __func__, fSpentIndex ? "enabled" : "disabled");
 
+    // Finish what an interrupted flush of the coins database left undone
+    if (!ReplayBlocks(chainparams, pcoinsdbview))
+        return false;
+
     // Load pointer to end of best chain
     BlockMap::iterator it = mapBlockIndex.find(pcoinsTip->GetBestBlock());
     if (it == mapBlockIndex.end())
@@ -3850,7 +4312,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
         }
         // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
         if (nCheckLevel >= 3 && pindex == pindexState && (coins.DynamicMemoryUsage() + pcoinsTip->DynamicMemoryUsage()) <= nCoinCacheUsage) {
-            DisconnectResult res = DisconnectBlock(block, state, pindex, coins);
+            DisconnectResult res = DisconnectBlock(block, state, pindex, coins, false);
             if (res == DISCONNECT_FAILED) {
                 return error("VerifyDB(): *** irrecoverable inconsistency in block data at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
             }
@@ -3915,6 +4377,7 @@ void UnloadBlockIndex()
     }
     mapBlockIndex.clear();
     fHavePruned = false;
+    blockFileReader.Clear();
 }
 
 bool LoadBlockIndex()
@@ -3927,33 +4390,37 @@ bool LoadBlockIndex()
 
 bool InitBlockIndex(const CChainParams& chainparams) 
 {
-    LOCK(cs_main);
+    {
+        LOCK(cs_main);
 
-    // Check whether we're already initialized
-    if (chainActive.Genesis() != NULL)
-        return true;
+        // Check whether we're already initialized
+        if (chainActive.Genesis() != NULL)
+            return true;
+
+        // Use the provided setting for -txindex in the new database
+        fTxIndex = GetBoolArg("-txindex", DEFAULT_TXINDEX);
+        pblocktree->WriteFlag("txindex", fTxIndex);
 
-    // Use the provided setting for -txindex in the new database
-    fTxIndex = GetBoolArg("-txindex", DEFAULT_TXINDEX);
-    pblocktree->WriteFlag("txindex", fTxIndex);
+        // Use the provided setting for -addressindex in the new database
+        fAddressIndex = GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
+        pblocktree->WriteFlag("addressindex", fAddressIndex);
+        pblocktree->WriteFlag("addresssummary", fAddressIndex);
 
-    // Use the provided setting for -addressindex in the new database
-    fAddressIndex = GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
-    pblocktree->WriteFlag("addressindex", fAddressIndex);
+        // Use the provided setting for -timestampindex in the new database
+        fTimestampIndex = GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
+        pblocktree->WriteFlag("timestampindex", fTimestampIndex);
 
-    // Use the provided setting for -timestampindex in the new database
-    fTimestampIndex = GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
-    pblocktree->WriteFlag("timestampindex", fTimestampIndex);
+        fSpentIndex = GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
+        pblocktree->WriteFlag("spentindex", fSpentIndex);
 
-    fSpentIndex = GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
-    pblocktree->WriteFlag("spentindex", fSpentIndex);
+        LogPrintf("Initializing databases...\n");
 
-    LogPrintf("Initializing databases...\n");
+        // Only add the genesis block ichoxt reindexing (in which case we reuse the one already on disk)
+        if (fReindex)
+            return true;
 
-    // Only add the genesis block ichoxt reindexing (in which case we reuse the one already on disk)
-    if (!fReindex) {
         try {
-            CBlock &block = const_cast<CBlock&>(chainparams.GenesisBlock());
+            const CBlock &block = chainparams.GenesisBlock();
             // Start new block file
             unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
             CDiskBlockPos blockPos;
@@ -3965,16 +4432,21 @@ bool InitBlockIndex(const CChainParams& chainparams)
             CBlockIndex *pindex = AddToBlockIndex(block);
             if (!ReceivedBlockTransactions(block, state, pindex, blockPos))
                 return error("%s: genesis block not accepted", __func__);
-            if (!ActivateBestChain(state, chainparams, &block))
-                return error("%s: genesis block cannot be activated", __func__);
-            // Force a chainstate write so that when we VerifyDB in a moment, it doesn't check stale data
-            return FlushStateToDisk(state, FLUSH_STATE_ALWAYS);
         } catch (const std::runtime_error& e) {
             return error("%s: failed to initialize block database: %s", __func__, e.what());
         }
     }
 
-    return true;
+    // ActivateBestChain must not be called with cs_main held
+    try {
+        CValidationState state;
+        if (!ActivateBestChain(state, chainparams, &chainparams.GenesisBlock()))
+            return error("%s: genesis block cannot be activated", __func__);
+        // Force a chainstate write so that when we VerifyDB in a moment, it doesn't check stale data
+        return FlushStateToDisk(state, FLUSH_STATE_ALWAYS);
+    } catch (const std::runtime_error& e) {
+        return error("%s: failed to initialize block database: %s", __func__, e.what());
+    }
 }
 
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
@@ -3984,44 +4456,24 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
     int64_t nStart = GetTimeMillis();
 
     int nLoaded = 0;
+    // Scanning and parsing run ahead on their own threads, blocks are accepted here in file order
+    CBlockImportPipeline pipeline(fileIn, chainparams.MessageStart(), nScriptCheckThreads);
+    unsigned int nAccepted = 0;
+    int64_t nAcceptMicros = 0;
     try {
-        unsigned int nMaxBlockSize = MaxBlockSize(true);
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2*nMaxBlockSize, nMaxBlockSize+8, SER_DISK, CLIENT_VERSION);
-        uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
+        CImportedBlock imported;
+        while (pipeline.Next(imported)) {
             boost::this_thread::interruption_point();
 
-            blkdat.SetPos(nRewind);
-            nRewind++; // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                unsigned char buf[MESSAGE_START_SIZE];
-                blkdat.FindByte(chainparams.MessageStart()[0]);
-                nRewind = blkdat.GetPos()+1;
-                blkdat >> FLATDATA(buf);
-                if (memcmp(buf, chainparams.MessageStart(), MESSAGE_START_SIZE))
-                    continue;
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > nMaxBlockSize)
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
-                break;
-            }
+            // a block that failed to deserialize was logged by the parse stage
+            if (!imported.pblock)
+                continue;
+            int64_t nAcceptStart = GetTimeMicros();
+            nAccepted++;
             try {
-                // read block
-                uint64_t nBlockPos = blkdat.GetPos();
+                const CBlock& block = *imported.pblock;
                 if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                blkdat.SetPos(nBlockPos);
-                CBlock block;
-                blkdat >> block;
-                nRewind = blkdat.GetPos();
+                    dbp->nPos = imported.nPos;
 
                 // detect out of order blocks, and store them for later
                 uint256 hash = block.GetHash();
@@ -4030,6 +4482,7 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                             block.hashPrevBlock.ToString());
                     if (dbp)
                         mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
+                    nAcceptMicros += GetTimeMicros() - nAcceptStart;
                     continue;
                 }
 
@@ -4058,22 +4511,23 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                 // Recursively process earlier encountered successors of this block
                 deque<uint256> queue;
                 queue.push_back(hash);
+                CBlock blockChild;
                 while (!queue.empty()) {
                     uint256 head = queue.front();
                     queue.pop_front();
                     std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
                     while (range.first != range.second) {
                         std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
-                        if (ReadBlockFromDisk(block, it->second, chainparams.GetConsensus()))
+                        if (ReadBlockFromDisk(blockChild, it->second, chainparams.GetConsensus()))
                         {
-                            LogPrint("reindex", "%s: Processing out of order child %s of %s\n", __func__, block.GetHash().ToString(),
+                            LogPrint("reindex", "%s: Processing out of order child %s of %s\n", __func__, blockChild.GetHash().ToString(),
                                     head.ToString());
                             LOCK(cs_main);
                             CValidationState dummy;
-                            if (AcceptBlock(block, dummy, chainparams, NULL, true, &it->second, NULL))
+                            if (AcceptBlock(blockChild, dummy, chainparams, NULL, true, &it->second, NULL))
                             {
                                 nLoaded++;
-                                queue.push_back(block.GetHash());
+                                queue.push_back(blockChild.GetHash());
                             }
                         }
                         range.first++;
@@ -4084,10 +4538,18 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
             } catch (const std::exception& e) {
                 LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
             }
+            nAcceptMicros += GetTimeMicros() - nAcceptStart;
         }
     } catch (const std::runtime_error& e) {
         AbortNode(std::string("System error: ") + e.what());
     }
+
+    CBlockImportStats stats = pipeline.GetStats();
+    LogPrint("bench", "Block import: scan %.2fMB in %.2fms (%.2fMB/s), parse %u blocks (%u failed) in %.2fms on %d threads (%.2f blocks/s per thread), accept %u blocks in %.2fms (%.2f blocks/s), waited %.2fms for parsed blocks\n",
+        stats.nScanBytes * 0.000001, stats.nScanMicros * 0.001, stats.nScanBytes / (double)std::max<int64_t>(stats.nScanMicros, 1),
+        stats.nParsed, stats.nParseFailures, stats.nParseMicros * 0.001, stats.nParseThreads, stats.nParsed * 1000000.0 / std::max<int64_t>(stats.nParseMicros, 1),
+        nAccepted, nAcceptMicros * 0.001, nAccepted * 1000000.0 / std::max<int64_t>(nAcceptMicros, 1),
+        stats.nWaitMicros * 0.001);
     if (nLoaded > 0)
         LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, GetTimeMillis() - nStart);
     return nLoaded > 0;
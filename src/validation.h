@@ -39,6 +39,7 @@ class CBlockTreeDB;
 class CBloomFilter;
 class CChainParams;
 class CCoinsViewDB;
+class CCoinsViewPrefetch;
 class CInv;
 class CConnman;
 class CScriptCheck;
@@ -95,6 +96,14 @@ static const unsigned int BLOCK_DOWNLOAD_WINDOW = 1024;
 static const unsigned int DATABASE_WRITE_INTERVAL = 60 * 60;
 /** Time to wait (in seconds) between flushing chainstate to disk. */
 static const unsigned int DATABASE_FLUSH_INTERVAL = 24 * 60 * 60;
+/** Default for -incrementalflush, writing the coins cache in chunks and keeping it warm instead of emptying it */
+static const bool DEFAULT_INCREMENTAL_FLUSH = true;
+/** Modified coins written to the coins database per chunk of an incremental flush. */
+static const unsigned int COINS_SYNC_CHUNK_SIZE = 20000;
+/** Minimum time in seconds between chunks of an incremental flush, each of which syncs the block index. */
+static const unsigned int COINS_CHUNK_MIN_INTERVAL = 60;
+/** Time in seconds after which a chunk is written however few coins are modified. */
+static const unsigned int COINS_CHUNK_MAX_INTERVAL = 10 * 60;
 /** Maximum length of reject messages. */
 static const unsigned int MAX_REJECT_MESSAGE_LENGTH = 111;
 /** Average delay between local address broadcasts in seconds. */
@@ -154,6 +163,7 @@ extern unsigned int nBytesPerSigOp;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
 extern size_t nCoinCacheUsage;
+extern bool fIncrementalFlush;
 extern CFeeRate minRelayTxFee;
 extern bool fAlerts;
 extern bool fEnableReplacement;
@@ -242,10 +252,20 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
 bool InitBlockIndex(const CChainParams& chainparams);
 /** Load the block tree and coins database from disk */
 bool LoadBlockIndex();
+/** Bring a coins database left in transition by an interrupted or chunked write to the newest block it may hold */
+bool ReplayBlocks(const CChainParams& params, CCoinsView* view);
 /** Unload database information */
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the header checking thread */
+void ThreadHeaderCheck();
+/**
+ * Hash a run of block headers and check their proof of work, spreading the
+ * work over the header checking threads. Does not need cs_main, and leaves
+ * every header's hash cached. Returns false if any header fails the check.
+ */
+bool CheckBlockHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams);
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Format a string that describes several potential problems detected by the core.
@@ -295,6 +315,9 @@ void FlushStateToDisk();
 void PruneAndFlush();
 
 /** (try to) add transaction to memory pool **/
+bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx, bool fLimitFree,
+                        bool* pfMissingInputs, bool fOverrideMempoolLimit=false, bool fRejectAbsurdFee=false, bool fDryRun=false);
+/** Same as above, but copies tx into a new shared reference first */
 bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransaction &tx, bool fLimitFree,
                         bool* pfMissingInputs, bool fOverrideMempoolLimit=false, bool fRejectAbsurdFee=false, bool fDryRun=false);
 
@@ -417,6 +440,13 @@ bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
 bool GetAddressIndex(uint160 addressHash, int type,
                      std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                      int start = 0, int end = 0);
+bool GetAddressIndexPage(const CAddressIndexKey &start, int end, size_t nLimit,
+                         std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                         CAddressIndexKey &next, bool &fMore);
+bool GetAddressUnspentPage(const CAddressUnspentKey &start, size_t nLimit,
+                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs,
+                           CAddressUnspentKey &next, bool &fMore);
+bool GetAddressSummary(uint160 addressHash, int type, CAddressSummaryValue &summary);
 bool GetAddressUnspent(uint160 addressHash, int type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
 
@@ -424,6 +454,8 @@ bool GetAddressUnspent(uint160 addressHash, int type,
 bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/** Read the serialized block at pos without parsing it, for passing on to peers as is */
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -465,9 +497,34 @@ extern CChain chainActive;
 /** Global variable that points to the coins database (protected by cs_main) */
 extern CCoinsViewDB *pcoinsdbview;
 
+/** Global variable that points to the view reading coins from pcoinsdbview ahead of ConnectBlock, NULL if disabled */
+extern CCoinsViewPrefetch *pcoinsprefetch;
+
 /** Global variable that points to the active CCoinsView (protected by cs_main) */
 extern CCoinsViewCache *pcoinsTip;
 
+/** Writes of pcoinsTip to the coins database and evictions from it */
+struct CCoinsFlushStats
+{
+    //! Writes leaving the coins database consistent with the tip
+    uint64_t nFlushes;
+    int64_t nFlushMicros;
+    int64_t nLastFlushMicros;
+    //! Chunks written by incremental flushing
+    uint64_t nChunks;
+    int64_t nChunkMicros;
+    int64_t nLastChunkMicros;
+    //! Unmodified coins dropped under memory pressure
+    uint64_t nEvicted;
+    int64_t nEvictMicros;
+
+    CCoinsFlushStats() : nFlushes(0), nFlushMicros(0), nLastFlushMicros(0), nChunks(0), nChunkMicros(0),
+        nLastChunkMicros(0), nEvicted(0), nEvictMicros(0) {}
+};
+
+/** Protected by cs_main */
+extern CCoinsFlushStats coinsFlushStats;
+
 /** Global variable that points to the active block tree (protected by cs_main) */
 extern CBlockTreeDB *pblocktree;
 
@@ -5,8 +5,249 @@
 
 #include "validationinterface.h"
 
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "util.h"
+#include "validation.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/foreach.hpp>
+#include <boost/thread.hpp>
+
 static CMainSignals g_signals;
 
+/**
+ * Queues the notifications for one subscriber and delivers them in order on a
+ * thread of its own. What they refer to is copied, as the originals may be
+ * gone by the time they are delivered.
+ */
+class CValidationInterfaceQueue : public CValidationInterface
+{
+private:
+    CValidationInterface* pinterface;
+    const std::string strName;
+
+    boost::mutex mutex;
+    boost::condition_variable condWork;
+    //! Signalled when a notification was delivered
+    boost::condition_variable condDelivered;
+    std::deque<std::function<void ()> > queue;
+    //! A notification is being delivered
+    bool fDelivering;
+    bool fStop;
+
+    boost::thread thread;
+
+    CValidationInterfaceQueue(const CValidationInterfaceQueue&);
+    CValidationInterfaceQueue& operator=(const CValidationInterfaceQueue&);
+
+    void ThreadDeliver();
+    void Push(std::function<void ()> func);
+
+protected:
+    void AcceptedBlockHeader(const CBlockIndex *pindexNew) override;
+    void NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload) override;
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+    void SyncTransaction(const CTransaction &tx, const CBlock *pblock) override;
+    void NotifyTransactionLock(const CTransaction &tx) override;
+    void SetBestChain(const CBlockLocator &locator) override;
+    bool UpdatedTransaction(const uint256 &hash) override;
+    void Inventory(const uint256 &hash) override;
+    void ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman) override;
+    void BlockChecked(const CBlock& block, const CValidationState& state) override;
+    void GetScriptForMining(boost::shared_ptr<CReserveScript>& script) override;
+    void ResetRequestCount(const uint256 &hash) override;
+
+public:
+    CValidationInterfaceQueue(CValidationInterface* pinterfaceIn, const std::string& strNameIn);
+    ~CValidationInterfaceQueue();
+
+    /** Deliver what is left, then stop. Nothing is delivered once this returns. */
+    void Stop();
+
+    /** Wait until at most nSize notifications are waiting or being delivered */
+    void WaitForSize(size_t nSize);
+};
+
+// Queues are shared with the threads waiting in LimitValidationInterfaceQueue and
+// SyncWithValidationInterfaceQueue, which don't hold csQueues while they wait
+static boost::mutex csQueues;
+static std::map<CValidationInterface*, std::shared_ptr<CValidationInterfaceQueue> > mapQueues;
+
+// The same transaction or block is usually signalled to all queues in a row, they share one copy
+static boost::mutex csShared;
+static CTransactionRef ptxShared;
+static std::shared_ptr<const CBlock> pblockShared;
+
+static CTransactionRef ShareTransaction(const CTransaction& tx)
+{
+    boost::unique_lock<boost::mutex> lock(csShared);
+    if (!ptxShared || ptxShared->GetHash() != tx.GetHash())
+        ptxShared = MakeTransactionRef(tx);
+    return ptxShared;
+}
+
+static bool SameHeader(const CBlockHeader& a, const CBlockHeader& b)
+{
+    return a.hashMerkleRoot == b.hashMerkleRoot && a.hashPrevBlock == b.hashPrevBlock && a.nTime == b.nTime &&
+           a.nNonce == b.nNonce && a.nBits == b.nBits && a.nVersion == b.nVersion;
+}
+
+static std::shared_ptr<const CBlock> ShareBlock(const CBlock* pblock)
+{
+    if (!pblock)
+        return std::shared_ptr<const CBlock>();
+    boost::unique_lock<boost::mutex> lock(csShared);
+    // the header commits to the transactions
+    if (!pblockShared || !SameHeader(*pblockShared, *pblock))
+        pblockShared = std::make_shared<const CBlock>(*pblock);
+    return pblockShared;
+}
+
+CValidationInterfaceQueue::CValidationInterfaceQueue(CValidationInterface* pinterfaceIn, const std::string& strNameIn) :
+    pinterface(pinterfaceIn), strName(strNameIn), fDelivering(false), fStop(false)
+{
+    thread = boost::thread(boost::bind(&CValidationInterfaceQueue::ThreadDeliver, this));
+}
+
+CValidationInterfaceQueue::~CValidationInterfaceQueue()
+{
+    Stop();
+}
+
+void CValidationInterfaceQueue::Stop()
+{
+    boost::this_thread::disable_interruption di;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStop = true;
+    }
+    condWork.notify_all();
+    if (thread.joinable())
+        thread.join();
+}
+
+void CValidationInterfaceQueue::ThreadDeliver()
+{
+    RenameThread(("chainox-" + strName).c_str());
+
+    while (true) {
+        std::function<void ()> func;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && queue.empty())
+                condWork.wait(lock);
+            // only stop once everything was delivered
+            if (queue.empty())
+                return;
+            func = std::move(queue.front());
+            queue.pop_front();
+            fDelivering = true;
+        }
+
+        try {
+            func();
+        } catch (const std::exception& e) {
+            PrintExceptionContinue(&e, strName.c_str());
+        } catch (...) {
+            PrintExceptionContinue(NULL, strName.c_str());
+        }
+
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            fDelivering = false;
+        }
+        condDelivered.notify_all();
+    }
+}
+
+void CValidationInterfaceQueue::Push(std::function<void ()> func)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        // signalled while being unregistered, there is nobody left to deliver it
+        if (fStop)
+            return;
+        queue.push_back(std::move(func));
+    }
+    condWork.notify_one();
+}
+
+void CValidationInterfaceQueue::WaitForSize(size_t nSize)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    while (queue.size() + (fDelivering ? 1 : 0) > nSize)
+        condDelivered.wait(lock);
+}
+
+void CValidationInterfaceQueue::AcceptedBlockHeader(const CBlockIndex *pindexNew)
+{
+    Push([this, pindexNew] { pinterface->AcceptedBlockHeader(pindexNew); });
+}
+
+void CValidationInterfaceQueue::NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload)
+{
+    Push([this, pindexNew, fInitialDownload] { pinterface->NotifyHeaderTip(pindexNew, fInitialDownload); });
+}
+
+void CValidationInterfaceQueue::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    Push([this, pindexNew, pindexFork, fInitialDownload] { pinterface->UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+}
+
+void CValidationInterfaceQueue::SyncTransaction(const CTransaction &tx, const CBlock *pblock)
+{
+    CTransactionRef ptx = ShareTransaction(tx);
+    std::shared_ptr<const CBlock> pblockCopy = ShareBlock(pblock);
+    Push([this, ptx, pblockCopy] { pinterface->SyncTransaction(*ptx, pblockCopy.get()); });
+}
+
+void CValidationInterfaceQueue::NotifyTransactionLock(const CTransaction &tx)
+{
+    CTransactionRef ptx = ShareTransaction(tx);
+    Push([this, ptx] { pinterface->NotifyTransactionLock(*ptx); });
+}
+
+void CValidationInterfaceQueue::SetBestChain(const CBlockLocator &locator)
+{
+    Push([this, locator] { pinterface->SetBestChain(locator); });
+}
+
+bool CValidationInterfaceQueue::UpdatedTransaction(const uint256 &hash)
+{
+    return pinterface->UpdatedTransaction(hash);
+}
+
+void CValidationInterfaceQueue::Inventory(const uint256 &hash)
+{
+    Push([this, hash] { pinterface->Inventory(hash); });
+}
+
+void CValidationInterfaceQueue::ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman)
+{
+    Push([this, nBestBlockTime, connman] { pinterface->ResendWalletTransactions(nBestBlockTime, connman); });
+}
+
+void CValidationInterfaceQueue::BlockChecked(const CBlock& block, const CValidationState& state)
+{
+    pinterface->BlockChecked(block, state);
+}
+
+void CValidationInterfaceQueue::GetScriptForMining(boost::shared_ptr<CReserveScript>& script)
+{
+    pinterface->GetScriptForMining(script);
+}
+
+void CValidationInterfaceQueue::ResetRequestCount(const uint256 &hash)
+{
+    Push([this, hash] { pinterface->ResetRequestCount(hash); });
+}
+
 CMainSignals& GetMainSignals()
 {
     return g_signals;
@@ -27,7 +268,32 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.BlockFound.connect(boost::bind(&CValidationInterface::ResetRequestCount, pwalletIn, _1));
 }
 
+void RegisterValidationInterfaceAsync(CValidationInterface* pwalletIn, const std::string& strName) {
+    std::shared_ptr<CValidationInterfaceQueue> pqueue = std::make_shared<CValidationInterfaceQueue>(pwalletIn, strName);
+    {
+        boost::unique_lock<boost::mutex> lock(csQueues);
+        mapQueues[pwalletIn] = pqueue;
+    }
+    RegisterValidationInterface(pqueue.get());
+}
+
 void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
+    std::shared_ptr<CValidationInterfaceQueue> pqueue;
+    {
+        boost::unique_lock<boost::mutex> lock(csQueues);
+        std::map<CValidationInterface*, std::shared_ptr<CValidationInterfaceQueue> >::iterator it = mapQueues.find(pwalletIn);
+        if (it != mapQueues.end()) {
+            pqueue = it->second;
+            mapQueues.erase(it);
+        }
+    }
+    if (pqueue) {
+        UnregisterValidationInterface(pqueue.get());
+        // a waiter may still hold the queue, it must not deliver anything to pwalletIn from here on
+        pqueue->Stop();
+        return;
+    }
+
     g_signals.BlockFound.disconnect(boost::bind(&CValidationInterface::ResetRequestCount, pwalletIn, _1));
     g_signals.ScriptForMining.disconnect(boost::bind(&CValidationInterface::GetScriptForMining, pwalletIn, _1));
     g_signals.BlockChecked.disconnect(boost::bind(&CValidationInterface::BlockChecked, pwalletIn, _1, _2));
@@ -55,4 +321,38 @@ void UnregisterAllValidationInterfaces() {
     g_signals.UpdatedBlockTip.disconnect_all_slots();
     g_signals.NotifyHeaderTip.disconnect_all_slots();
     g_signals.AcceptedBlockHeader.disconnect_all_slots();
+
+    std::map<CValidationInterface*, std::shared_ptr<CValidationInterfaceQueue> > mapQueuesOld;
+    {
+        boost::unique_lock<boost::mutex> lock(csQueues);
+        mapQueuesOld.swap(mapQueues);
+    }
+    for (std::map<CValidationInterface*, std::shared_ptr<CValidationInterfaceQueue> >::iterator it = mapQueuesOld.begin(); it != mapQueuesOld.end(); ++it)
+        it->second->Stop();
+}
+
+/**
+ * Wait until each queue holds at most nSize notifications. csQueues is only held
+ * to take the queues, so subscribers may (un)register from their delivery threads.
+ */
+static void WaitForQueues(size_t nSize) {
+    std::vector<std::shared_ptr<CValidationInterfaceQueue> > vQueues;
+    {
+        boost::unique_lock<boost::mutex> lock(csQueues);
+        vQueues.reserve(mapQueues.size());
+        for (std::map<CValidationInterface*, std::shared_ptr<CValidationInterfaceQueue> >::iterator it = mapQueues.begin(); it != mapQueues.end(); ++it)
+            vQueues.push_back(it->second);
+    }
+    BOOST_FOREACH(const std::shared_ptr<CValidationInterfaceQueue>& pqueue, vQueues)
+        pqueue->WaitForSize(nSize);
+}
+
+void LimitValidationInterfaceQueue() {
+    AssertLockNotHeld(cs_main);
+    WaitForQueues(MAX_VALIDATION_QUEUE_SIZE);
+}
+
+void SyncWithValidationInterfaceQueue() {
+    AssertLockNotHeld(cs_main);
+    WaitForQueues(0);
 }
@@ -6,6 +6,10 @@
 #ifndef BITCOIN_VALIDATIONINTERFACE_H
 #define BITCOIN_VALIDATIONINTERFACE_H
 
+#include <stddef.h>
+
+#include <string>
+
 #include <boost/signals2/signal.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -16,9 +20,15 @@ class CConnman;
 class CReserveScript;
 class CTransaction;
 class CValidationInterface;
+class CValidationInterfaceQueue;
 class CValidationState;
 class uint256;
 
+/** -asyncnotifications default, deliver notifications to the subscribers that allow it on threads of their own */
+static const bool DEFAULT_ASYNC_NOTIFICATIONS = true;
+/** Notifications waiting for an asynchronous subscriber beyond which LimitValidationInterfaceQueue waits */
+static const size_t MAX_VALIDATION_QUEUE_SIZE = 10000;
+
 // These functions dispatch to one or all registered wallets
 
 /** Register a wallet to receive updates from core */
@@ -27,6 +37,18 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn);
 void UnregisterValidationInterface(CValidationInterface* pwalletIn);
 /** Unregister all wallets from core */
 void UnregisterAllValidationInterfaces();
+/**
+ * Register a subscriber whose notifications are queued and delivered in order
+ * on a thread of its own, so that validation doesn't wait for it. Those that
+ * return a result or are answered in place (UpdatedTransaction, BlockChecked,
+ * GetScriptForMining) are still delivered right away. Unregistering delivers
+ * what is left in the queue first.
+ */
+void RegisterValidationInterfaceAsync(CValidationInterface* pwalletIn, const std::string& strName);
+/** Wait until every queue is below MAX_VALIDATION_QUEUE_SIZE. Must not be called with cs_main held. */
+void LimitValidationInterfaceQueue();
+/** Wait until all notifications signalled so far were delivered. Must not be called with cs_main held. */
+void SyncWithValidationInterfaceQueue();
 
 class CValidationInterface {
 protected:
@@ -45,6 +67,7 @@ protected:
     friend void ::RegisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
+    friend class ::CValidationInterfaceQueue;
 };
 
 struct CMainSignals {
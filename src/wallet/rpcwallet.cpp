@@ -2405,6 +2405,11 @@ UniValue getwalletinfo(const UniValue& params, bool fHelp)
             "      }\n"
             "      ,...\n"
             "    ]\n"
+            "  \"scanning\":                  (json object) current scanning details, or false if no scan is in progress\n"
+            "    {\n"
+            "      \"duration\" : xxxx        (numeric) elapsed seconds since scan start\n"
+            "      \"progress\" : x.xxxx,     (numeric) scanning progress percentage [0.0, 1.0]\n"
+            "    }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getwalletinfo", "")
@@ -2449,6 +2454,14 @@ UniValue getwalletinfo(const UniValue& params, bool fHelp)
         }
         obj.push_back(Pair("hdaccounts", accounts));
     }
+    if (pwalletMain->IsScanning()) {
+        UniValue scanning(UniValue::VOBJ);
+        scanning.push_back(Pair("duration", pwalletMain->ScanningDuration() / 1000));
+        scanning.push_back(Pair("progress", pwalletMain->ScanningProgress()));
+        obj.push_back(Pair("scanning", scanning));
+    } else {
+        obj.push_back(Pair("scanning", false));
+    }
     return obj;
 }
 
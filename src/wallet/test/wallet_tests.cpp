@@ -3,6 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "wallet/wallet.h"
+#include "privatesend.h"
+#include "random.h"
+#include "txmempool.h"
+#include "validation.h"
 
 #include <set>
 #include <stdint.h>
@@ -263,6 +267,15 @@ BOOST_AUTO_TEST_CASE(coin_selection_tests)
         BOOST_CHECK_EQUAL(nValueRet, 101 * MIN_CHANGE);
         BOOST_CHECK_EQUAL(setCoinsRet.size(), 2U);
 
+        // an excess too small for a change output beats the smallest bigger coin
+        empty_wallet();
+        add_coin(5*CENT);
+        add_coin(3*CENT + 100);
+        add_coin(1*COIN);
+        BOOST_CHECK( wallet.SelectCoinsMinConf(8 * CENT, 1, 1, vCoins, setCoinsRet, nValueRet));
+        BOOST_CHECK_EQUAL(nValueRet, 8 * CENT + 100);
+        BOOST_CHECK_EQUAL(setCoinsRet.size(), 2U);
+
         // test with many inputs
         for (CAmount amt=1500; amt < COIN; amt*=10) {
              empty_wallet();
@@ -289,8 +302,8 @@ BOOST_AUTO_TEST_CASE(coin_selection_tests)
             for (int i2 = 0; i2 < 100; i2++)
                 add_coin(COIN);
 
-            // picking 50 from 100 coins doesn't depend on the shuffle,
-            // but does depend on randomness in the stochastic approximation code
+            // picking 50 from 100 coins is an exact match, which takes the first
+            // coins of equal value in the order of the shuffle
             BOOST_CHECK(wallet.SelectCoinsMinConf(50 * COIN, 1, 6, vCoins, setCoinsRet , nValueRet));
             BOOST_CHECK(wallet.SelectCoinsMinConf(50 * COIN, 1, 6, vCoins, setCoinsRet2, nValueRet));
             BOOST_CHECK(!equal_sets(setCoinsRet, setCoinsRet2));
@@ -361,4 +374,124 @@ BOOST_AUTO_TEST_CASE(ApproximateBestSubset)
     BOOST_CHECK_EQUAL(setCoinsRet.size(), 101);
 }
 
+BOOST_AUTO_TEST_CASE(wallet_utxo_index)
+{
+    CPrivateSend::InitStandardDenominations();
+
+    CWallet utxoWallet;
+    CKey key;
+    key.MakeNewKey(true);
+    CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+    LOCK2(cs_main, utxoWallet.cs_wallet);
+    BOOST_CHECK(utxoWallet.AddKey(key));
+
+    // One denominated and one plain output, unconfirmed but in the mempool
+    CMutableTransaction txFund;
+    txFund.vin.resize(1);
+    txFund.vin[0].prevout.hash = GetRandHash();
+    txFund.vout.resize(3);
+    txFund.vout[0].nValue = CPrivateSend::GetSmallestDenomination();
+    txFund.vout[0].scriptPubKey = scriptPubKey;
+    txFund.vout[1].nValue = 5 * COIN;
+    txFund.vout[1].scriptPubKey = scriptPubKey;
+    txFund.vout[2].nValue = 7 * COIN;
+    txFund.vout[2].scriptPubKey = CScript() << OP_TRUE;
+    TestMemPoolEntryHelper entry;
+    mempool.addUnchecked(txFund.GetHash(), entry.FromTx(txFund));
+    BOOST_CHECK(utxoWallet.AddToWallet(CWalletTx(&utxoWallet, txFund), true, NULL));
+    utxoWallet.MarkDirty();
+
+    vector<COutput> vAvailable;
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ALL_COINS, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 2U);
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ONLY_DENOMINATED, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 1U);
+    BOOST_CHECK_EQUAL(vAvailable[0].i, 0);
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ONLY_NONDENOMINATED, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 1U);
+    BOOST_CHECK_EQUAL(vAvailable[0].i, 1);
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ONLY_1000, false);
+    BOOST_CHECK(vAvailable.empty());
+    BOOST_CHECK_EQUAL(utxoWallet.GetUnconfirmedBalance(), 5 * COIN + CPrivateSend::GetSmallestDenomination());
+    // Served from the balance cache
+    BOOST_CHECK_EQUAL(utxoWallet.GetUnconfirmedBalance(), 5 * COIN + CPrivateSend::GetSmallestDenomination());
+
+    // Spending the plain output drops it from the index
+    CMutableTransaction txSpend;
+    txSpend.vin.resize(1);
+    txSpend.vin[0].prevout = COutPoint(txFund.GetHash(), 1);
+    txSpend.vout.resize(1);
+    txSpend.vout[0].nValue = 4 * COIN;
+    txSpend.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    BOOST_CHECK(utxoWallet.AddToWallet(CWalletTx(&utxoWallet, txSpend), true, NULL));
+
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ALL_COINS, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 1U);
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ONLY_NONDENOMINATED, false);
+    BOOST_CHECK(vAvailable.empty());
+
+    // Rebuilding from scratch gives the same result and drops cached balances
+    utxoWallet.MarkDirty();
+    utxoWallet.AvailableCoins(vAvailable, false, NULL, false, ALL_COINS, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 1U);
+    BOOST_CHECK_EQUAL(utxoWallet.GetUnconfirmedBalance(), CPrivateSend::GetSmallestDenomination());
+
+    mempool.clear();
+}
+
+BOOST_AUTO_TEST_CASE(wallet_utxo_index_updates)
+{
+    CPrivateSend::InitStandardDenominations();
+
+    CKey key, keyImported;
+    key.MakeNewKey(true);
+    keyImported.MakeNewKey(true);
+
+    LOCK2(cs_main, pwalletMain->cs_wallet);
+    BOOST_CHECK(pwalletMain->AddKey(key));
+
+    // Transactions arriving through SyncTransaction update the index as they
+    // are added, one output paying a key the wallet doesn't have yet
+    CMutableTransaction txFund;
+    txFund.vin.resize(1);
+    txFund.vin[0].prevout.hash = GetRandHash();
+    txFund.vout.resize(2);
+    txFund.vout[0].nValue = 5 * COIN;
+    txFund.vout[0].scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+    txFund.vout[1].nValue = 3 * COIN;
+    txFund.vout[1].scriptPubKey = GetScriptForDestination(keyImported.GetPubKey().GetID());
+    TestMemPoolEntryHelper entry;
+    mempool.addUnchecked(txFund.GetHash(), entry.FromTx(txFund));
+    pwalletMain->SyncTransaction(txFund, NULL);
+
+    vector<COutput> vAvailable;
+    pwalletMain->AvailableCoins(vAvailable, false, NULL, false, ALL_COINS, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 1U);
+    BOOST_CHECK_EQUAL(vAvailable[0].i, 0);
+    BOOST_CHECK_EQUAL(pwalletMain->GetUnconfirmedBalance(), 5 * COIN);
+
+    CMutableTransaction txSpend;
+    txSpend.vin.resize(1);
+    txSpend.vin[0].prevout = COutPoint(txFund.GetHash(), 0);
+    txSpend.vout.resize(1);
+    txSpend.vout[0].nValue = 4 * COIN;
+    txSpend.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    pwalletMain->SyncTransaction(txSpend, NULL);
+
+    pwalletMain->AvailableCoins(vAvailable, false, NULL, false, ALL_COINS, false);
+    BOOST_CHECK(vAvailable.empty());
+
+    // Importing the other key, as importprivkey does without a rescan,
+    // brings in the output of the transaction already in the wallet
+    BOOST_CHECK(pwalletMain->AddKey(keyImported));
+    pwalletMain->MarkDirty();
+    pwalletMain->AvailableCoins(vAvailable, false, NULL, false, ALL_COINS, false);
+    BOOST_CHECK_EQUAL(vAvailable.size(), 1U);
+    BOOST_CHECK_EQUAL(vAvailable[0].i, 1);
+    BOOST_CHECK_EQUAL(pwalletMain->GetUnconfirmedBalance(), 3 * COIN);
+
+    mempool.clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
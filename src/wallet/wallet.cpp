@@ -10,6 +10,7 @@
 #include "checkpoints.h"
 #include "chain.h"
 #include "coincontrol.h"
+#include "init.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
 #include "key.h"
@@ -67,15 +68,6 @@ const uint256 CMerkleTx::ABANDON_HASH(uint256S("00000000000000000000000000000000
  * @{
  */
 
-struct CompareValueOnly
-{
-    bool operator()(const pair<CAmount, pair<const CWalletTx*, unsigned int> >& t1,
-                    const pair<CAmount, pair<const CWalletTx*, unsigned int> >& t2) const
-    {
-        return t1.first < t2.first;
-    }
-};
-
 std::string COutput::ToString() const
 {
     return strprintf("COutput(%s, %d, %d) [%s]", tx->GetHash().ToString(), i, nDepth, FormatMoney(tx->vout[i].nValue));
@@ -702,6 +694,8 @@ void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid)
 {
     mapTxSpends.insert(make_pair(outpoint, wtxid));
     setWalletUTXO.erase(outpoint);
+    for (auto& bucket : mapWalletUTXOByType)
+        bucket.second.erase(outpoint);
 
     pair<TxSpends::iterator, TxSpends::iterator> range;
     range = mapTxSpends.equal_range(outpoint);
@@ -720,6 +714,102 @@ void CWallet::AddToSpends(const uint256& wtxid)
         AddToSpends(txin.prevout, wtxid);
 }
 
+static AvailableCoinsType GetUTXOCoinType(CAmount nValue)
+{
+    if (CPrivateSend::IsDenominatedAmount(nValue))
+        return ONLY_DENOMINATED;
+    if (CPrivateSend::IsCollateralAmount(nValue))
+        return ONLY_PRIVATESEND_COLLATERAL;
+    if (nValue == 1000*COIN)
+        return ONLY_1000;
+    return ONLY_NONDENOMINATED;
+}
+
+void CWallet::UpdateWalletUTXO(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+
+    std::map<uint256, CWalletTx>::const_iterator it = mapWallet.find(outpoint.hash);
+    if (it != mapWallet.end() && outpoint.n < it->second.vout.size()) {
+        const CTxOut& txout = it->second.vout[outpoint.n];
+        std::set<COutPoint>& setBucket = mapWalletUTXOByType[GetUTXOCoinType(txout.nValue)];
+        if (IsMine(txout) != ISMINE_NO && !IsSpent(outpoint.hash, outpoint.n)) {
+            setWalletUTXO.insert(outpoint);
+            setBucket.insert(outpoint);
+        } else {
+            setWalletUTXO.erase(outpoint);
+            setBucket.erase(outpoint);
+        }
+        return;
+    }
+
+    setWalletUTXO.erase(outpoint);
+    for (auto& bucket : mapWalletUTXOByType)
+        bucket.second.erase(outpoint);
+}
+
+void CWallet::RebuildWalletUTXO()
+{
+    AssertLockHeld(cs_wallet);
+
+    setWalletUTXO.clear();
+    mapWalletUTXOByType.clear();
+    for (auto& pair : mapWallet) {
+        for (unsigned int i = 0; i < pair.second.vout.size(); i++)
+            UpdateWalletUTXO(COutPoint(pair.first, i));
+    }
+}
+
+const std::set<COutPoint>& CWallet::GetWalletUTXOByType(AvailableCoinsType nCoinType) const
+{
+    AssertLockHeld(cs_wallet);
+
+    static const std::set<COutPoint> setEmpty;
+    std::map<AvailableCoinsType, std::set<COutPoint> >::const_iterator it = mapWalletUTXOByType.find(nCoinType);
+    return it != mapWalletUTXOByType.end() ? it->second : setEmpty;
+}
+
+void CWallet::GetWalletUTXOTxes(const std::set<COutPoint>& setUTXO, std::vector<const CWalletTx*>& vWtxRet) const
+{
+    AssertLockHeld(cs_wallet);
+
+    vWtxRet.clear();
+    // Outputs of one transaction are adjacent in the set
+    for (const COutPoint& outpoint : setUTXO) {
+        if (!vWtxRet.empty() && vWtxRet.back()->GetHash() == outpoint.hash)
+            continue;
+        std::map<uint256, CWalletTx>::const_iterator it = mapWallet.find(outpoint.hash);
+        if (it != mapWallet.end())
+            vWtxRet.push_back(&it->second);
+    }
+}
+
+bool CWallet::GetCachedBalance(BalanceType nType, CAmount& nBalanceRet) const
+{
+    AssertLockHeld(cs_wallet);
+
+    uint256 hashTip = chainActive.Tip() ? chainActive.Tip()->GetBlockHash() : uint256();
+    unsigned int nMempoolUpdated = mempool.GetTransactionsUpdated();
+    if (hashTip != hashBalanceCacheTip || nMempoolUpdated != nBalanceCacheMempoolUpdated) {
+        mapBalanceCache.clear();
+        hashBalanceCacheTip = hashTip;
+        nBalanceCacheMempoolUpdated = nMempoolUpdated;
+        return false;
+    }
+
+    std::map<BalanceType, CAmount>::const_iterator it = mapBalanceCache.find(nType);
+    if (it == mapBalanceCache.end())
+        return false;
+    nBalanceRet = it->second;
+    return true;
+}
+
+void CWallet::SetCachedBalance(BalanceType nType, CAmount nBalance) const
+{
+    AssertLockHeld(cs_wallet);
+    mapBalanceCache[nType] = nBalance;
+}
+
 bool CWallet::EncryptWallet(const SecureString& strWalletPassphrase)
 {
     if (IsCrypted())
@@ -868,9 +958,12 @@ int64_t CWallet::IncOrderPosNext(CWalletDB *pwalletdb)
 void CWallet::MarkDirty()
 {
     {
-        LOCK(cs_wallet);
+        LOCK2(cs_main, cs_wallet);
         BOOST_FOREACH(PAIRTYPE(const uint256, CWalletTx)& item, mapWallet)
             item.second.MarkDirty();
+        // IsMine may have changed for any output
+        RebuildWalletUTXO();
+        mapBalanceCache.clear();
     }
 
     fAnonymizableTallyCached = false;
@@ -956,11 +1049,6 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet, CWalletD
                              wtxIn.hashBlock.ToString());
             }
             AddToSpends(hash);
-            for(int i = 0; i < wtx.vout.size(); ++i) {
-                if (IsMine(wtx.vout[i]) && !IsSpent(hash, i)) {
-                    setWalletUTXO.insert(COutPoint(hash, i));
-                }
-            }
         }
 
         bool fUpdated = false;
@@ -990,6 +1078,15 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet, CWalletD
             }
         }
 
+        // New, newly confirmed or no longer abandoned transactions change which
+        // of their own outputs and of the outputs they spend are unspent
+        for (unsigned int i = 0; i < wtx.vout.size(); i++)
+            UpdateWalletUTXO(COutPoint(hash, i));
+        if (!wtx.IsCoinBase()) {
+            BOOST_FOREACH(const CTxIn& txin, wtx.vin)
+                UpdateWalletUTXO(txin.prevout);
+        }
+
         //// debug print
         LogPrintf("AddToWallet %s  %s%s\n", wtxIn.GetHash().ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""));
 
@@ -1015,6 +1112,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet, CWalletD
 
         fAnonymizableTallyCached = false;
         fAnonymizableTallyCachedNonDenom = false;
+        mapBalanceCache.clear();
 
     }
     return true;
@@ -1114,12 +1212,14 @@ bool CWallet::AbandonTransaction(const uint256& hashTx)
             {
                 if (mapWallet.count(txin.prevout.hash))
                     mapWallet[txin.prevout.hash].MarkDirty();
+                UpdateWalletUTXO(txin.prevout);
             }
         }
     }
 
     fAnonymizableTallyCached = false;
     fAnonymizableTallyCachedNonDenom = false;
+    mapBalanceCache.clear();
 
     return true;
 }
@@ -1178,12 +1278,14 @@ void CWallet::MarkConflicted(const uint256& hashBlock, const uint256& hashTx)
             {
                 if (mapWallet.count(txin.prevout.hash))
                     mapWallet[txin.prevout.hash].MarkDirty();
+                UpdateWalletUTXO(txin.prevout);
             }
         }
     }
 
     fAnonymizableTallyCached = false;
     fAnonymizableTallyCachedNonDenom = false;
+    mapBalanceCache.clear();
 }
 
 void CWallet::SyncTransaction(const CTransaction& tx, const CBlock* pblock)
@@ -1204,6 +1306,7 @@ void CWallet::SyncTransaction(const CTransaction& tx, const CBlock* pblock)
 
     fAnonymizableTallyCached = false;
     fAnonymizableTallyCachedNonDenom = false;
+    mapBalanceCache.clear();
 }
 
 
@@ -1671,18 +1774,210 @@ bool CWalletTx::WriteToDisk(CWalletDB *pwalletdb)
     return pwalletdb->WriteTx(GetHash(), *this);
 }
 
+bool CWallet::IsTxKnownOrSpendsFromMe(const CTransaction& tx) const
+{
+    AssertLockHeld(cs_wallet);
+
+    if (mapWallet.count(tx.GetHash()))
+        return true;
+    BOOST_FOREACH(const CTxIn& txin, tx.vin) {
+        if (mapWallet.count(txin.prevout.hash) || mapTxSpends.count(txin.prevout))
+            return true;
+    }
+    return false;
+}
+
+namespace {
+
+/** Maximum number of threads reading and matching blocks for a rescan */
+static const int MAX_RESCAN_THREADS = 8;
+/** Number of blocks handed to the rescan threads at once */
+static const unsigned int RESCAN_BATCH_SIZE = 32;
+
+/** A block read ahead by the rescan threads */
+struct CRescanBlock
+{
+    const CBlockIndex* pindex;
+    CDiskBlockPos pos;
+    double dProgress;
+    CBlock block;
+    //! Whether each transaction in block pays to one of the wallet's keys or scripts
+    std::vector<bool> vPaysToMe;
+};
+
+/**
+ * Threads reading blocks from disk and matching their outputs against a
+ * wallet's keystore for CWallet::ScanForWalletTransactions, which commits one
+ * batch of blocks while the next one is being read. Neither part needs
+ * cs_main or cs_wallet: block positions are taken under cs_main when a batch
+ * is filled and the keystore has its own lock.
+ */
+class CRescanThreads
+{
+private:
+    const CWallet& wallet;
+    const Consensus::Params& consensusParams;
+
+    boost::mutex mutex;
+    boost::condition_variable condWorker;
+    boost::condition_variable condMaster;
+    std::vector<CRescanBlock>* pvBatch;
+    size_t nNext;
+    size_t nDone;
+    bool fQuit;
+
+    boost::thread_group threadGroup;
+
+    void ReadAndMatch(CRescanBlock& rescanBlock)
+    {
+        CBlock& block = rescanBlock.block;
+        if (!ReadBlockFromDisk(block, rescanBlock.pos, consensusParams) || block.GetHash() != rescanBlock.pindex->GetBlockHash()) {
+            LogPrintf("CWallet::ScanForWalletTransactions -- ERROR: could not read block %s at %s\n",
+                      rescanBlock.pindex->GetBlockHash().ToString(), rescanBlock.pos.ToString());
+            block.SetNull();
+        }
+        rescanBlock.vPaysToMe.resize(block.vtx.size());
+        for (size_t i = 0; i < block.vtx.size(); i++) {
+            rescanBlock.vPaysToMe[i] = wallet.IsMine(*block.vtx[i]);
+        }
+    }
+
+    void Loop()
+    {
+        while (true) {
+            CRescanBlock* pRescanBlock;
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                while (!fQuit && (pvBatch == NULL || nNext == pvBatch->size()))
+                    condWorker.wait(lock);
+                if (fQuit)
+                    return;
+                pRescanBlock = &(*pvBatch)[nNext++];
+            }
+            ReadAndMatch(*pRescanBlock);
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                if (++nDone == pvBatch->size())
+                    condMaster.notify_one();
+            }
+        }
+    }
+
+public:
+    CRescanThreads(const CWallet& walletIn, const Consensus::Params& consensusParamsIn, int nThreads) :
+        wallet(walletIn), consensusParams(consensusParamsIn), pvBatch(NULL), nNext(0), nDone(0), fQuit(false)
+    {
+        for (int i = 0; i < nThreads; i++)
+            threadGroup.create_thread(boost::bind(&CRescanThreads::Loop, this));
+    }
+
+    ~CRescanThreads()
+    {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            fQuit = true;
+        }
+        condWorker.notify_all();
+        threadGroup.join_all();
+    }
+
+    /** Start reading and matching vBatch, which must stay alive until Wait() or destruction */
+    void Start(std::vector<CRescanBlock>& vBatch)
+    {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            pvBatch = vBatch.empty() ? NULL : &vBatch;
+            nNext = 0;
+            nDone = 0;
+        }
+        condWorker.notify_all();
+    }
+
+    /** Wait until the batch passed to Start() is complete */
+    void Wait()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while (pvBatch != NULL && nDone < pvBatch->size())
+            condMaster.wait(lock);
+        pvBatch = NULL;
+    }
+};
+
+/**
+ * Fill vBatch with the active chain blocks following pindexLast (or starting
+ * at pindexStart if nothing was queued yet). If pindexLast was reorganized
+ * away, continue from the fork point instead.
+ */
+static void GetRescanBatch(std::vector<CRescanBlock>& vBatch, CBlockIndex*& pindexLast, CBlockIndex* pindexStart)
+{
+    const CChainParams& chainParams = Params();
+
+    LOCK(cs_main);
+    vBatch.clear();
+
+    CBlockIndex* pindex = pindexStart;
+    if (pindexLast != NULL) {
+        pindex = chainActive.Contains(pindexLast) ? chainActive.Next(pindexLast) : chainActive.Next(chainActive.FindFork(pindexLast));
+    }
+    while (pindex && vBatch.size() < RESCAN_BATCH_SIZE) {
+        vBatch.push_back(CRescanBlock());
+        CRescanBlock& rescanBlock = vBatch.back();
+        rescanBlock.pindex = pindex;
+        rescanBlock.pos = pindex->GetBlockPos();
+        rescanBlock.dProgress = Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), pindex, false);
+        pindexLast = pindex;
+        pindex = chainActive.Next(pindex);
+    }
+}
+
+/** Clears a wallet's scanning flag when ScanForWalletTransactions returns or throws */
+class CScanningWalletGuard
+{
+private:
+    std::atomic<bool>& fScanning;
+
+public:
+    explicit CScanningWalletGuard(std::atomic<bool>& fScanningIn) : fScanning(fScanningIn) {}
+    ~CScanningWalletGuard() { fScanning = false; }
+};
+
+} // anon namespace
+
 /**
  * Scan the block chain (starting in pindexStart) for transactions
  * from or to us. If fUpdate is true, found transactions that already
  * exist in the wallet will be updated.
+ *
+ * Blocks are read and matched against the wallet's keys on separate threads,
+ * locks are only taken to add transactions to the wallet. A rescan can be
+ * stopped with AbortRescan() and only one can run at a time.
+ *
+ * Returns the number of transactions added or updated, or -1 without
+ * scanning anything if another rescan is already in progress.
+ *
+ * If ppindexScanned is not NULL, it is set to the block up to which the chain
+ * was scanned: the tip, or the block before the one an aborted rescan stopped
+ * at. It is NULL if nothing could be scanned.
  */
-int CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate)
+int CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate, const CBlockIndex** ppindexScanned)
 {
+    if (ppindexScanned)
+        *ppindexScanned = NULL;
+    if (fScanningWallet.exchange(true)) {
+        LogPrintf("CWallet::%s -- ERROR: another rescan is already in progress\n", __func__);
+        return -1;
+    }
+    CScanningWalletGuard scanningGuard(fScanningWallet);
+    fAbortRescan = false;
+    nScanningStartTime = GetTimeMillis();
+    dScanningProgress = 0.0;
+
     int ret = 0;
     int64_t nNow = GetTime();
     const CChainParams& chainParams = Params();
 
     CBlockIndex* pindex = pindexStart;
+    double dProgressStart, dProgressTip;
     {
         LOCK2(cs_main, cs_wallet);
 
@@ -1691,29 +1986,78 @@ int CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate)
         while (pindex && nTimeFirstKey && (pindex->GetBlockTime() < (nTimeFirstKey - 7200)))
             pindex = chainActive.Next(pindex);
 
-        ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
-        double dProgressStart = Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), pindex, false);
-        double dProgressTip = Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), chainActive.Tip(), false);
-        while (pindex)
-        {
-            if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
-                ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), pindex, false) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
+        dProgressStart = Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), pindex, false);
+        dProgressTip = Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), chainActive.Tip(), false);
+    }
 
-            CBlock block;
-            ReadBlockFromDisk(block, pindex, Params().GetConsensus());
-            BOOST_FOREACH(CTransaction& tx, block.vtx)
-            {
-                if (AddToWalletIfInvolvingMe(tx, &block, fUpdate))
-                    ret++;
+    ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
+
+    // declared before the threads so that a batch being read outlives them
+    std::vector<CRescanBlock> vRead, vCommit;
+    CBlockIndex* pindexLast = NULL;
+    CRescanThreads threads(*this, chainParams.GetConsensus(), std::max(1, std::min(GetNumCores(), MAX_RESCAN_THREADS)));
+
+    if (pindex) {
+        GetRescanBatch(vRead, pindexLast, pindex);
+        threads.Start(vRead);
+    }
+    bool fAborted = false;
+    while (!vRead.empty() && !fAborted) {
+        threads.Wait();
+        vCommit.swap(vRead);
+        // read ahead while this batch is committed
+        GetRescanBatch(vRead, pindexLast, pindex);
+        threads.Start(vRead);
+
+        BOOST_FOREACH(const CRescanBlock& rescanBlock, vCommit) {
+            if (fAbortRescan || ShutdownRequested()) {
+                LogPrintf("Rescan aborted at block %d. Progress=%f\n", rescanBlock.pindex->nHeight, rescanBlock.dProgress);
+                if (ppindexScanned)
+                    *ppindexScanned = rescanBlock.pindex->pprev;
+                fAborted = true;
+                break;
+            }
+
+            if (dProgressTip - dProgressStart > 0.0) {
+                dScanningProgress = std::max(0.0, std::min(1.0, (rescanBlock.dProgress - dProgressStart) / (dProgressTip - dProgressStart)));
+                if (rescanBlock.pindex->nHeight % 100 == 0)
+                    ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)(dScanningProgress * 100))));
             }
-            pindex = chainActive.Next(pindex);
             if (GetTime() >= nNow + 60) {
                 nNow = GetTime();
-                LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, Checkpoints::GuessVerificationProgress(chainParams.Checkpoints(), pindex));
+                LogPrintf("Still rescanning. At block %d. Progress=%f\n", rescanBlock.pindex->nHeight, rescanBlock.dProgress);
+            }
+
+            const CBlock& block = rescanBlock.block;
+            bool fInvolvesMe = false;
+            {
+                LOCK(cs_wallet);
+                for (size_t i = 0; i < block.vtx.size() && !fInvolvesMe; i++)
+                    fInvolvesMe = rescanBlock.vPaysToMe[i] || IsTxKnownOrSpendsFromMe(*block.vtx[i]);
+            }
+            if (!fInvolvesMe)
+                continue;
+
+            LOCK2(cs_main, cs_wallet);
+            // the block might have been disconnected while it was read, the fork it is replaced by gets scanned instead
+            if (!chainActive.Contains(rescanBlock.pindex))
+                continue;
+            for (size_t i = 0; i < block.vtx.size(); i++) {
+                // the wallet might have changed since the check above, so look at every transaction again
+                if (!rescanBlock.vPaysToMe[i] && !IsTxKnownOrSpendsFromMe(*block.vtx[i]))
+                    continue;
+                if (AddToWalletIfInvolvingMe(*block.vtx[i], &block, fUpdate))
+                    ret++;
             }
         }
-        ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
     }
+
+    if (!fAborted && ppindexScanned) {
+        LOCK(cs_main);
+        *ppindexScanned = chainActive.Tip();
+    }
+
+    ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
     return ret;
 }
 
@@ -2133,12 +2477,17 @@ CAmount CWallet::GetBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        if (GetCachedBalance(BALANCE_TRUSTED, nTotal))
+            return nTotal;
+
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(setWalletUTXO, vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (pcoin->IsTrusted())
                 nTotal += pcoin->GetAvailableCredit();
         }
+        SetCachedBalance(BALANCE_TRUSTED, nTotal);
     }
 
     return nTotal;
@@ -2174,16 +2523,12 @@ CAmount CWallet::GetAnonymizedBalance() const
 
     LOCK2(cs_main, cs_wallet);
 
-    std::set<uint256> setWalletTxesCounted;
-    for (auto& outpoint : setWalletUTXO) {
-
-        if (setWalletTxesCounted.find(outpoint.hash) != setWalletTxesCounted.end()) continue;
-        setWalletTxesCounted.insert(outpoint.hash);
-
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.find(outpoint.hash); it != mapWallet.end() && it->first == outpoint.hash; ++it) {
-            if (it->second.IsTrusted())
-                nTotal += it->second.GetAnonymizedCredit();
-        }
+    // Only denominated outputs can be anonymized
+    std::vector<const CWalletTx*> vWtx;
+    GetWalletUTXOTxes(GetWalletUTXOByType(ONLY_DENOMINATED), vWtx);
+    BOOST_FOREACH(const CWalletTx* pcoin, vWtx) {
+        if (pcoin->IsTrusted())
+            nTotal += pcoin->GetAnonymizedCredit();
     }
 
     return nTotal;
@@ -2264,12 +2609,17 @@ CAmount CWallet::GetDenominatedBalance(bool unconfirmed) const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
-        {
-            const CWalletTx* pcoin = &(*it).second;
+        BalanceType nType = unconfirmed ? BALANCE_DENOMINATED_UNCONFIRMED : BALANCE_DENOMINATED_CONFIRMED;
+        if (GetCachedBalance(nType, nTotal))
+            return nTotal;
 
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(GetWalletUTXOByType(ONLY_DENOMINATED), vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
+        {
             nTotal += pcoin->GetDenominatedCredit(unconfirmed);
         }
+        SetCachedBalance(nType, nTotal);
     }
 
     return nTotal;
@@ -2280,12 +2630,17 @@ CAmount CWallet::GetUnconfirmedBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        if (GetCachedBalance(BALANCE_UNCONFIRMED, nTotal))
+            return nTotal;
+
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(setWalletUTXO, vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (!pcoin->IsTrusted() && pcoin->GetDepthInMainChain() == 0 && pcoin->InMempool())
                 nTotal += pcoin->GetAvailableCredit();
         }
+        SetCachedBalance(BALANCE_UNCONFIRMED, nTotal);
     }
     return nTotal;
 }
@@ -2295,11 +2650,16 @@ CAmount CWallet::GetImmatureBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        if (GetCachedBalance(BALANCE_IMMATURE, nTotal))
+            return nTotal;
+
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(setWalletUTXO, vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
         {
-            const CWalletTx* pcoin = &(*it).second;
             nTotal += pcoin->GetImmatureCredit();
         }
+        SetCachedBalance(BALANCE_IMMATURE, nTotal);
     }
     return nTotal;
 }
@@ -2309,12 +2669,17 @@ CAmount CWallet::GetWatchOnlyBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        if (GetCachedBalance(BALANCE_WATCHONLY_TRUSTED, nTotal))
+            return nTotal;
+
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(setWalletUTXO, vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (pcoin->IsTrusted())
                 nTotal += pcoin->GetAvailableWatchOnlyCredit();
         }
+        SetCachedBalance(BALANCE_WATCHONLY_TRUSTED, nTotal);
     }
 
     return nTotal;
@@ -2325,12 +2690,17 @@ CAmount CWallet::GetUnconfirmedWatchOnlyBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        if (GetCachedBalance(BALANCE_WATCHONLY_UNCONFIRMED, nTotal))
+            return nTotal;
+
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(setWalletUTXO, vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (!pcoin->IsTrusted() && pcoin->GetDepthInMainChain() == 0 && pcoin->InMempool())
                 nTotal += pcoin->GetAvailableWatchOnlyCredit();
         }
+        SetCachedBalance(BALANCE_WATCHONLY_UNCONFIRMED, nTotal);
     }
     return nTotal;
 }
@@ -2340,11 +2710,16 @@ CAmount CWallet::GetImmatureWatchOnlyBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        if (GetCachedBalance(BALANCE_WATCHONLY_IMMATURE, nTotal))
+            return nTotal;
+
+        std::vector<const CWalletTx*> vWtx;
+        GetWalletUTXOTxes(setWalletUTXO, vWtx);
+        BOOST_FOREACH(const CWalletTx* pcoin, vWtx)
         {
-            const CWalletTx* pcoin = &(*it).second;
             nTotal += pcoin->GetImmatureWatchOnlyCredit();
         }
+        SetCachedBalance(BALANCE_WATCHONLY_IMMATURE, nTotal);
     }
     return nTotal;
 }
@@ -2355,31 +2730,57 @@ void CWallet::AvailableCoins(vector<COutput>& vCoins, bool fOnlyConfirmed, const
 
     {
         LOCK2(cs_main, cs_wallet);
-        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+
+        // Only outputs of the requested type that are still unspent can qualify
+        std::vector<const std::set<COutPoint>*> vUTXOSets;
+        if (nCoinType == ALL_COINS) {
+            vUTXOSets.push_back(&setWalletUTXO);
+        } else {
+            vUTXOSets.push_back(&GetWalletUTXOByType(nCoinType));
+            if (nCoinType == ONLY_NONDENOMINATED)
+                vUTXOSets.push_back(&GetWalletUTXOByType(ONLY_1000));
+        }
+
+        BOOST_FOREACH(const std::set<COutPoint>* pUTXOSet, vUTXOSets)
         {
-            const uint256& wtxid = it->first;
-            const CWalletTx* pcoin = &(*it).second;
+            // Outputs of one transaction are adjacent, check the transaction once for all of them
+            const CWalletTx* pcoin = NULL;
+            bool fSkipTx = true;
+            int nDepth = 0;
+            BOOST_FOREACH(const COutPoint& outpoint, *pUTXOSet)
+            {
+                const uint256& wtxid = outpoint.hash;
+                if (pcoin == NULL || pcoin->GetHash() != wtxid) {
+                    pcoin = GetWalletTx(wtxid);
+                    fSkipTx = true;
+                    if (pcoin == NULL)
+                        continue;
 
-            if (!CheckFinalTx(*pcoin))
-                continue;
+                    if (!CheckFinalTx(*pcoin))
+                        continue;
 
-            if (fOnlyConfirmed && !pcoin->IsTrusted())
-                continue;
+                    if (fOnlyConfirmed && !pcoin->IsTrusted())
+                        continue;
 
-            if (pcoin->IsCoinBase() && pcoin->GetBlocksToMaturity() > 0)
-                continue;
+                    if (pcoin->IsCoinBase() && pcoin->GetBlocksToMaturity() > 0)
+                        continue;
 
-            int nDepth = pcoin->GetDepthInMainChain(false);
-            // do not use IX for inputs that have less then INSTANTSEND_CONFIRMATIONS_REQUIRED blockchain confirmations
-            if (fUseInstantSend && nDepth < INSTANTSEND_CONFIRMATIONS_REQUIRED)
-                continue;
+                    nDepth = pcoin->GetDepthInMainChain(false);
+                    // do not use IX for inputs that have less then INSTANTSEND_CONFIRMATIONS_REQUIRED blockchain confirmations
+                    if (fUseInstantSend && nDepth < INSTANTSEND_CONFIRMATIONS_REQUIRED)
+                        continue;
 
-            // We should not consider coins which aren't at least in our mempool
-            // It's possible for these to be conflicted via ancestors which we may never be able to detect
-            if (nDepth == 0 && !pcoin->InMempool())
-                continue;
+                    // We should not consider coins which aren't at least in our mempool
+                    // It's possible for these to be conflicted via ancestors which we may never be able to detect
+                    if (nDepth == 0 && !pcoin->InMempool())
+                        continue;
+
+                    fSkipTx = false;
+                }
+                if (fSkipTx)
+                    continue;
 
-            for (unsigned int i = 0; i < pcoin->vout.size(); i++) {
+                unsigned int i = outpoint.n;
                 bool found = false;
                 if(nCoinType == ONLY_DENOMINATED) {
                     found = CPrivateSend::IsDenominatedAmount(pcoin->vout[i].nValue);
@@ -2397,9 +2798,9 @@ void CWallet::AvailableCoins(vector<COutput>& vCoins, bool fOnlyConfirmed, const
 
                 isminetype mine = IsMine(pcoin->vout[i]);
                 if (!(IsSpent(wtxid, i)) && mine != ISMINE_NO &&
-                    (!IsLockedCoin((*it).first, i) || nCoinType == ONLY_1000) &&
+                    (!IsLockedCoin(wtxid, i) || nCoinType == ONLY_1000) &&
                     (pcoin->vout[i].nValue > 0 || fIncludeZeroValue) &&
-                    (!coinControl || !coinControl->HasSelected() || coinControl->fAllowOtherInputs || coinControl->IsSelected(COutPoint((*it).first, i))))
+                    (!coinControl || !coinControl->HasSelected() || coinControl->fAllowOtherInputs || coinControl->IsSelected(outpoint)))
                         vCoins.push_back(COutput(pcoin, i, nDepth,
                                                  ((mine & ISMINE_SPENDABLE) != ISMINE_NO) ||
                                                   (coinControl && coinControl->fAllowWatchOnly && (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO),
@@ -2409,7 +2810,7 @@ void CWallet::AvailableCoins(vector<COutput>& vCoins, bool fOnlyConfirmed, const
     }
 }
 
-static void ApproximateBestSubset(vector<pair<CAmount, pair<const CWalletTx*,unsigned int> > >vValue, const CAmount& nTotalLower, const CAmount& nTargetValue,
+static void ApproximateBestSubset(const vector<pair<CAmount, pair<const CWalletTx*,unsigned int> > >& vValue, const CAmount& nTotalLower, const CAmount& nTargetValue,
                                   vector<char>& vfBest, CAmount& nBest, bool fUseInstantSend = false, int iterations = 1000)
 {
     vector<char> vfIncluded;
@@ -2468,23 +2869,112 @@ static void ApproximateBestSubset(vector<pair<CAmount, pair<const CWalletTx*,uns
     }
 }
 
-// move denoms down
-bool less_then_denom (const COutput& out1, const COutput& out2)
+// Upper bound on the search steps of SelectCoinsBnB, keeps large wallets responsive
+static const int BNB_MAX_TRIES = 100000;
+
+/**
+ * Depth-first branch and bound over vValue, sorted by descending value, for the
+ * subset with the least total in [nTargetValue, nTargetValue + nCostOfChange],
+ * i.e. one that doesn't need a change output. Gives up after BNB_MAX_TRIES steps.
+ */
+static bool SelectCoinsBnB(const vector<pair<CAmount, pair<const CWalletTx*,unsigned int> > >& vValue, const CAmount& nTargetValue,
+                           const CAmount& nCostOfChange, vector<char>& vfBest, CAmount& nBest)
+{
+    const size_t nSize = vValue.size();
+    const CAmount nMaxTotal = nTargetValue + nCostOfChange;
+
+    // vRemaining[i] is the total value of vValue[i] and everything after it
+    vector<CAmount> vRemaining(nSize + 1, 0);
+    for (size_t i = nSize; i > 0; i--)
+        vRemaining[i - 1] = vRemaining[i] + vValue[i - 1].first;
+
+    vector<size_t> vIncluded;
+    vIncluded.reserve(nSize);
+    CAmount nTotal = 0;
+    size_t i = 0;
+    bool fFound = false;
+
+    for (int nTries = 0; nTries < BNB_MAX_TRIES; nTries++)
+    {
+        bool fBacktrack = true;
+        if (nTotal > nMaxTotal || nTotal + vRemaining[i] < nTargetValue) {
+            // overshot the window, or what is left can't reach the target
+        } else if (nTotal >= nTargetValue) {
+            if (!fFound || nTotal < nBest) {
+                fFound = true;
+                nBest = nTotal;
+                vfBest.assign(nSize, false);
+                BOOST_FOREACH(size_t j, vIncluded)
+                    vfBest[j] = true;
+                if (nBest == nTargetValue)
+                    break;
+            }
+        } else {
+            fBacktrack = false;
+        }
+
+        if (!fBacktrack) {
+            // nTotal < nTargetValue <= nTotal + vRemaining[i], so i < nSize
+            vIncluded.push_back(i);
+            nTotal += vValue[i].first;
+            i++;
+            continue;
+        }
+
+        // Exclude the most recently included coin and continue with the ones after it
+        if (vIncluded.empty())
+            break;
+        i = vIncluded.back();
+        vIncluded.pop_back();
+        nTotal -= vValue[i].first;
+        // Coins of the same value would only repeat the branch just explored
+        CAmount nExcluded = vValue[i].first;
+        for (i++; i < nSize && vValue[i].first == nExcluded; i++);
+    }
+
+    return fFound;
+}
+
+struct CompareInputCoinValue
 {
-    const CWalletTx *pcoin1 = out1.tx;
-    const CWalletTx *pcoin2 = out2.tx;
+    bool operator()(const CInputCoin& t1, const CInputCoin& t2) const
+    {
+        return t1.nValue > t2.nValue;
+    }
+};
 
-    bool found1 = false;
-    bool found2 = false;
-    BOOST_FOREACH(CAmount d, CPrivateSend::GetStandardDenominations()) // loop through predefined denoms
+void CWallet::BuildCoinCandidates(const vector<COutput>& vCoins, vector<CInputCoin>& vCandidatesRet)
+{
+    vCandidatesRet.clear();
+    vCandidatesRet.reserve(vCoins.size());
+    BOOST_FOREACH(const COutput &output, vCoins)
     {
-        if(pcoin1->vout[out1.i].nValue == d) found1 = true;
-        if(pcoin2->vout[out2.i].nValue == d) found2 = true;
+        if (!output.fSpendable)
+            continue;
+
+        CInputCoin input;
+        input.nValue = output.tx->vout[output.i].nValue;
+        input.coin = make_pair(output.tx, output.i);
+        input.nDepth = output.nDepth;
+        input.fFromMe = output.tx->IsFromMe(ISMINE_ALL);
+        input.fDenominated = CPrivateSend::IsDenominatedAmount(input.nValue);
+        vCandidatesRet.push_back(input);
     }
-    return (!found1 && found2);
+
+    // Shuffle first so that coins of equal value are still picked at random
+    random_shuffle(vCandidatesRet.begin(), vCandidatesRet.end(), GetRandInt);
+    stable_sort(vCandidatesRet.begin(), vCandidatesRet.end(), CompareInputCoinValue());
+}
+
+bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, const vector<COutput>& vCoins,
+                                 set<pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, bool fUseInstantSend) const
+{
+    vector<CInputCoin> vCandidates;
+    BuildCoinCandidates(vCoins, vCandidates);
+    return SelectCoinsMinConf(nTargetValue, nConfMine, nConfTheirs, vCandidates, setCoinsRet, nValueRet, fUseInstantSend);
 }
 
-bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, vector<COutput> vCoins,
+bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, const vector<CInputCoin>& vCandidates,
                                  set<pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, bool fUseInstantSend) const
 {
     setCoinsRet.clear();
@@ -2497,35 +2987,24 @@ bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int
                                         : std::numeric_limits<CAmount>::max();
     coinLowestLarger.second.first = NULL;
     vector<pair<CAmount, pair<const CWalletTx*,unsigned int> > > vValue;
+    vValue.reserve(vCandidates.size());
     CAmount nTotalLower = 0;
 
-    random_shuffle(vCoins.begin(), vCoins.end(), GetRandInt);
-
-    // move denoms down on the list
-    sort(vCoins.begin(), vCoins.end(), less_then_denom);
-
     // try to find nondenom first to prevent unneeded spending of mixed coins
     for (unsigned int tryDenom = 0; tryDenom < 2; tryDenom++)
     {
         LogPrint("selectcoins", "tryDenom: %d\n", tryDenom);
         vValue.clear();
         nTotalLower = 0;
-        BOOST_FOREACH(const COutput &output, vCoins)
+        BOOST_FOREACH(const CInputCoin &input, vCandidates)
         {
-            if (!output.fSpendable)
-                continue;
-
-            const CWalletTx *pcoin = output.tx;
-
-//            if (fDebug) LogPrint("selectcoins", "value %s confirms %d\n", FormatMoney(pcoin->vout[output.i].nValue), output.nDepth);
-            if (output.nDepth < (pcoin->IsFromMe(ISMINE_ALL) ? nConfMine : nConfTheirs))
+            if (input.nDepth < (input.fFromMe ? nConfMine : nConfTheirs))
                 continue;
 
-            int i = output.i;
-            CAmount n = pcoin->vout[i].nValue;
-            if (tryDenom == 0 && CPrivateSend::IsDenominatedAmount(n)) continue; // we don't want denom values on first run
+            CAmount n = input.nValue;
+            if (tryDenom == 0 && input.fDenominated) continue; // we don't want denom values on first run
 
-            pair<CAmount,pair<const CWalletTx*,unsigned int> > coin = make_pair(n,make_pair(pcoin, i));
+            pair<CAmount,pair<const CWalletTx*,unsigned int> > coin = make_pair(n, input.coin);
 
             if (n == nTargetValue)
             {
@@ -2575,11 +3054,29 @@ bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int
 
     }
 
-    // Solve subset sum by stochastic approximation
-    sort(vValue.rbegin(), vValue.rend(), CompareValueOnly());
+    // vValue keeps the descending order of the candidates
     vector<char> vfBest;
     CAmount nBest;
 
+    // Prefer a selection that needs no change output at all; any excess below
+    // the dust threshold of the change output is left to the fee
+    CAmount nCostOfChange = CTxOut(0, GetScriptForDestination(CKeyID())).GetDustThreshold(::minRelayTxFee) - 1;
+    if (SelectCoinsBnB(vValue, nTargetValue, nCostOfChange, vfBest, nBest) &&
+        (!fUseInstantSend || nBest <= sporkManager.GetSporkValue(SPORK_5_INSTANTSEND_MAX_VALUE)*COIN))
+    {
+        for (unsigned int i = 0; i < vValue.size(); i++)
+        {
+            if (vfBest[i])
+            {
+                setCoinsRet.insert(vValue[i].second);
+                nValueRet += vValue[i].first;
+            }
+        }
+        LogPrint("selectcoins", "CWallet::SelectCoinsMinConf branch and bound: %d inputs - total %s\n", setCoinsRet.size(), FormatMoney(nBest));
+        return true;
+    }
+
+    // Solve subset sum by stochastic approximation
     ApproximateBestSubset(vValue, nTotalLower, nTargetValue, vfBest, nBest, fUseInstantSend);
     if (nBest != nTargetValue && nTotalLower >= nTargetValue + MIN_CHANGE)
         ApproximateBestSubset(vValue, nTotalLower, nTargetValue + MIN_CHANGE, vfBest, nBest, fUseInstantSend);
@@ -2690,10 +3187,15 @@ bool CWallet::SelectCoins(const CAmount& nTargetValue, set<pair<const CWalletTx*
             ++it;
     }
 
+    // sort the candidates once for all confirmation levels tried below
+    vector<CInputCoin> vCandidates;
+    if (nTargetValue > nValueFromPresetInputs)
+        BuildCoinCandidates(vCoins, vCandidates);
+
     bool res = nTargetValue <= nValueFromPresetInputs ||
-        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 6, vCoins, setCoinsRet, nValueRet, fUseInstantSend) ||
-        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 1, vCoins, setCoinsRet, nValueRet, fUseInstantSend) ||
-        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, vCoins, setCoinsRet, nValueRet, fUseInstantSend));
+        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 6, vCandidates, setCoinsRet, nValueRet, fUseInstantSend) ||
+        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 1, vCandidates, setCoinsRet, nValueRet, fUseInstantSend) ||
+        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, vCandidates, setCoinsRet, nValueRet, fUseInstantSend));
 
     // because SelectCoinsMinConf clears the setCoinsRet, we now add the possible inputs to the coinset
     setCoinsRet.insert(setPresetCoins.begin(), setPresetCoins.end());
@@ -3614,13 +4116,7 @@ DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
 
     {
         LOCK2(cs_main, cs_wallet);
-        for (auto& pair : mapWallet) {
-            for(int i = 0; i < pair.second.vout.size(); ++i) {
-                if (IsMine(pair.second.vout[i]) && !IsSpent(pair.first, i)) {
-                    setWalletUTXO.insert(COutPoint(pair.first, i));
-                }
-            }
-        }
+        RebuildWalletUTXO();
     }
 
     if (nLoadWalletRet != DB_LOAD_OK)
@@ -4151,6 +4647,8 @@ bool CWallet::UpdatedTransaction(const uint256 &hashTx)
         // Only notify UI if this transaction is in this wallet
         map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(hashTx);
         if (mi != mapWallet.end()){
+            // e.g. an InstantSend lock changes the depth balances see
+            mapBalanceCache.clear();
             NotifyTransactionChanged(this, hashTx, CT_UPDATED);
             return true;
         }
@@ -4178,6 +4676,7 @@ void CWallet::LockCoin(COutPoint& output)
 
     fAnonymizableTallyCached = false;
     fAnonymizableTallyCachedNonDenom = false;
+    mapBalanceCache.clear();
 }
 
 void CWallet::UnlockCoin(COutPoint& output)
@@ -4189,6 +4688,7 @@ void CWallet::UnlockCoin(COutPoint& output)
 
     fAnonymizableTallyCached = false;
     fAnonymizableTallyCachedNonDenom = false;
+    mapBalanceCache.clear();
 }
 
 void CWallet::UnlockAllCoins()
@@ -4372,7 +4872,7 @@ int CMerkleTx::SetMerkleBranch(const CBlock& block)
 
     // Locate the transaction
     for (nIndex = 0; nIndex < (int)block.vtx.size(); nIndex++)
-        if (block.vtx[nIndex] == *(CTransaction*)this)
+        if (*block.vtx[nIndex] == *(CTransaction*)this)
             break;
     if (nIndex == (int)block.vtx.size())
     {
@@ -22,6 +22,7 @@
 #include "privatesend.h"
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -490,6 +491,15 @@ public:
     std::string ToString() const;
 };
 
+/** Spendable output in the value-sorted candidate index used by coin selection */
+struct CInputCoin
+{
+    CAmount nValue;
+    std::pair<const CWalletTx*, unsigned int> coin;
+    int nDepth;
+    bool fFromMe;
+    bool fDenominated;
+};
 
 
 
@@ -643,6 +653,32 @@ private:
     void AddToSpends(const uint256& wtxid);
 
     std::set<COutPoint> setWalletUTXO;
+    /** setWalletUTXO bucketed by the AvailableCoinsType each output's value falls into */
+    std::map<AvailableCoinsType, std::set<COutPoint> > mapWalletUTXOByType;
+    /** Add or remove outpoint from setWalletUTXO according to its current spent and IsMine state */
+    void UpdateWalletUTXO(const COutPoint& outpoint);
+    void RebuildWalletUTXO();
+    const std::set<COutPoint>& GetWalletUTXOByType(AvailableCoinsType nCoinType) const;
+    /** Wallet transactions having at least one output in setUTXO */
+    void GetWalletUTXOTxes(const std::set<COutPoint>& setUTXO, std::vector<const CWalletTx*>& vWtxRet) const;
+
+    enum BalanceType
+    {
+        BALANCE_TRUSTED,
+        BALANCE_UNCONFIRMED,
+        BALANCE_IMMATURE,
+        BALANCE_WATCHONLY_TRUSTED,
+        BALANCE_WATCHONLY_UNCONFIRMED,
+        BALANCE_WATCHONLY_IMMATURE,
+        BALANCE_DENOMINATED_CONFIRMED,
+        BALANCE_DENOMINATED_UNCONFIRMED
+    };
+    /** Balance totals, valid while the chain tip, the mempool and the wallet are unchanged */
+    mutable std::map<BalanceType, CAmount> mapBalanceCache;
+    mutable uint256 hashBalanceCacheTip;
+    mutable unsigned int nBalanceCacheMempoolUpdated;
+    bool GetCachedBalance(BalanceType nType, CAmount& nBalanceRet) const;
+    void SetCachedBalance(BalanceType nType, CAmount nBalance) const;
 
     /* Mark a transaction (and its in-wallet descendants) as conflicting with a particular block. */
     void MarkConflicted(const uint256& hashBlock, const uint256& hashTx);
@@ -652,6 +688,14 @@ private:
     /* HD derive new child key (on internal or external chain) */
     void DeriveNewChildKey(const CKeyMetadata& metadata, CKey& secretRet, uint32_t nAccountIndex, bool fInternal /*= false*/);
 
+    std::atomic<bool> fAbortRescan;
+    std::atomic<bool> fScanningWallet;
+    std::atomic<int64_t> nScanningStartTime;
+    std::atomic<double> dScanningProgress;
+
+    /* Whether tx is already in the wallet or spends (or conflicts with) something the wallet knows about */
+    bool IsTxKnownOrSpendsFromMe(const CTransaction& tx) const;
+
 public:
     /*
      * Main wallet lock.
@@ -724,6 +768,13 @@ public:
         fAnonymizableTallyCachedNonDenom = false;
         vecAnonymizableTallyCached.clear();
         vecAnonymizableTallyCachedNonDenom.clear();
+        mapBalanceCache.clear();
+        hashBalanceCacheTip.SetNull();
+        nBalanceCacheMempoolUpdated = 0;
+        fAbortRescan = false;
+        fScanningWallet = false;
+        nScanningStartTime = 0;
+        dScanningProgress = 0.0;
     }
 
     std::map<uint256, CWalletTx> mapWallet;
@@ -759,11 +810,16 @@ public:
 
     /**
      * Shuffle and select coins until nTargetValue is reached while avoiding
-     * small change; This method is stochastic for some inputs and upon
-     * completion the coin set and corresponding actual target value is
-     * assembled
+     * small change; A selection that needs no change output at all is searched
+     * for first by a bounded branch and bound, otherwise this method is
+     * stochastic for some inputs and upon completion the coin set and
+     * corresponding actual target value is assembled
      */
-    bool SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, std::vector<COutput> vCoins, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, bool fUseInstantSend = false) const;
+    bool SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, const std::vector<COutput>& vCoins, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, bool fUseInstantSend = false) const;
+    /** Same as above on a candidate index built by BuildCoinCandidates(), which can be reused across calls */
+    bool SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, const std::vector<CInputCoin>& vCandidates, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, bool fUseInstantSend = false) const;
+    /** Spendable outputs of vCoins in random order, then stably sorted by descending value */
+    static void BuildCoinCandidates(const std::vector<COutput>& vCoins, std::vector<CInputCoin>& vCandidatesRet);
 
     // Coin selection
     bool SelectCoinsByDenominations(int nDenom, CAmount nValueMin, CAmount nValueMax, std::vector<CTxDSIn>& vecTxDSInRet, std::vector<COutput>& vCoinsRet, CAmount& nValueRet, int nPrivateSendRoundsMin, int nPrivateSendRoundsMax);
@@ -857,7 +913,15 @@ public:
     bool AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet, CWalletDB* pwalletdb);
     void SyncTransaction(const CTransaction& tx, const CBlock* pblock);
     bool AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlock* pblock, bool fUpdate);
-    int ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate = false);
+    int ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate = false, const CBlockIndex** ppindexScanned = NULL);
+    /** Ask a running ScanForWalletTransactions to stop after the block it is processing */
+    void AbortRescan() { fAbortRescan = true; }
+    bool IsAbortingRescan() const { return fAbortRescan; }
+    bool IsScanning() const { return fScanningWallet; }
+    /** Milliseconds since the running rescan started, 0 if there is none */
+    int64_t ScanningDuration() const { return fScanningWallet ? GetTimeMillis() - nScanningStartTime : 0; }
+    /** Progress of the running rescan between 0 and 1, 0 if there is none */
+    double ScanningProgress() const { return fScanningWallet ? (double)dScanningProgress : 0.0; }
     void ReacceptWalletTransactions();
     void ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman);
     std::vector<uint256> ResendWalletTransactionsBefore(int64_t nTime, CConnman* connman);